@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "pixel_kernels.h"
+
+using namespace GameBoyEmulator;
+
+constexpr size_t SCANLINE_PIXELS = 160;
+constexpr size_t FRAME_PIXELS = SCANLINE_PIXELS * 144;
+constexpr size_t NUMBER_OF_TILE_ROWS = 384 * 8;
+constexpr int BENCHMARK_ITERATIONS = 2000;
+
+constexpr std::array<PixelKernelInstructionSet, 3> INSTRUCTION_SETS =
+{
+    PixelKernelInstructionSet::Scalar,
+    PixelKernelInstructionSet::SSE2,
+    PixelKernelInstructionSet::AVX2
+};
+
+struct RandomScanlines
+{
+    std::vector<uint8_t> background_colour_indices;
+    std::vector<uint8_t> object_colour_indices;
+    std::vector<uint8_t> object_flags;
+    std::vector<uint8_t> tile_rows;
+    std::vector<uint8_t> shades;
+
+    explicit RandomScanlines(std::mt19937& random_number_generator)
+        : background_colour_indices(FRAME_PIXELS),
+          object_colour_indices(FRAME_PIXELS),
+          object_flags(FRAME_PIXELS),
+          tile_rows(2 * NUMBER_OF_TILE_ROWS),
+          shades(FRAME_PIXELS)
+    {
+        for (size_t i = 0; i < FRAME_PIXELS; i++)
+        {
+            background_colour_indices[i] = random_number_generator() % 4;
+            object_colour_indices[i] = (random_number_generator() % 3 == 0) ? random_number_generator() % 4 : 0;
+            object_flags[i] = random_number_generator() & 0b10010000;
+            shades[i] = random_number_generator() % 4;
+        }
+        for (uint8_t& tile_row_byte : tile_rows)
+        {
+            tile_row_byte = static_cast<uint8_t>(random_number_generator());
+        }
+    }
+
+    ScanlineLayers get_scanline_layers(size_t scanline, uint8_t lcd_control_bits) const
+    {
+        return ScanlineLayers
+        {
+            &background_colour_indices[scanline * SCANLINE_PIXELS],
+            &object_colour_indices[scanline * SCANLINE_PIXELS],
+            &object_flags[scanline * SCANLINE_PIXELS],
+            0xE4,
+            0xD2,
+            0x1B,
+            (lcd_control_bits & 0b001) != 0,
+            (lcd_control_bits & 0b010) != 0,
+            (lcd_control_bits & 0b100) != 0
+        };
+    }
+};
+
+template <typename Function>
+double get_nanoseconds_per_pixel(size_t pixels_per_iteration, Function function)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        function();
+    }
+    const std::chrono::duration<double, std::nano> elapsed_time = std::chrono::steady_clock::now() - start_time;
+    return elapsed_time.count() / static_cast<double>(pixels_per_iteration * BENCHMARK_ITERATIONS);
+}
+
+bool do_kernels_match_scalar(const PixelKernels& pixel_kernels, const RandomScanlines& random_scanlines)
+{
+    const PixelKernels& scalar_pixel_kernels = get_pixel_kernels(PixelKernelInstructionSet::Scalar);
+
+    for (size_t i = 0; i < NUMBER_OF_TILE_ROWS; i++)
+    {
+        uint8_t expected[16];
+        uint8_t actual[16];
+        scalar_pixel_kernels.decode_tile_row(random_scanlines.tile_rows[2 * i], random_scanlines.tile_rows[2 * i + 1], expected);
+        pixel_kernels.decode_tile_row(random_scanlines.tile_rows[2 * i], random_scanlines.tile_rows[2 * i + 1], actual);
+        if (std::memcmp(expected, actual, sizeof(expected)) != 0)
+            return false;
+    }
+
+    // Odd lengths also cover the scalar tail after the last full vector
+    for (uint8_t lcd_control_bits = 0; lcd_control_bits < 8; lcd_control_bits++)
+    {
+        for (size_t pixel_count : {SCANLINE_PIXELS, SCANLINE_PIXELS - 3})
+        {
+            std::array<uint8_t, SCANLINE_PIXELS> expected{};
+            std::array<uint8_t, SCANLINE_PIXELS> actual{};
+            scalar_pixel_kernels.compose_scanline(random_scanlines.get_scanline_layers(lcd_control_bits, lcd_control_bits), expected.data(), pixel_count);
+            pixel_kernels.compose_scanline(random_scanlines.get_scanline_layers(lcd_control_bits, lcd_control_bits), actual.data(), pixel_count);
+            if (expected != actual)
+                return false;
+        }
+    }
+
+    constexpr uint32_t abgr_colour_palette[4] = {0xFFE0F8D0, 0xFF88C070, 0xFF346856, 0xFF081820};
+    std::vector<uint32_t> expected(FRAME_PIXELS);
+    std::vector<uint32_t> actual(FRAME_PIXELS);
+    scalar_pixel_kernels.convert_shades_to_abgr(random_scanlines.shades.data(), abgr_colour_palette, expected.data(), FRAME_PIXELS - 5);
+    pixel_kernels.convert_shades_to_abgr(random_scanlines.shades.data(), abgr_colour_palette, actual.data(), FRAME_PIXELS - 5);
+    return expected == actual;
+}
+
+const char* get_instruction_set_name(PixelKernelInstructionSet instruction_set)
+{
+    switch (instruction_set)
+    {
+        case PixelKernelInstructionSet::SSE2:
+            return "SSE2";
+        case PixelKernelInstructionSet::AVX2:
+            return "AVX2";
+        default:
+            return "Scalar";
+    }
+}
+
+int main()
+{
+    std::mt19937 random_number_generator{0x6B8B4567};
+    const RandomScanlines random_scanlines{random_number_generator};
+    std::vector<uint8_t> decoded_tile_rows(16 * NUMBER_OF_TILE_ROWS);
+    std::vector<uint8_t> composed_shades(FRAME_PIXELS);
+    std::vector<uint32_t> abgr_pixels(FRAME_PIXELS);
+    constexpr uint32_t abgr_colour_palette[4] = {0xFFFFFFFF, 0xFFAAAAAA, 0xFF555555, 0xFF000000};
+
+    std::cout << "Selected kernels: " << get_instruction_set_name(get_pixel_kernels().instruction_set) << "\n";
+    std::cout << "Nanoseconds per pixel (speedup over scalar)\n";
+
+    double scalar_nanoseconds_per_pixel[3]{};
+    for (PixelKernelInstructionSet instruction_set : INSTRUCTION_SETS)
+    {
+        if (!is_pixel_kernel_instruction_set_supported(instruction_set))
+        {
+            std::cout << get_instruction_set_name(instruction_set) << ": not supported\n";
+            continue;
+        }
+
+        const PixelKernels& pixel_kernels = get_pixel_kernels(instruction_set);
+        if (!do_kernels_match_scalar(pixel_kernels, random_scanlines))
+        {
+            std::cout << get_instruction_set_name(instruction_set) << ": results differ from the scalar kernels\n";
+            return 1;
+        }
+
+        const double nanoseconds_per_pixel[3] =
+        {
+            get_nanoseconds_per_pixel(8 * NUMBER_OF_TILE_ROWS, [&]
+            {
+                for (size_t i = 0; i < NUMBER_OF_TILE_ROWS; i++)
+                {
+                    pixel_kernels.decode_tile_row(random_scanlines.tile_rows[2 * i], random_scanlines.tile_rows[2 * i + 1], &decoded_tile_rows[16 * i]);
+                }
+            }),
+            get_nanoseconds_per_pixel(FRAME_PIXELS, [&]
+            {
+                for (size_t scanline = 0; scanline < FRAME_PIXELS / SCANLINE_PIXELS; scanline++)
+                {
+                    pixel_kernels.compose_scanline(random_scanlines.get_scanline_layers(scanline, 0b111), &composed_shades[scanline * SCANLINE_PIXELS], SCANLINE_PIXELS);
+                }
+            }),
+            get_nanoseconds_per_pixel(FRAME_PIXELS, [&]
+            {
+                pixel_kernels.convert_shades_to_abgr(random_scanlines.shades.data(), abgr_colour_palette, abgr_pixels.data(), FRAME_PIXELS);
+            })
+        };
+
+        if (instruction_set == PixelKernelInstructionSet::Scalar)
+            std::copy_n(nanoseconds_per_pixel, 3, scalar_nanoseconds_per_pixel);
+
+        std::cout << get_instruction_set_name(instruction_set) << ":";
+        const char* kernel_names[3] = {"decode tile row", "compose scanline", "convert to ABGR"};
+        for (int i = 0; i < 3; i++)
+        {
+            std::cout << "  " << kernel_names[i] << " " << nanoseconds_per_pixel[i]
+                      << " (" << scalar_nanoseconds_per_pixel[i] / nanoseconds_per_pixel[i] << "x)";
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
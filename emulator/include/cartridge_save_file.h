@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+
+#include "memory_mapped_file.h"
+
+namespace GameBoyEmulator
+{
+
+constexpr std::chrono::milliseconds CARTRIDGE_SAVE_FILE_FLUSH_INTERVAL{1000};
+
+// Battery-backed cartridge RAM mapped from a .sav file, followed by the real time clock trailer for MBC3 cartridges with a timer.
+// The emulation thread only sets bits in the dirty mask, one per 8 KiB RAM bank plus one for the trailer, and a background
+// thread flushes the marked regions so saving never waits on the disk
+class CartridgeSaveFile
+{
+public:
+    static std::unique_ptr<CartridgeSaveFile> try_open(
+        const std::filesystem::path& save_file_path,
+        uint32_t ram_size,
+        uint8_t initial_ram_value,
+        bool has_real_time_clock,
+        std::string& error_message);
+
+    CartridgeSaveFile(const CartridgeSaveFile&) = delete;
+    CartridgeSaveFile& operator=(const CartridgeSaveFile&) = delete;
+    ~CartridgeSaveFile();
+
+    std::span<uint8_t> get_ram()
+    {
+        return {memory_mapped_file->data(), ram_size};
+    }
+
+    std::span<uint8_t> get_real_time_clock_save_data()
+    {
+        return {memory_mapped_file->data() + ram_size, memory_mapped_file->size() - ram_size};
+    }
+
+    std::atomic<uint32_t>& get_dirty_save_data_mask()
+    {
+        return dirty_save_data_mask;
+    }
+
+private:
+    CartridgeSaveFile(const std::filesystem::path& save_file_path, std::unique_ptr<MemoryMappedFile> mapped_file, uint32_t ram_size);
+
+    std::string save_file_path_key;
+    std::unique_ptr<MemoryMappedFile> memory_mapped_file;
+    uint32_t ram_size;
+    std::atomic<uint32_t> dirty_save_data_mask{};
+    std::mutex flush_mutex;
+    std::condition_variable_any flush_condition;
+    std::jthread flush_thread;
+
+    void flush_dirty_save_data();
+};
+
+} // namespace GameBoyEmulator
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
 #include <bit>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
+#include <optional>
+#include <utility>
 
+#include "emulation_stop_conditions.h"
 #include "memory_management_unit.h"
 #include "register_file.h"
 
@@ -11,6 +15,14 @@ namespace GameBoyEmulator
 {
 
 constexpr uint8_t INSTRUCTION_PREFIX_BYTE = 0xCB;
+constexpr uint16_t NUMBER_OF_OPCODES = 0x100;
+constexpr uint8_t MEMORY_HL_OPERAND_INDEX = 0b110;
+
+constexpr uint32_t MAX_HALTED_MACHINE_CYCLES_PER_STEP = SCANLINE_DURATION_DOTS / DOTS_PER_MACHINE_CYCLE;
+constexpr uint32_t MAX_IDLE_LOOP_MACHINE_CYCLES_PER_STEP = SCANLINE_DURATION_DOTS / DOTS_PER_MACHINE_CYCLE;
+constexpr uint8_t MAX_IDLE_LOOP_ARITHMETIC_LOGIC_OPERATIONS = 2;
+constexpr uint8_t LOAD_A_FROM_INPUT_OUTPUT_REGISTER_OPCODE = 0xF0;
+constexpr uint32_t MAX_TRANSLATED_BLOCK_MACHINE_CYCLES_PER_STEP = SCANLINE_DURATION_DOTS / DOTS_PER_MACHINE_CYCLE;
 
 constexpr uint16_t CARTRIDGE_HEADER_START = 0x0134;
 constexpr uint16_t CARTRIDGE_HEADER_END = 0x014C;
@@ -22,12 +34,29 @@ enum class InterruptMasterEnableState
     Enabled
 };
 
+enum class DeferredFlagsOperation
+{
+    None,
+    Add,
+    Subtract,
+    And,
+    ExclusiveOrInclusiveOr
+};
+
+struct DeferredFlags
+{
+    DeferredFlagsOperation operation{DeferredFlagsOperation::None};
+    uint8_t first_operand{};
+    uint8_t second_operand{};
+    uint8_t carry_in{};
+    uint8_t result{};
+};
+
+template <typename SystemBus>
 class CentralProcessingUnit
 {
 public:
-    CentralProcessingUnit(
-        std::function<void()> emulator_step_single_machine_cycle,
-        MemoryManagementUnit& memory_management_unit_reference);
+    CentralProcessingUnit(SystemBus system_bus_instance);
 
     void reset_state(bool should_add_startup_machine_cycle);
     void set_post_boot_state();
@@ -36,27 +65,90 @@ public:
     void set_register_file_state(const RegisterFile<std::endian::native>& new_register_values);
 
     void step_single_instruction();
+    void step_instructions(uint32_t instruction_count);
+    EmulationStopResult step_instructions_until_stopped(const EmulationStopConditions& stop_conditions);
+    uint64_t get_elapsed_machine_cycles() const;
+
+    void set_halt_fast_forward_enabled(bool is_enabled);
+    uint64_t get_fast_forwarded_halted_machine_cycles() const;
+    void set_idle_loop_skip_enabled(bool is_enabled);
+    uint64_t get_skipped_idle_loop_machine_cycles() const;
+    void set_dynamic_recompilation_enabled(bool is_enabled);
+    uint64_t get_translated_block_machine_cycles() const;
 
 private:
-    std::function<void()> emulator_step_single_machine_cycle_callback;
-    MemoryManagementUnit& memory_management_unit;
+    using InstructionHandler = void (CentralProcessingUnit::*)();
+
+    SystemBus system_bus;
     RegisterFile<std::endian::native> register_file;
     InterruptMasterEnableState interrupt_master_enable_ime{InterruptMasterEnableState::Disabled};
     uint8_t instruction_register_ir{};
     bool is_current_instruction_prefixed{};
     bool is_halted{};
+    DeferredFlags deferred_flags{};
+    bool is_halt_fast_forward_enabled{true};
+    uint64_t fast_forwarded_halted_machine_cycles{};
+    bool is_idle_loop_skip_enabled{true};
+    uint64_t skipped_idle_loop_machine_cycles{};
+    bool is_dynamic_recompilation_enabled{true};
+    uint64_t translated_block_machine_cycles{};
+    uint64_t machine_cycle_limit{UINT64_MAX};
+    bool are_instruction_boundaries_observed{};
+
+    static const std::array<InstructionHandler, 2 * NUMBER_OF_OPCODES> INSTRUCTION_HANDLERS;
 
     void fetch_next_instruction();
+    void step_halted_machine_cycles();
+    bool try_skip_idle_loop();
+    uint32_t skip_idle_loop_iterations_while_polled_register_is_unchanged(
+        uint16_t polled_address,
+        const std::array<uint8_t, MAX_IDLE_LOOP_ARITHMETIC_LOGIC_OPERATIONS>& arithmetic_logic_opcodes,
+        const std::array<uint8_t, MAX_IDLE_LOOP_ARITHMETIC_LOGIC_OPERATIONS>& arithmetic_logic_operands,
+        uint8_t arithmetic_logic_operation_count,
+        uint8_t jump_opcode,
+        uint32_t max_machine_cycles);
+    bool try_execute_translated_block();
+    void execute_idle_loop_arithmetic_logic_operation(uint8_t opcode, uint8_t value);
+    bool is_jump_condition_met(uint8_t opcode);
+    bool is_interrupt_serviceable() const;
+    uint64_t get_machine_cycles_until_limit() const;
+    std::optional<EmulationStopResult> get_stop_result(
+        const EmulationStopConditions& stop_conditions,
+        uint64_t machine_cycle_limit,
+        uint64_t initial_published_frame_count) const;
     void service_interrupt();
+    void service_interrupt_and_update_interrupt_master_enable();
 
-    virtual uint8_t read_byte_and_step_emulator_components(uint16_t address);
-    virtual void write_byte_and_step_emulator_components(uint16_t address, uint8_t value);
+    void defer_flags(DeferredFlagsOperation operation, uint8_t first_operand, uint8_t second_operand, uint8_t carry_in, uint8_t result);
+    void materialize_flags();
+    uint8_t get_materialized_flags() const;
+
+    uint8_t read_byte_and_step_emulator_components(uint16_t address);
+    void write_byte_and_step_emulator_components(uint16_t address, uint8_t value);
     uint8_t fetch_immediate8_and_step_emulator_components();
     uint16_t fetch_immediate16_and_step_emulator_components();
 
-    uint8_t& get_register_by_index(uint8_t index);
-    void decode_current_unprefixed_opcode_and_execute();
-    void decode_current_prefixed_opcode_and_execute();
+    template <size_t... opcodes>
+    static constexpr std::array<InstructionHandler, 2 * NUMBER_OF_OPCODES> create_instruction_handler_table(std::index_sequence<opcodes...>);
+    template <uint8_t opcode>
+    void execute_unprefixed_opcode();
+    template <uint8_t opcode>
+    void execute_prefixed_opcode();
+    template <uint8_t opcode>
+    void execute_prefixed_operation(uint8_t& register8);
+
+    template <uint8_t register_index>
+    uint8_t& get_register_by_index();
+    template <uint8_t register_pair_index>
+    uint16_t& get_register_pair_by_index();
+    template <uint8_t operand_index>
+    uint8_t read_operand_and_step_emulator_components();
+    template <uint8_t operand_index>
+    void write_operand_and_step_emulator_components(uint8_t value);
+    template <uint8_t condition_index>
+    bool is_condition_met() const;
+    template <uint8_t operation_index>
+    void execute_arithmetic_logic_operation_a(uint8_t value);
 
     // Generic Instructions
     template <typename T>
@@ -95,10 +187,6 @@ private:
     void reset_bit(uint8_t bit_position_to_reset, uint8_t& register8);
     void set_bit(uint8_t bit_position_to_set, uint8_t& register8);
 
-    void operate_on_register_hl(void (CentralProcessingUnit::* operation)(uint8_t, uint8_t&), uint8_t bit_position);
-    void operate_on_register_hl_and_write(void (CentralProcessingUnit::* operation)(uint8_t, uint8_t&), uint8_t bit_position);
-    void operate_on_register_hl_and_write(void (CentralProcessingUnit::* operation)(uint8_t&));
-
     // Miscellaneous Instructions
     void unused_opcode() const;
     void rotate_left_circular_a_0x07();
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "memory_bank_controllers.h"
+#include "register_file.h"
+
+namespace GameBoyEmulator
+{
+
+constexpr uint8_t MAX_TRANSLATED_BLOCK_SIZE = 64;
+constexpr size_t TRANSLATED_CODE_BUFFER_SIZE = 8 * 1024 * 1024;
+constexpr uint8_t NUMBER_OF_ROM_BANK_WINDOWS = 2;
+
+constexpr uint32_t UNTRANSLATED_BLOCK_INDEX = 0;
+constexpr uint32_t UNTRANSLATABLE_BLOCK_INDEX = 0xFFFFFFFF;
+
+// Returns the machine cycles of the guest instructions it executed counting the opcode fetch of the first one, or 0 when it left before executing any.
+// The program counter is left at the next instruction to fetch. Loops back to the block start continue while the next iteration still fits the budget
+using TranslatedBlockFunction = uint32_t (*)(
+    RegisterFile<std::endian::native>* register_file,
+    const uint8_t* const* read_memory_pages,
+    uint8_t* const* write_memory_pages,
+    uint32_t machine_cycle_budget);
+
+struct TranslatedBlock
+{
+    TranslatedBlockFunction function{};
+    uint32_t max_machine_cycles{};
+};
+
+// Translates runs of ROM instructions that only touch registers and plain memory pages into x86-64 code.
+// Memory is accessed through the page tables of the memory management unit, and an access to a page that goes through the handlers
+// leaves the block before that instruction so the interpreter performs it. Translations are kept per ROM bank and bank window
+class DynamicRecompiler
+{
+public:
+    DynamicRecompiler() = default;
+    DynamicRecompiler(const DynamicRecompiler&) = delete;
+    DynamicRecompiler& operator=(const DynamicRecompiler&) = delete;
+    ~DynamicRecompiler();
+
+    static bool is_supported();
+
+    // Returns nullptr when the instruction at the address can not be translated
+    const TranslatedBlock* get_translated_block(uint16_t address, const uint8_t* const* read_memory_pages)
+    {
+        const uint32_t* translated_block_indices = mapped_translated_block_indices[address >> ROM_BANK_SIZE_POWER_OF_TWO];
+        if (translated_block_indices != nullptr)
+        {
+            const uint32_t translated_block_index = translated_block_indices[address & (ROM_BANK_SIZE - 1)];
+            if (translated_block_index == UNTRANSLATABLE_BLOCK_INDEX)
+                return nullptr;
+            if (translated_block_index != UNTRANSLATED_BLOCK_INDEX)
+                return &translated_blocks[translated_block_index - 1];
+        }
+        return find_or_translate_block(address, read_memory_pages);
+    }
+
+    void map_rom_banks(uint16_t rom_bank_x0_number, uint16_t rom_bank_0x_number);
+    void clear();
+
+private:
+    uint8_t* translated_code{};
+    size_t translated_code_size{};
+    bool has_executable_memory_allocation_failed{};
+    std::vector<TranslatedBlock> translated_blocks{};
+    std::unordered_map<uint32_t, std::unique_ptr<uint32_t[]>> translated_block_indices_by_rom_bank{};
+    std::array<uint16_t, NUMBER_OF_ROM_BANK_WINDOWS> mapped_rom_bank_numbers{};
+    std::array<uint32_t*, NUMBER_OF_ROM_BANK_WINDOWS> mapped_translated_block_indices{};
+
+    const TranslatedBlock* find_or_translate_block(uint16_t address, const uint8_t* const* read_memory_pages);
+    uint32_t* get_translated_block_indices(uint8_t rom_bank_window);
+};
+
+} // namespace GameBoyEmulator
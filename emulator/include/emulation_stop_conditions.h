@@ -0,0 +1,57 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "register_file.h"
+
+namespace GameBoyEmulator
+{
+
+enum class EmulationStopReason
+{
+    MachineCycleBudgetExhausted,
+    FramePublished,
+    WatchedAddressWritten,
+    BreakpointOpcodeReached,
+    RegisterPatternMatched
+};
+
+// Only the bits set in the mask of each register are compared against the expected register values
+struct RegisterPattern
+{
+    RegisterFile<std::endian::native> expected_register_values{};
+    RegisterFile<std::endian::native> compared_bits_masks{};
+
+    bool does_match(const RegisterFile<std::endian::native>& register_values) const
+    {
+        return ((register_values.AF ^ expected_register_values.AF) & compared_bits_masks.AF) == 0 &&
+               ((register_values.BC ^ expected_register_values.BC) & compared_bits_masks.BC) == 0 &&
+               ((register_values.DE ^ expected_register_values.DE) & compared_bits_masks.DE) == 0 &&
+               ((register_values.HL ^ expected_register_values.HL) & compared_bits_masks.HL) == 0 &&
+               ((register_values.stack_pointer ^ expected_register_values.stack_pointer) & compared_bits_masks.stack_pointer) == 0 &&
+               ((register_values.program_counter ^ expected_register_values.program_counter) & compared_bits_masks.program_counter) == 0;
+    }
+};
+
+// Execution stops at the first instruction boundary at or after the end of the machine cycle budget, so it can be overshot
+// by the machine cycles of the last instruction, or of the interrupt dispatch that follows it
+struct EmulationStopConditions
+{
+    uint64_t machine_cycle_budget{};
+    bool should_stop_at_published_frame{};
+    std::optional<uint16_t> watched_write_address{};
+    std::optional<uint8_t> breakpoint_opcode{};
+    std::vector<RegisterPattern> register_patterns{};
+};
+
+struct EmulationStopResult
+{
+    EmulationStopReason reason{EmulationStopReason::MachineCycleBudgetExhausted};
+    size_t matched_register_pattern_index{};
+};
+
+} // namespace GameBoyEmulator
@@ -7,9 +7,13 @@
 #include <string>
 
 #include "central_processing_unit.h"
+#include "emulation_stop_conditions.h"
+#include "event_scheduler.h"
 #include "game_cartridge_slot.h"
+#include "interrupt_registers.h"
 #include "internal_timer.h"
 #include "memory_management_unit.h"
+#include "system_bus.h"
 
 namespace GameBoyEmulator
 {
@@ -17,6 +21,13 @@ namespace GameBoyEmulator
 static constexpr uint16_t ROM_TITLE_START = 0x0134;
 static constexpr uint16_t ROM_TITLE_END = 0x0143;
 
+struct EmulationStatistics
+{
+    uint64_t fast_forwarded_halted_machine_cycles{};
+    uint64_t skipped_idle_loop_machine_cycles{};
+    uint64_t translated_block_machine_cycles{};
+};
+
 class Emulator
 {
 public:
@@ -25,7 +36,20 @@ public:
     void reset_state();
 
     void step_central_processing_unit_single_instruction();
+    void step_central_processing_unit_instructions(uint32_t instruction_count);
+    EmulationStopResult run_for_cycles(uint64_t machine_cycle_count);
+    EmulationStopResult run_until_frame(uint64_t max_machine_cycle_count);
+    EmulationStopResult run_until_event(const EmulationStopConditions& stop_conditions);
+    uint64_t get_elapsed_machine_cycles() const;
     RegisterFile<std::endian::native> get_register_file() const;
+    void set_halt_fast_forward_enabled(bool is_enabled);
+    void set_idle_loop_skip_enabled(bool is_enabled);
+    void set_dynamic_recompilation_enabled(bool is_enabled);
+    void set_frame_skip_interval(uint8_t frame_skip_interval);
+    void set_scanline_render_ahead_enabled(bool is_enabled);
+    void set_battery_backed_save_files_enabled(bool is_enabled);
+    void set_real_time_clock_time_source(RealTimeClockTimeSource time_source);
+    EmulationStatistics get_emulation_statistics() const;
     void print_register_file_state() const;
 
     bool try_load_file_to_memory(std::filesystem::path file_path, FileType file_type, std::string& error_message);
@@ -35,9 +59,9 @@ public:
     bool is_boot_rom_loaded_in_memory_thread_safe() const;
     bool is_boot_rom_mapped_in_memory() const;
 
-    uint8_t read_byte_from_memory(uint16_t address) const;
+    uint8_t read_byte_from_memory(uint16_t address);
     void write_byte_to_memory(uint16_t address, uint8_t value);
-    void print_bytes_in_memory_range(uint16_t start_address, uint16_t end_address) const;
+    void print_bytes_in_memory_range(uint16_t start_address, uint16_t end_address);
 
     void update_button_pressed_state_thread_safe(uint8_t button_flag_mask, bool is_button_pressed);
     void update_dpad_direction_pressed_state_thread_safe(uint8_t direction_flag_mask, bool is_direction_pressed);
@@ -48,14 +72,13 @@ public:
     std::string get_loaded_game_rom_title_thread_safe() const;
 
 private:
-    GameCartridgeSlot game_cartridge_slot{};
+    EventScheduler event_scheduler{};
+    GameCartridgeSlot game_cartridge_slot{event_scheduler};
+    InterruptRegisters interrupt_registers{};
     InternalTimer internal_timer;
     PixelProcessingUnit pixel_processing_unit;
     std::unique_ptr<MemoryManagementUnit> memory_management_unit;
-    CentralProcessingUnit central_processing_unit;
-
-    void step_components_single_machine_cycle_to_sync_with_central_processing_unit();
-    void request_interrupt(uint8_t interrupt_flag_mask);
+    CentralProcessingUnit<EmulatorSystemBus> central_processing_unit;
 };
 
 } // namespace GameBoyEmulator
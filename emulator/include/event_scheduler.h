@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace GameBoyEmulator
+{
+
+constexpr uint64_t UNSCHEDULED_EVENT_MACHINE_CYCLE = std::numeric_limits<uint64_t>::max();
+
+// Events that are due on the same machine cycle are handled in declaration order
+enum class ScheduledEventType : uint8_t
+{
+    TimerCounterReload,
+    ObjectAttributeMemoryDirectMemoryAccessTransfer,
+    ObjectAttributeMemoryDirectMemoryAccessStartup,
+    PixelProcessingUnitSynchronization
+};
+
+constexpr uint8_t NUMBER_OF_SCHEDULED_EVENT_TYPES = 4;
+
+// Keeps the central machine cycle counter and at most one pending timestamp per event type
+class EventScheduler
+{
+public:
+    EventScheduler()
+    {
+        reset_state();
+    }
+
+    void reset_state()
+    {
+        current_machine_cycle = 0;
+        event_machine_cycles.fill(UNSCHEDULED_EVENT_MACHINE_CYCLE);
+        next_event_machine_cycle = UNSCHEDULED_EVENT_MACHINE_CYCLE;
+    }
+
+    uint64_t get_current_machine_cycle() const
+    {
+        return current_machine_cycle;
+    }
+
+    void advance_machine_cycles(uint64_t machine_cycle_count)
+    {
+        current_machine_cycle += machine_cycle_count;
+    }
+
+    bool is_event_due() const
+    {
+        return current_machine_cycle >= next_event_machine_cycle;
+    }
+
+    uint64_t get_machine_cycles_until_next_event() const
+    {
+        return is_event_due() ? 0 : next_event_machine_cycle - current_machine_cycle;
+    }
+
+    bool is_event_scheduled(ScheduledEventType event_type) const
+    {
+        return event_machine_cycles[static_cast<uint8_t>(event_type)] != UNSCHEDULED_EVENT_MACHINE_CYCLE;
+    }
+
+    // Replaces any pending timestamp of the same event type
+    void schedule_event(ScheduledEventType event_type, uint64_t machine_cycles_from_now)
+    {
+        schedule_event_at_machine_cycle(event_type, current_machine_cycle + machine_cycles_from_now);
+    }
+
+    void schedule_event_at_machine_cycle(ScheduledEventType event_type, uint64_t machine_cycle)
+    {
+        event_machine_cycles[static_cast<uint8_t>(event_type)] = machine_cycle;
+        update_next_event_machine_cycle();
+    }
+
+    void cancel_event(ScheduledEventType event_type)
+    {
+        event_machine_cycles[static_cast<uint8_t>(event_type)] = UNSCHEDULED_EVENT_MACHINE_CYCLE;
+        update_next_event_machine_cycle();
+    }
+
+    // Must only be called while an event is due
+    ScheduledEventType pop_due_event()
+    {
+        uint8_t event_index = 0;
+        while (event_machine_cycles[event_index] != next_event_machine_cycle)
+        {
+            event_index++;
+        }
+        event_machine_cycles[event_index] = UNSCHEDULED_EVENT_MACHINE_CYCLE;
+        update_next_event_machine_cycle();
+        return static_cast<ScheduledEventType>(event_index);
+    }
+
+private:
+    uint64_t current_machine_cycle{};
+    uint64_t next_event_machine_cycle{};
+    std::array<uint64_t, NUMBER_OF_SCHEDULED_EVENT_TYPES> event_machine_cycles{};
+
+    void update_next_event_machine_cycle()
+    {
+        next_event_machine_cycle = UNSCHEDULED_EVENT_MACHINE_CYCLE;
+        for (const uint64_t event_machine_cycle : event_machine_cycles)
+        {
+            if (event_machine_cycle < next_event_machine_cycle)
+            {
+                next_event_machine_cycle = event_machine_cycle;
+            }
+        }
+    }
+};
+
+} // namespace GameBoyEmulator
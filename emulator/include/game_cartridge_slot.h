@@ -2,38 +2,54 @@
 
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "cartridge_save_file.h"
+#include "game_rom_image.h"
 #include "memory_bank_controllers.h"
 
 namespace GameBoyEmulator
 {
 
-constexpr uint8_t LOGO_SIZE = 48;
-constexpr uint16_t LOGO_START_POSITION = 0x0104;
-
-
 class GameCartridgeSlot
 {
 public:
-    GameCartridgeSlot();
+    explicit GameCartridgeSlot(const EventScheduler& event_scheduler);
 
     void reset_state();
+    void set_battery_backed_save_files_enabled(bool is_enabled);
+    void set_real_time_clock_time_source(RealTimeClockTimeSource time_source);
+    void prepare_for_machine_cycle_counter_reset();
 
-    bool try_load_file(
-        const std::filesystem::path& file_path,
-        std::ifstream& file,
-        std::streamsize file_length_in_bytes,
-        std::string& error_message);
+    bool try_load_file(const std::filesystem::path& file_path, std::string& error_message);
 
     uint8_t read_byte(uint16_t address) const;
     void write_byte(uint16_t address, uint8_t value);
+    uint16_t get_rom_bank_number(uint16_t address) const;
+
+    const uint8_t* get_rom_bank_x0_memory() const;
+    const uint8_t* get_rom_bank_0x_memory() const;
+    const uint8_t* get_readable_ram_bank_memory() const;
+    uint8_t* get_writable_ram_bank_memory();
 
 private:
-    std::vector<uint8_t> rom{};
+    const EventScheduler& event_scheduler;
+    std::shared_ptr<const GameRomImage> game_rom_image{};
     std::vector<uint8_t> ram{};
+    bool are_battery_backed_save_files_enabled{};
+    RealTimeClockTimeSource real_time_clock_time_source{RealTimeClockTimeSource::EmulatedMachineCycles};
+
+    // Declared before the memory bank controller so the controller can still write its final clock state while being destroyed
+    std::unique_ptr<CartridgeSaveFile> cartridge_save_file{};
     std::unique_ptr<MemoryBankControllerBase> memory_bank_controller{};
+
+    std::span<uint8_t> map_cartridge_ram(
+        const std::filesystem::path& game_rom_file_path,
+        const CartridgeHeader& cartridge_header,
+        uint32_t ram_size,
+        uint8_t initial_ram_value);
 };
 
 } // namespace GameBoyEmulator
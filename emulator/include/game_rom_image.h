@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "memory_mapped_file.h"
+
+namespace GameBoyEmulator
+{
+
+constexpr uint8_t LOGO_SIZE = 48;
+constexpr uint16_t LOGO_START_POSITION = 0x0104;
+constexpr uint8_t EXPECTED_LOGO[LOGO_SIZE] =
+{
+    0xCE, 0xED, 0x66, 0x66, 0xCC, 0x0D, 0x00, 0x0B,
+    0x03, 0x73, 0x00, 0x83, 0x00, 0x0C, 0x00, 0x0D,
+    0x00, 0x08, 0x11, 0x1F, 0x88, 0x89, 0x00, 0x0E,
+    0xDC, 0xCC, 0x6E, 0xE6, 0xDD, 0xDD, 0xD9, 0x99,
+    0xBB, 0xBB, 0x67, 0x63, 0x6E, 0x0E, 0xEC, 0xCC,
+    0xDD, 0xDC, 0x99, 0x9F, 0xBB, 0xB9, 0x33, 0x3E
+};
+
+struct CartridgeHeader
+{
+    uint8_t cartridge_type{};
+    uint32_t cartridge_ram_size{};
+    bool is_mbc1m_multi_game_compilation{};
+};
+
+// Checks the header fields that loading depends on, and describes the first problem found without printing it
+bool try_parse_cartridge_header(std::span<const uint8_t> rom_bytes, CartridgeHeader& cartridge_header, std::string& error_message);
+
+// A validated game ROM that is never written to, so every emulator instance running the same title can share it.
+// The bytes are the file mapping itself, so the ROM file must not be rewritten or truncated while any instance holds the image
+class GameRomImage
+{
+public:
+    GameRomImage(
+        std::unique_ptr<MemoryMappedFile> mapped_file,
+        const CartridgeHeader& header,
+        uint64_t content_hash);
+
+    std::span<const uint8_t> get_bytes() const
+    {
+        return {memory_mapped_file->data(), memory_mapped_file->size()};
+    }
+
+    const CartridgeHeader& get_header() const
+    {
+        return cartridge_header;
+    }
+
+    uint64_t get_content_hash() const
+    {
+        return rom_content_hash;
+    }
+
+private:
+    std::unique_ptr<MemoryMappedFile> memory_mapped_file;
+    CartridgeHeader cartridge_header;
+    uint64_t rom_content_hash;
+};
+
+// Process-wide registry keyed by path and content hash. An image stays mapped while any instance holds it, and
+// loading an unchanged path or identical content under another path returns the existing image without validating it again
+class GameRomImageRegistry
+{
+public:
+    static std::shared_ptr<const GameRomImage> try_acquire(const std::filesystem::path& file_path, std::string& error_message);
+};
+
+} // namespace GameBoyEmulator
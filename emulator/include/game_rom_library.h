@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GameBoyEmulator
+{
+
+constexpr const char* GAME_ROM_LIBRARY_FILE_EXTENSIONS[] = {".gb", ".gbc", ".bin", ".rom"};
+
+// Header fields of one ROM file, along with the size and modification time they were read at
+struct GameRomLibraryEntry
+{
+    std::filesystem::path file_path{};
+    uint64_t file_size{};
+    int64_t last_write_time{};
+    std::string title{};
+    uint8_t color_game_boy_flag{};
+    uint8_t cartridge_type{};
+    uint8_t rom_size_byte{};
+    uint8_t ram_size_byte{};
+    bool is_logo_valid{};
+    bool is_header_checksum_valid{};
+    bool is_global_checksum_valid{};
+    bool is_loadable{};
+    std::string load_error_message{};
+};
+
+// Index of the game ROMs found under a set of directories. A scan only reads files whose size or modification time
+// differ from the on-disk cache, and parses them on a pool of worker threads. Scans run in the background and publish
+// a new sorted snapshot of the entries when they finish, so readers never wait on the disk
+class GameRomLibrary
+{
+public:
+    explicit GameRomLibrary(const std::filesystem::path& cache_file_path);
+    ~GameRomLibrary();
+
+    bool try_load_cache(std::string& error_message);
+    bool try_save_cache(std::string& error_message) const;
+
+    void add_directory(const std::filesystem::path& directory_path);
+    void remove_directory(const std::filesystem::path& directory_path);
+    std::vector<std::filesystem::path> get_directories() const;
+
+    void start_scan();
+    bool is_scan_in_progress() const;
+    uint32_t get_scanned_file_count() const;
+    uint32_t get_file_count_to_scan() const;
+
+    std::shared_ptr<const std::vector<GameRomLibraryEntry>> get_entries() const;
+
+    static bool try_read_entry(const std::filesystem::path& file_path, GameRomLibraryEntry& entry);
+
+private:
+    std::filesystem::path cache_file_path;
+    mutable std::mutex library_mutex;
+    std::vector<std::filesystem::path> directories{};
+    std::shared_ptr<const std::vector<GameRomLibraryEntry>> entries{std::make_shared<const std::vector<GameRomLibraryEntry>>()};
+
+    std::jthread scan_thread{};
+    std::atomic<bool> is_scan_running{};
+    std::atomic<uint32_t> scanned_file_count{};
+    std::atomic<uint32_t> file_count_to_scan{};
+
+    void scan(std::stop_token stop_token, std::vector<std::filesystem::path> directories_to_scan);
+};
+
+} // namespace GameBoyEmulator
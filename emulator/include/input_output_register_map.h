@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace GameBoyEmulator
+{
+
+constexpr uint8_t NUMBER_OF_INPUT_OUTPUT_REGISTERS = 0x80;
+constexpr uint8_t INPUT_OUTPUT_REGISTER_INDEX_MASK = NUMBER_OF_INPUT_OUTPUT_REGISTERS - 1;
+
+using InputOutputRegisterReadHandler = uint8_t (*)(void* context);
+using InputOutputRegisterWriteHandler = void (*)(void* context, uint8_t value);
+
+// Bits set in the read mask always read back as 1, which is how unused and write-only bits behave on hardware
+struct InputOutputRegister
+{
+    void* context{};
+    InputOutputRegisterReadHandler read_handler{};
+    void* write_context{};
+    InputOutputRegisterWriteHandler write_handler{};
+    uint8_t read_mask{};
+};
+
+// Dispatches FF00-FF7F through a table filled in by each peripheral at construction.
+// Addresses nothing is registered for keep a plain byte of storage, so peripherals that are not emulated yet still read back what was written
+class InputOutputRegisterMap
+{
+public:
+    InputOutputRegisterMap();
+
+    void reset_state();
+
+    uint8_t read_byte(uint16_t address) const
+    {
+        const InputOutputRegister& input_output_register = input_output_registers[address & INPUT_OUTPUT_REGISTER_INDEX_MASK];
+        return input_output_register.read_handler(input_output_register.context) | input_output_register.read_mask;
+    }
+
+    void write_byte(uint16_t address, uint8_t value)
+    {
+        const InputOutputRegister& input_output_register = input_output_registers[address & INPUT_OUTPUT_REGISTER_INDEX_MASK];
+        input_output_register.write_handler(input_output_register.write_context, value);
+    }
+
+    void register_handlers(
+        uint16_t address,
+        void* context,
+        InputOutputRegisterReadHandler read_handler,
+        InputOutputRegisterWriteHandler write_handler,
+        uint8_t read_mask = 0x00);
+
+    void register_storage(uint16_t address, uint8_t& storage, uint8_t read_mask = 0x00);
+    void set_read_mask(uint16_t address, uint8_t read_mask);
+
+    template <typename Peripheral, uint8_t (Peripheral::*read_member_function)() const, void (Peripheral::*write_member_function)(uint8_t)>
+    void register_member_functions(uint16_t address, Peripheral& peripheral, uint8_t read_mask = 0x00)
+    {
+        register_handlers(
+            address,
+            &peripheral,
+            [](void* context) { return (static_cast<Peripheral*>(context)->*read_member_function)(); },
+            [](void* context, uint8_t value) { (static_cast<Peripheral*>(context)->*write_member_function)(value); },
+            read_mask);
+    }
+
+    template <typename Peripheral, uint8_t (Peripheral::*read_member_function)() const>
+    void register_read_only_member_function(uint16_t address, Peripheral& peripheral)
+    {
+        register_handlers(
+            address,
+            &peripheral,
+            [](void* context) { return (static_cast<Peripheral*>(context)->*read_member_function)(); },
+            nullptr);
+    }
+
+private:
+    std::array<InputOutputRegister, NUMBER_OF_INPUT_OUTPUT_REGISTERS> input_output_registers{};
+    std::array<uint8_t, NUMBER_OF_INPUT_OUTPUT_REGISTERS> unmapped_storage{};
+    std::array<uint16_t, NUMBER_OF_INPUT_OUTPUT_REGISTERS> read_only_register_addresses{};
+};
+
+} // namespace GameBoyEmulator
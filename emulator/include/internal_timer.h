@@ -1,25 +1,35 @@
 #pragma once
 
 #include <cstdint>
-#include <functional>
+
+#include "event_scheduler.h"
+#include "input_output_register_map.h"
+#include "interrupt_registers.h"
 
 namespace GameBoyEmulator
 {
 
+constexpr uint8_t SYSTEM_COUNTER_INCREMENT_PER_MACHINE_CYCLE = 4;
+constexpr uint16_t UNWRAPPED_TIMA_OVERFLOW_VALUE = 0x100;
+
+// DIV and TIMA are derived from the central machine cycle counter when read, only the TIMA reload after an overflow is a scheduled event
 class InternalTimer
 {
 public:
-    InternalTimer(std::function<void(uint8_t)> request_interrupt);
+    InternalTimer(InterruptRegisters& interrupt_registers_reference, EventScheduler& event_scheduler_reference);
 
     void reset_state();
     void set_post_boot_state();
+    void register_input_output_registers(InputOutputRegisterMap& input_output_register_map);
 
-    void step_single_machine_cycle();
+    void reload_tima_after_overflow();
 
     uint8_t read_div() const;
     uint8_t read_tima() const;
     uint8_t read_tma() const;
     uint8_t read_tac() const;
+    uint32_t get_machine_cycles_until_div_change() const;
+    uint64_t get_machine_cycles_until_tima_change() const;
 
     void write_div(uint8_t value);
     void write_tima(uint8_t value);
@@ -27,17 +37,25 @@ public:
     void write_tac(uint8_t value);
 
 private:
-    std::function<void(uint8_t)> request_interrupt_callback;
-    uint16_t system_counter{};
-    uint8_t timer_tima{};
+    InterruptRegisters& interrupt_registers;
+    EventScheduler& event_scheduler;
+    uint16_t system_counter_base{};
+    uint64_t system_counter_base_machine_cycle{};
+    uint16_t timer_tima_base{};
+    uint64_t timer_tima_base_machine_cycle{};
     uint8_t timer_modulo_tma{};
     uint8_t timer_control_tac{0b11111000};
-    bool is_previously_selected_system_counter_bit_set{};
-    bool did_tima_overflow_occur{};
-    bool is_tima_overflow_handled{};
-
-    void update_tima_early();
-    bool update_tima_and_get_overflow_state();
+    uint64_t tima_reload_machine_cycle{UNSCHEDULED_EVENT_MACHINE_CYCLE};
+
+    uint64_t get_unwrapped_system_counter(uint64_t machine_cycle) const;
+    uint16_t get_unwrapped_tima() const;
+    void set_unwrapped_tima(uint16_t unwrapped_tima);
+    void update_tima_early(bool was_selected_system_counter_bit_set, uint16_t unwrapped_tima);
+    void schedule_tima_reload();
+    bool is_tima_overflow_handled() const;
+    bool is_selected_system_counter_bit_set() const;
+    bool is_tima_enabled() const;
+    uint32_t get_selected_system_counter_bit_period() const;
 };
 
 } // namespace GameBoyEmulator
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+#include "bitwise_utilities.h"
+#include "input_output_register_map.h"
+
+namespace GameBoyEmulator
+{
+
+constexpr uint8_t NUMBER_OF_INTERRUPT_TYPES = 5;
+constexpr uint8_t JOYPAD_INTERRUPT_FLAG_MASK = 1 << 4;
+constexpr uint8_t SERIAL_INTERRUPT_FLAG_MASK = 1 << 3;
+constexpr uint8_t TIMER_INTERRUPT_FLAG_MASK = 1 << 2;
+constexpr uint8_t INTERRUPT_FLAG_STAT_MASK = 1 << 1;
+constexpr uint8_t INTERRUPT_FLAG_VERTICAL_BLANK_MASK = 1 << 0;
+
+class InterruptRegisters
+{
+public:
+    void reset_state()
+    {
+        interrupt_flag_if = 0b11100000;
+        interrupt_enable_ie = 0b00000000;
+    }
+
+    void set_post_boot_state()
+    {
+        interrupt_flag_if = 0b11100001;
+        interrupt_enable_ie = 0b00000000;
+    }
+
+    // IE sits at 0xFFFF outside of the input/output register range, so only IF is registered
+    void register_input_output_registers(InputOutputRegisterMap& input_output_register_map)
+    {
+        input_output_register_map.register_member_functions<
+            InterruptRegisters, &InterruptRegisters::read_interrupt_flag_if, &InterruptRegisters::write_interrupt_flag_if>(0xFF0F, *this);
+    }
+
+    uint8_t read_interrupt_flag_if() const
+    {
+        return interrupt_flag_if | 0b11100000;
+    }
+
+    void write_interrupt_flag_if(uint8_t value)
+    {
+        interrupt_flag_if = value | 0b11100000;
+    }
+
+    uint8_t read_interrupt_enable_ie() const
+    {
+        return interrupt_enable_ie;
+    }
+
+    void write_interrupt_enable_ie(uint8_t value)
+    {
+        interrupt_enable_ie = value;
+    }
+
+    void request_interrupt(uint8_t interrupt_flag_mask)
+    {
+        update_flag(interrupt_flag_if, interrupt_flag_mask, true);
+    }
+
+    void clear_interrupt_flag_bit(uint8_t interrupt_flag_mask)
+    {
+        update_flag(interrupt_flag_if, interrupt_flag_mask, false);
+    }
+
+    uint8_t get_pending_interrupt_mask() const
+    {
+        // The lowest set bit is the highest priority interrupt
+        const uint8_t pending_interrupts_mask = interrupt_flag_if & interrupt_enable_ie & ((1 << NUMBER_OF_INTERRUPT_TYPES) - 1);
+        return pending_interrupts_mask & static_cast<uint8_t>(-pending_interrupts_mask);
+    }
+
+private:
+    uint8_t interrupt_flag_if{0b11100000};
+    uint8_t interrupt_enable_ie{};
+};
+
+} // namespace GameBoyEmulator
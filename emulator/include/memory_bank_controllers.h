@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <vector>
+#include <span>
+
+#include "event_scheduler.h"
 
 namespace GameBoyEmulator
 {
@@ -32,19 +36,61 @@ constexpr uint8_t ROM_BANK_SIZE_POWER_OF_TWO = 14;
 constexpr uint16_t RAM_BANK_SIZE = 0x2000;
 constexpr uint8_t RAM_BANK_SIZE_POWER_OF_TWO = 13;
 
+// Seconds, minutes, hours, day low and day high as 32-bit values, the same five latched, then a 64-bit UNIX timestamp
+constexpr uint8_t REAL_TIME_CLOCK_SAVE_DATA_SIZE = 48;
+constexpr uint32_t REAL_TIME_CLOCK_SAVE_DATA_DIRTY_MASK = 0x80000000;
+
+// Emulated time follows the machine cycle counter so runs are reproducible, host time follows the system clock and keeps running while the emulator is closed
+enum class RealTimeClockTimeSource : uint8_t
+{
+    EmulatedMachineCycles,
+    HostSystemClock
+};
+
 class MemoryBankControllerBase
 {
 public:
     static constexpr uint16_t ROM_ONLY_WITH_NO_MBC_FILE_SIZE = 0x8000;
 
-    MemoryBankControllerBase(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram);
+    MemoryBankControllerBase(std::span<const uint8_t> rom, std::span<uint8_t> ram);
+    virtual ~MemoryBankControllerBase() = default;
 
     virtual uint8_t read_byte(uint16_t address);
     virtual void write_byte(uint16_t address, uint8_t value);
 
+    uint16_t get_rom_bank_number(uint16_t address) const
+    {
+        return (address < ROM_BANK_SIZE) ? rom_bank_x0_number : rom_bank_0x_number;
+    }
+
+    // Host memory backing each region with the current bank selection, or nullptr where accesses must go through read_byte and write_byte
+    const uint8_t* get_rom_bank_x0_memory() const { return rom_bank_x0_memory; }
+    const uint8_t* get_rom_bank_0x_memory() const { return rom_bank_0x_memory; }
+    const uint8_t* get_readable_ram_bank_memory() const { return readable_ram_bank_memory; }
+
+    // Writes to tracked RAM have to go through write_byte so the bank can be marked dirty
+    uint8_t* get_writable_ram_bank_memory() { return (dirty_save_data_mask == nullptr) ? writable_ram_bank_memory : nullptr; }
+
+    void track_save_data_writes(std::atomic<uint32_t>& save_data_dirty_mask);
+    virtual void map_real_time_clock_save_data(std::span<uint8_t> save_data);
+    virtual void prepare_for_machine_cycle_counter_reset();
+
 protected:
-    const std::vector<uint8_t>& cartridge_rom;
-    std::vector<uint8_t>& cartridge_ram;
+    const std::span<const uint8_t> cartridge_rom;
+    const std::span<uint8_t> cartridge_ram;
+
+    // Recomputed only when a bank control register is written, so reads index straight into the selected bank
+    uint16_t rom_bank_x0_number{0};
+    uint16_t rom_bank_0x_number{1};
+    const uint8_t* rom_bank_x0_memory{};
+    const uint8_t* rom_bank_0x_memory{};
+    const uint8_t* readable_ram_bank_memory{};
+    uint8_t* writable_ram_bank_memory{};
+    std::atomic<uint32_t>* dirty_save_data_mask{};
+
+    void map_rom_banks(uint16_t selected_rom_bank_x0_number, uint16_t selected_rom_bank_0x_number);
+    void write_ram_bank_byte(uint16_t address, uint8_t value);
+    void mark_save_data_dirty(uint32_t save_data_mask);
 };
 
 class MBC1 : public MemoryBankControllerBase
@@ -57,7 +103,7 @@ public:
 
     static constexpr uint32_t MAX_RAM_SIZE_IN_LARGE_CONFIGURATION = 0x2000;
 
-    MBC1(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram);
+    MBC1(std::span<const uint8_t> rom, std::span<uint8_t> ram, bool is_mbc1m_multi_game_compilation);
 
     uint8_t read_byte(uint16_t address) override;
     void write_byte(uint16_t address, uint8_t value) override;
@@ -65,11 +111,14 @@ public:
 private:
     uint8_t number_of_rom_banks;
     uint8_t number_of_ram_banks;
+    uint8_t upper_two_bits_of_rom_bank_number_shift;
 
     bool is_ram_enabled{};
     uint8_t lower_five_bits_of_rom_bank_number{MINIMUM_ALLOWABLE_ROM_BANK_NUMBER};
     uint8_t ram_bank_number_or_upper_two_bits_of_rom_bank_number{};
     uint8_t banking_mode{};
+
+    void remap_bank_memory();
 };
 
 class MBC2 : public MemoryBankControllerBase
@@ -80,7 +129,7 @@ public:
     static constexpr uint32_t MAX_NUMBER_OF_ROM_BANKS = 0x10;
     static constexpr uint16_t BUILT_IN_RAM_SIZE = 0x200;
 
-    MBC2(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram);
+    MBC2(std::span<const uint8_t> rom, std::span<uint8_t> ram);
 
     uint8_t read_byte(uint16_t address) override;
     void write_byte(uint16_t address, uint8_t value) override;
@@ -88,6 +137,8 @@ public:
 private:
     bool is_ram_enabled{};
     uint8_t selected_rom_bank_number{MINIMUM_ALLOWABLE_ROM_BANK_NUMBER};
+
+    void remap_bank_memory();
 };
 
 class MBC3 : public MemoryBankControllerBase
@@ -96,31 +147,55 @@ public:
     static constexpr int MINIMUM_ALLOWABLE_ROM_BANK_NUMBER = 1;
     static constexpr uint32_t MAX_ROM_SIZE = 0x200000;
     static constexpr uint32_t MAX_RAM_SIZE = 0x8000;
+    static constexpr int64_t MACHINE_CYCLES_PER_SECOND = 0x100000;
+    static constexpr int64_t HOST_SYSTEM_CLOCK_TICKS_PER_SECOND = 1000000000;
+    static constexpr uint16_t NUMBER_OF_DAYS_BEFORE_DAY_COUNTER_CARRY = 512;
+    static constexpr uint8_t SECONDS_AND_MINUTES_COUNTER_MASK = 0x3F;
+    static constexpr uint8_t HOURS_COUNTER_MASK = 0x1F;
 
-    MBC3(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram);
+    MBC3(std::span<const uint8_t> rom, std::span<uint8_t> ram, const EventScheduler& event_scheduler, RealTimeClockTimeSource time_source);
+    ~MBC3() override;
 
     uint8_t read_byte(uint16_t address) override;
     void write_byte(uint16_t address, uint8_t value) override;
+    void map_real_time_clock_save_data(std::span<uint8_t> save_data) override;
+    void prepare_for_machine_cycle_counter_reset() override;
 
 private:
     uint8_t number_of_rom_banks;
     uint8_t number_of_ram_banks;
+    std::span<uint8_t> real_time_clock_save_data{};
+    const EventScheduler& event_scheduler;
+    const RealTimeClockTimeSource real_time_clock_time_source;
 
     bool are_ram_and_real_time_clock_enabled{};
     uint8_t selected_rom_bank_number{MINIMUM_ALLOWABLE_ROM_BANK_NUMBER};
     uint8_t selected_ram_bank_number_or_real_time_clock_register_select{};
 
+    // The counters are only brought up to date from the time base when the clock registers are latched, read or written
     struct RealTimeClock
     {
         bool is_halted{};
         bool is_day_counter_carry_set{};
-        bool are_time_counters_latched{};
         uint8_t latch_clock_data{};
         uint8_t seconds_counter{};
         uint8_t minutes_counter{};
         uint8_t hours_counter{};
         uint16_t days_counter{};
+        int64_t time_base{};
     } real_time_clock;
+
+    // Register values as seen by the game, indexed by the clock register select minus 0x08
+    std::array<uint8_t, 5> latched_real_time_clock_registers{};
+
+    int64_t get_real_time_clock_time() const;
+    int64_t get_real_time_clock_ticks_per_second() const;
+    void update_real_time_clock();
+    void advance_real_time_clock_counters(uint64_t elapsed_seconds);
+    void advance_real_time_clock_counters_by_one_second();
+    std::array<uint8_t, 5> get_real_time_clock_registers() const;
+    void remap_bank_memory();
+    void save_real_time_clock();
 };
 
 class MBC5 : public MemoryBankControllerBase
@@ -129,7 +204,7 @@ public:
     static constexpr uint32_t MAX_ROM_SIZE = 0x800000;
     static constexpr uint32_t MAX_RAM_SIZE = 0x20000;
 
-    MBC5(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram);
+    MBC5(std::span<const uint8_t> rom, std::span<uint8_t> ram);
 
     uint8_t read_byte(uint16_t address) override;
     void write_byte(uint16_t address, uint8_t value) override;
@@ -141,6 +216,8 @@ private:
     bool is_ram_enabled{};
     uint8_t selected_ram_bank_number{};
     uint16_t selected_rom_bank_number{1};
+
+    void remap_bank_memory();
 };
 
 } // namespace GameBoyEmulator
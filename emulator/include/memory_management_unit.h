@@ -1,10 +1,15 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <filesystem>
 
+#include "dynamic_recompiler.h"
+#include "event_scheduler.h"
 #include "game_cartridge_slot.h"
+#include "input_output_register_map.h"
+#include "interrupt_registers.h"
 #include "internal_timer.h"
 #include "pixel_processing_unit.h"
 
@@ -30,12 +35,12 @@ constexpr uint16_t UNUSABLE_MEMORY_START = 0xFEA0;
 constexpr uint16_t INPUT_OUTPUT_REGISTERS_START = 0xFF00;
 constexpr uint16_t HIGH_RAM_START = 0xFF80;
 
-constexpr uint8_t OAM_DMA_MACHINE_CYCLE_DURATION = 0xA0;
+constexpr uint16_t NUMBER_OF_MEMORY_PAGES = 0x100;
+constexpr uint8_t MEMORY_PAGE_SIZE_POWER_OF_TWO = 8;
+constexpr uint16_t MEMORY_PAGE_SIZE = 1 << MEMORY_PAGE_SIZE_POWER_OF_TWO;
 
-constexpr uint8_t NUMBER_OF_INTERRUPT_TYPES = 5;
-constexpr uint8_t JOYPAD_INTERRUPT_FLAG_MASK = 1 << 4;
-constexpr uint8_t SERIAL_INTERRUPT_FLAG_MASK = 1 << 3;
-constexpr uint8_t TIMER_INTERRUPT_FLAG_MASK = 1 << 2;
+constexpr uint8_t OAM_DMA_MACHINE_CYCLE_DURATION = 0xA0;
+constexpr uint8_t OAM_DMA_STARTUP_MACHINE_CYCLE_DELAY = 2;
 
 constexpr uint8_t RIGHT_DPAD_DIRECTION_FLAG_MASK = 1 << 0;
 constexpr uint8_t LEFT_DPAD_DIRECTION_FLAG_MASK = 1 << 1;
@@ -53,22 +58,17 @@ enum class FileType
     BootROM
 };
 
-enum class ObjectAttributeMemoryDirectMemoryAccessStartupState
-{
-    NotStarting,
-    RegisterWrittenTo,
-    Starting
-};
-
 class MemoryManagementUnit
 {
 public:
     MemoryManagementUnit(
         GameCartridgeSlot& game_cartridge_slot_reference,
+        InterruptRegisters& interrupt_registers_reference,
         InternalTimer& internal_timer_reference,
-        PixelProcessingUnit& pixel_processing_unit_reference);
+        PixelProcessingUnit& pixel_processing_unit_reference,
+        EventScheduler& event_scheduler_reference);
 
-    virtual void reset_state();
+    void reset_state();
     void set_post_boot_state();
     bool try_load_file_to_read_only_memory(const std::filesystem::path& file_path, FileType file_type, std::string& error_message);
     void unload_boot_rom_thread_safe();
@@ -77,14 +77,35 @@ public:
     bool is_boot_rom_loaded_thread_safe() const;
     bool is_boot_rom_mapped() const;
 
-    virtual uint8_t read_byte(uint16_t address, bool is_access_unrestricted) const;
-    virtual void write_byte(uint16_t address, uint8_t value, bool is_access_unrestricted);
-
-    void step_single_machine_cycle();
-
-    void request_interrupt(uint8_t interrupt_flag_mask);
-    void clear_interrupt_flag_bit(uint8_t interrupt_flag_mask);
-    uint8_t get_pending_interrupt_mask() const;
+    uint8_t read_byte(uint16_t address, bool is_access_unrestricted) const
+    {
+        const uint8_t* read_memory_page = read_memory_pages[address >> MEMORY_PAGE_SIZE_POWER_OF_TWO];
+        if (read_memory_page != nullptr)
+        {
+            return read_memory_page[address & (MEMORY_PAGE_SIZE - 1)];
+        }
+        return read_byte_from_handlers(address, is_access_unrestricted);
+    }
+
+    void write_byte(uint16_t address, uint8_t value, bool is_access_unrestricted)
+    {
+        uint8_t* write_memory_page = write_memory_pages[address >> MEMORY_PAGE_SIZE_POWER_OF_TWO];
+        if (write_memory_page != nullptr)
+        {
+            write_memory_page[address & (MEMORY_PAGE_SIZE - 1)] = value;
+            return;
+        }
+        write_byte_to_handlers(address, value, is_access_unrestricted);
+    }
+
+    const TranslatedBlock* get_translated_block(uint16_t address);
+    uint32_t execute_translated_block(const TranslatedBlock& translated_block, RegisterFile<std::endian::native>& register_file, uint32_t machine_cycle_budget)
+    {
+        return translated_block.function(&register_file, read_memory_pages.data(), write_memory_pages.data(), machine_cycle_budget);
+    }
+
+    void start_oam_dma();
+    void transfer_oam_dma_byte();
 
     void update_button_pressed_state_thread_safe(uint8_t button_flag_mask, bool is_button_pressed);
     void update_dpad_direction_pressed_state_thread_safe(uint8_t direction_flag_mask, bool is_direction_pressed);
@@ -92,12 +113,21 @@ public:
 private:
     std::unique_ptr<uint8_t[]> boot_rom{};
     std::unique_ptr<uint8_t[]> work_ram{};
-    std::unique_ptr<uint8_t[]> unmapped_input_output_registers{};
     std::unique_ptr<uint8_t[]> high_ram{};
 
     GameCartridgeSlot& game_cartridge_slot;
+    InterruptRegisters& interrupt_registers;
     InternalTimer& internal_timer;
     PixelProcessingUnit& pixel_processing_unit;
+    EventScheduler& event_scheduler;
+
+    DynamicRecompiler dynamic_recompiler{};
+    InputOutputRegisterMap input_output_register_map{};
+
+    // Pages backed by plain host memory are accessed directly, every other page goes through the handlers.
+    // That covers video RAM, OAM, the input/output registers, high RAM, banking registers and the bus an OAM DMA is reading from
+    std::array<const uint8_t*, NUMBER_OF_MEMORY_PAGES> read_memory_pages{};
+    std::array<uint8_t*, NUMBER_OF_MEMORY_PAGES> write_memory_pages{};
 
     std::atomic<bool> is_boot_rom_loaded_in_memory_atomic{};
     std::atomic<bool> is_game_rom_loaded_in_memory_atomic{};
@@ -107,14 +137,28 @@ private:
     std::atomic<uint8_t> most_recent_currently_pressed_vertical_direction_atomic{0b11111111};
     std::atomic<uint8_t> most_recent_currently_pressed_horizontal_direction_atomic{0b11111111};
     uint8_t joypad_p1_joyp{0b11111111};
-    uint8_t interrupt_flag_if{0b11100000};
     uint8_t boot_rom_status{};
-    uint8_t interrupt_enable_ie{};
 
-    ObjectAttributeMemoryDirectMemoryAccessStartupState oam_dma_startup_state{ObjectAttributeMemoryDirectMemoryAccessStartupState::NotStarting};
     uint16_t oam_dma_source_address_base{};
     uint8_t oam_dma_machine_cycles_elapsed{};
 
+    void register_input_output_registers();
+    uint8_t read_joypad_p1_joyp() const;
+    void write_joypad_p1_joyp(uint8_t value);
+    uint8_t read_oam_dma_source_dma() const;
+    void write_oam_dma_source_dma(uint8_t value);
+    uint8_t read_boot_rom_status() const;
+    void write_boot_rom_status(uint8_t value);
+
+    uint8_t read_byte_from_handlers(uint16_t address, bool is_access_unrestricted) const;
+    void write_byte_to_handlers(uint16_t address, uint8_t value, bool is_access_unrestricted);
+
+    void remap_memory_pages();
+    void remap_cartridge_memory_pages();
+    void map_read_memory_pages(uint16_t start_address, uint16_t size, const uint8_t* memory);
+    void map_write_memory_pages(uint16_t start_address, uint16_t size, uint8_t* memory);
+    void unmap_oam_dma_source_bus_read_memory_pages();
+
     bool are_addresses_on_same_bus(uint16_t first_address, uint16_t second_address) const;
 };
 
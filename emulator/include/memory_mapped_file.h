@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace GameBoyEmulator
+{
+
+// A whole file mapped into the address space. Pages are loaded on first access and read-only mappings of the same file share physical memory.
+// Writes to a writable mapping reach the file even if the process exits without flushing, flushing only guards against the system going down.
+// The mapping is not a snapshot: rewriting the file in place changes the mapped bytes, and reading past the end of a file truncated after mapping
+// raises SIGBUS on POSIX or an in-page error on Windows
+class MemoryMappedFile
+{
+public:
+    static std::unique_ptr<MemoryMappedFile> try_map_read_only(const std::filesystem::path& file_path, std::string& error_message);
+
+    // Creates the file or extends it with zeros when it is shorter than the requested size
+    static std::unique_ptr<MemoryMappedFile> try_map_read_write(
+        const std::filesystem::path& file_path,
+        size_t size,
+        size_t& previous_file_size,
+        std::string& error_message);
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    ~MemoryMappedFile();
+
+    const uint8_t* data() const
+    {
+        return mapped_memory;
+    }
+
+    uint8_t* data()
+    {
+        return mapped_memory;
+    }
+
+    size_t size() const
+    {
+        return mapped_size;
+    }
+
+    void flush(size_t offset, size_t length);
+
+private:
+    MemoryMappedFile() = default;
+
+    uint8_t* mapped_memory{};
+    size_t mapped_size{};
+};
+
+} // namespace GameBoyEmulator
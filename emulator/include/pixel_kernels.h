@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GameBoyEmulator
+{
+
+enum class PixelKernelInstructionSet
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// One scanline's layers as colour indices. Object flags keep the palette (bit 4) and priority (bit 7) bits of the object
+// that owns each pixel, and the object layers are still all zero when no object was fetched
+struct ScanlineLayers
+{
+    const uint8_t* background_colour_indices{};
+    const uint8_t* object_colour_indices{};
+    const uint8_t* object_flags{};
+    uint8_t background_palette{};
+    uint8_t object_palette_0{};
+    uint8_t object_palette_1{};
+    bool are_background_and_window_enabled{};
+    bool is_object_display_enabled{};
+    bool are_objects_selected{};
+};
+
+struct PixelKernels
+{
+    PixelKernelInstructionSet instruction_set{};
+
+    // Writes the 8 colour indices of a tile row followed by the same row flipped horizontally
+    void (*decode_tile_row)(uint8_t tile_row_low, uint8_t tile_row_high, uint8_t* decoded_tile_row_and_flipped){};
+
+    // Picks the background or object pixel by priority and applies BGP, OBP0 or OBP1 to get the shade of each pixel
+    void (*compose_scanline)(const ScanlineLayers& scanline_layers, uint8_t* shades, size_t pixel_count){};
+
+    void (*convert_shades_to_abgr)(const uint8_t* shades, const uint32_t* abgr_colour_palette, uint32_t* abgr_pixels, size_t pixel_count){};
+};
+
+bool is_pixel_kernel_instruction_set_supported(PixelKernelInstructionSet instruction_set);
+const PixelKernels& get_pixel_kernels(PixelKernelInstructionSet instruction_set);
+
+// The kernels for the widest instruction set the host supports, selected on first use
+const PixelKernels& get_pixel_kernels();
+
+} // namespace GameBoyEmulator
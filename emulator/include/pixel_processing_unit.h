@@ -6,14 +6,15 @@
 #include <functional>
 #include <iostream>
 #include <memory>
-#include <vector>
+
+#include "event_scheduler.h"
+#include "input_output_register_map.h"
+#include "interrupt_registers.h"
+#include "pixel_kernels.h"
 
 namespace GameBoyEmulator
 {
 
-constexpr uint8_t INTERRUPT_FLAG_STAT_MASK = 1 << 1;
-constexpr uint8_t INTERRUPT_FLAG_VERTICAL_BLANK_MASK = 1 << 0;
-
 constexpr uint16_t VIDEO_RAM_SIZE = 0x2000;
 constexpr uint16_t OBJECT_ATTRIBUTE_MEMORY_SIZE = 0x00A0;
 
@@ -23,8 +24,14 @@ constexpr uint16_t OBJECT_ATTRIBUTE_MEMORY_START = 0xFE00;
 constexpr uint8_t DISPLAY_WIDTH_PIXELS = 160;
 constexpr uint8_t DISPLAY_HEIGHT_PIXELS = 144;
 
+constexpr uint16_t NUMBER_OF_TILES = 384;
+constexpr uint8_t BYTES_PER_TILE = 16;
+constexpr uint16_t TILE_DATA_SIZE = NUMBER_OF_TILES * BYTES_PER_TILE;
+
 constexpr uint8_t DOTS_PER_MACHINE_CYCLE = 4;
 constexpr uint8_t PIXELS_PER_TILE_ROW = 8;
+constexpr uint8_t NUMBER_OF_OBJECTS = 40;
+constexpr uint8_t BYTES_PER_OBJECT = 4;
 constexpr uint8_t MAX_OBJECTS_PER_LINE = 10;
 
 constexpr uint8_t OBJECT_ATTRIBUTE_MEMORY_SCAN_DURATION_DOTS = 80;
@@ -75,11 +82,6 @@ struct ObjectAttributes
     uint8_t flags{};
 };
 
-struct BackgroundPixel
-{
-    uint8_t colour_index{};
-};
-
 struct ObjectPixel
 {
     uint8_t colour_index{};
@@ -101,73 +103,91 @@ struct PixelSliceFetcher
 
 struct BackgroundPixelSliceFetcher : PixelSliceFetcher
 {
-    std::array<BackgroundPixel, PIXELS_PER_TILE_ROW> tile_row{};
     FetcherMode fetcher_mode{FetcherMode::BackgroundMode};
     uint8_t fetcher_x{};
 
     void reset_state() override;
 };
 
-template <typename T, uint8_t total_capacity>
-class ParallelInSerialOutShiftRegister
+// Pixels are held as bit-planes with one bit per pixel, the next pixel to shift out being the most significant bit
+class BackgroundPixelShiftRegister
 {
 public:
-    ParallelInSerialOutShiftRegister(bool should_track_current_size)
-        : is_tracking_current_size{should_track_current_size}
+    void load_new_tile_row(uint8_t tile_row_low, uint8_t tile_row_high)
     {
+        colour_low_plane = tile_row_low;
+        colour_high_plane = tile_row_high;
+        current_size = PIXELS_PER_TILE_ROW;
     }
 
-    void load_new_tile_row(std::array<T, total_capacity> new_entries)
+    uint8_t shift_out()
     {
-        if (is_tracking_current_size)
-        {
-            current_size = total_capacity;
-        }
-        entries = new_entries;
+        if (current_size == 0)
+            std::cout << "Warning: attempted to shift out of an empty PISO shift register while tracking its size.\n";
+        else
+            current_size--;
+
+        const uint8_t colour_index = ((colour_high_plane >> 6) & 0b10) | (colour_low_plane >> 7);
+        colour_low_plane <<= 1;
+        colour_high_plane <<= 1;
+        return colour_index;
     }
 
-    T shift_out()
+    void clear()
     {
-        if (is_tracking_current_size)
-        {
-            if (current_size == 0)
-                std::cout << "Warning: attempted to shift out of an empty PISO shift register while tracking its size.\n";
-            else
-                current_size--;
-        }
-
-        T head = entries[0];
-        for (uint8_t i = 0; i < total_capacity - 1; i++)
-        {
-            entries[i] = entries[i + 1];
-        }
-        entries[total_capacity - 1] = T{};
-        return head;
+        colour_low_plane = colour_high_plane = 0;
+        current_size = 0;
     }
 
-    void clear()
+    bool is_empty() const
     {
-        if (is_tracking_current_size)
-        {
-            current_size = 0;
-        }
-        entries.fill(T{});
+        return current_size == 0;
     }
 
-    T& operator[](uint8_t index)
+private:
+    uint8_t colour_low_plane{};
+    uint8_t colour_high_plane{};
+    uint8_t current_size{};
+};
+
+class ObjectPixelShiftRegister
+{
+public:
+    // An object only takes the pixels that no earlier object has claimed with a non-zero colour
+    void merge_tile_row(uint8_t tile_row_low, uint8_t tile_row_high, uint8_t object_flags)
     {
-        return entries[index];
+        const uint8_t transparent_pixels_mask = ~(colour_low_plane | colour_high_plane);
+        colour_low_plane |= tile_row_low & transparent_pixels_mask;
+        colour_high_plane |= tile_row_high & transparent_pixels_mask;
+        palette_plane = (palette_plane & ~transparent_pixels_mask) | (((object_flags >> 4) & 1) ? transparent_pixels_mask : 0);
+        priority_plane = (priority_plane & ~transparent_pixels_mask) | (((object_flags >> 7) & 1) ? transparent_pixels_mask : 0);
     }
 
-    bool is_empty()
+    ObjectPixel shift_out()
     {
-        return is_tracking_current_size && current_size == 0;
+        const ObjectPixel head
+        {
+            static_cast<uint8_t>(((colour_high_plane >> 6) & 0b10) | (colour_low_plane >> 7)),
+            (palette_plane & 0x80) != 0,
+            (priority_plane & 0x80) != 0
+        };
+        colour_low_plane <<= 1;
+        colour_high_plane <<= 1;
+        palette_plane <<= 1;
+        priority_plane <<= 1;
+        return head;
+    }
+
+    void clear()
+    {
+        colour_low_plane = colour_high_plane = palette_plane = priority_plane = 0;
     }
 
 private:
-    bool is_tracking_current_size{};
-    uint8_t current_size{};
-    std::array<T, total_capacity> entries{};
+    uint8_t colour_low_plane{};
+    uint8_t colour_high_plane{};
+    uint8_t palette_plane{};
+    uint8_t priority_plane{};
 };
 
 class PixelProcessingUnit
@@ -185,12 +205,16 @@ public:
 
     bool is_oam_dma_in_progress{};
 
-    PixelProcessingUnit(std::function<void(uint8_t)> request_interrupt);
+    PixelProcessingUnit(InterruptRegisters& interrupt_registers_reference, EventScheduler& event_scheduler_reference);
 
     void reset_state();
     void set_post_boot_state();
+    void set_frame_skip_interval(uint8_t new_frame_skip_interval);
+    void set_scanline_render_ahead_enabled(bool is_enabled);
+    void register_input_output_registers(InputOutputRegisterMap& input_output_register_map);
 
     uint8_t get_published_frame_buffer_index_thread_safe() const;
+    uint64_t get_published_frame_count() const;
     std::unique_ptr<uint8_t[]>& get_pixel_frame_buffer(uint8_t index);
 
     uint8_t read_lcd_control_lcdc() const;
@@ -207,16 +231,28 @@ public:
     uint8_t read_byte_object_attribute_memory(uint16_t memory_address, bool is_access_unrestricted) const;
     void write_byte_object_attribute_memory(uint16_t memory_address, uint8_t value, bool is_access_unrestricted);
 
-    void step_single_machine_cycle();
+    void catch_up_to_machine_cycle(uint64_t machine_cycle);
+    void schedule_synchronization_on_next_machine_cycle();
+    void fall_back_to_pixel_fifo_for_scanline();
+    void catch_up_object_attribute_memory_scan();
 
 private:
-    std::function<void(uint8_t)> request_interrupt_callback;
+    InterruptRegisters& interrupt_registers;
+    EventScheduler& event_scheduler;
+    const PixelKernels& pixel_kernels;
+    uint64_t synchronized_machine_cycle{};
 
     std::atomic<uint8_t> published_frame_index_atomic{};
     uint8_t in_progress_frame_index{1};
+    uint64_t published_frame_count{};
     std::unique_ptr<uint8_t[]> pixel_frame_buffers[2];
 
+    uint8_t frame_skip_interval{1};
+    uint8_t consecutive_skipped_frame_count{};
+    bool is_frame_output_skipped{};
+
     std::unique_ptr<uint8_t[]> video_ram;
+    std::unique_ptr<uint8_t[]> decoded_tile_rows;
     std::unique_ptr<uint8_t[]> object_attribute_memory;
 
     uint8_t lcd_control_lcdc{};
@@ -230,7 +266,6 @@ private:
     uint16_t current_scanline_dot_number{};
     bool is_in_frame_after_lcd_enable{};
     bool is_in_first_scanline_after_lcd_enable{};
-    bool is_in_first_dot_of_current_step{true};
     bool is_window_enabled_for_scanline{};
 
     uint8_t stat_value_after_spurious_interrupt{};
@@ -240,8 +275,16 @@ private:
     bool did_scan_line_end_during_this_machine_cycle{};
     bool was_wy_condition_triggered_this_frame{};
 
-    std::vector<ObjectAttributes> scanline_selected_objects;
+    std::array<ObjectAttributes, MAX_OBJECTS_PER_LINE> scanline_selected_objects{};
+    uint8_t scanline_selected_object_count{};
+    uint8_t scanline_scanned_object_count{};
     uint8_t current_object_index{};
+
+    // One bit per object in OAM order for each scanline an object's top or bottom tile covers
+    std::array<uint64_t, DISPLAY_HEIGHT_PIXELS> scanline_top_tile_object_masks{};
+    std::array<uint64_t, DISPLAY_HEIGHT_PIXELS> scanline_bottom_tile_object_masks{};
+    std::array<uint8_t, NUMBER_OF_OBJECTS> object_indices_by_x_priority{};
+    std::array<uint8_t, NUMBER_OF_OBJECTS> object_x_priority_ranks{};
     
     uint8_t scanline_pixels_to_discard_from_dummy_fetch_count{8};
     int scanline_pixels_to_discard_from_scrolling_count{-1};
@@ -249,32 +292,60 @@ private:
     BackgroundPixelSliceFetcher background_fetcher{};
     PixelSliceFetcher object_fetcher{};
     
-    ParallelInSerialOutShiftRegister<BackgroundPixel, PIXELS_PER_TILE_ROW> background_pixel_shift_register{true};
-    ParallelInSerialOutShiftRegister<ObjectPixel, PIXELS_PER_TILE_ROW> object_pixel_shift_register{false};
+    BackgroundPixelShiftRegister background_pixel_shift_register{};
+    ObjectPixelShiftRegister object_pixel_shift_register{};
+
+    bool is_scanline_render_ahead_enabled{true};
+    bool is_scanline_rendered_ahead{};
+    uint16_t pixel_transfer_end_dot_number{};
+
+    template <uint8_t PixelProcessingUnit::*rendering_register>
+    void register_rendering_register(InputOutputRegisterMap& input_output_register_map, uint16_t address);
+
+    void step_single_machine_cycle();
+    void schedule_next_synchronization();
+    uint32_t get_machine_cycles_until_next_state_change() const;
 
     void step_object_attribute_memory_scan_single_dot();
+    void select_scanline_objects();
+    uint64_t get_scanline_object_candidate_mask() const;
+    ObjectAttributes get_object_attributes(uint8_t object_index) const;
+
+    void reset_object_attribute_memory_index();
+    void update_object_scanline_masks(uint8_t object_index, uint8_t y_position, bool does_object_cover_scanlines);
+    void update_object_x_priority(uint8_t object_index);
     void step_pixel_transfer_single_dot();
     void step_horizontal_blank_single_dot();
     void step_vertical_blank_single_dot();
     void trigger_stat_interrupts();
 
     void switch_to_mode(PixelProcessingUnitMode new_mode);
+    void reset_pixel_transfer_state();
+
+    bool try_render_scanline_ahead();
+    uint8_t get_pixel_with_palette_applied(uint8_t background_pixel_colour_index, const ObjectPixel& object_pixel) const;
 
     void step_fetchers_single_dot();
 
     void step_background_fetcher_single_dot();
     uint8_t get_background_fetcher_tile_id() const;
     uint8_t get_background_fetcher_tile_row_byte(uint8_t offset) const;
+    uint8_t get_tile_id(bool is_tile_map_area_bit_set, uint8_t tile_map_x, uint8_t tile_map_y) const;
+    uint16_t get_background_tile_row_local_address(uint8_t tile_index, uint8_t tile_row) const;
+    void decode_tile_row(uint16_t tile_row_local_address);
+    const uint8_t* get_decoded_tile_row(uint16_t tile_row_local_address, bool is_flipped_horizontally) const;
 
     void step_object_fetcher_single_dot();
+    void fetch_current_object_tile_index_and_flags();
     uint8_t get_object_fetcher_tile_row_byte(uint8_t offset);
+    uint16_t get_object_tile_row_local_address(const ObjectAttributes& object) const;
 
     void publish_new_frame();
+    void finish_frame();
 
     bool is_object_display_enabled() const;
     bool is_next_object_hit() const;
     ObjectAttributes& get_current_object();
-    uint8_t get_pixel_colour_id(PixelSliceFetcher pixel_slice_fetcher, uint8_t bit_position) const;
 };
 
 } // namespace GameBoyEmulator
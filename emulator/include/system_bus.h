@@ -0,0 +1,354 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+#include "event_scheduler.h"
+#include "interrupt_registers.h"
+#include "internal_timer.h"
+#include "memory_management_unit.h"
+#include "pixel_processing_unit.h"
+
+namespace GameBoyEmulator
+{
+
+// Out of the 16-bit address range so that no write can match it
+constexpr uint32_t NO_WATCHED_WRITE_ADDRESS = 0x10000;
+
+// Wires the central processing unit to the other components at compile time so each memory access and machine cycle step can be inlined
+class EmulatorSystemBus
+{
+public:
+    EmulatorSystemBus(
+        InterruptRegisters& interrupt_registers_reference,
+        InternalTimer& internal_timer_reference,
+        MemoryManagementUnit& memory_management_unit_reference,
+        PixelProcessingUnit& pixel_processing_unit_reference,
+        EventScheduler& event_scheduler_reference)
+        : interrupt_registers{interrupt_registers_reference},
+          internal_timer{internal_timer_reference},
+          memory_management_unit{memory_management_unit_reference},
+          pixel_processing_unit{pixel_processing_unit_reference},
+          event_scheduler{event_scheduler_reference}
+    {
+    }
+
+    // Neither the timer nor the pixel processing unit is stepped here, both only act at scheduled events or when the CPU accesses them
+    void step_single_machine_cycle()
+    {
+        event_scheduler.advance_machine_cycles(1);
+        handle_due_scheduled_events();
+    }
+
+    // Every interrupt is requested from a scheduled event, so the machine cycles between events are skipped
+    uint32_t step_machine_cycles_until_interrupt_pending(uint32_t max_machine_cycle_count)
+    {
+        uint32_t machine_cycles_stepped = 0;
+        do
+        {
+            const uint32_t machine_cycles_until_next_event = static_cast<uint32_t>(std::clamp<uint64_t>(
+                event_scheduler.get_machine_cycles_until_next_event(),
+                1,
+                max_machine_cycle_count - machine_cycles_stepped));
+            event_scheduler.advance_machine_cycles(machine_cycles_until_next_event);
+            handle_due_scheduled_events();
+            machine_cycles_stepped += machine_cycles_until_next_event;
+        } while (machine_cycles_stepped < max_machine_cycle_count && interrupt_registers.get_pending_interrupt_mask() == 0);
+        return machine_cycles_stepped;
+    }
+
+    // Only valid while no scheduled event comes due before the final machine cycle
+    void step_machine_cycles(uint32_t machine_cycle_count)
+    {
+        event_scheduler.advance_machine_cycles(machine_cycle_count);
+        handle_due_scheduled_events();
+    }
+
+    // The LCD registers and IF only change at scheduled events, since every pixel processing unit mode and scanline change has one.
+    // DIV and TIMA count up between events. Returns 0 for registers that may change on any machine cycle
+    uint64_t get_machine_cycles_until_register_may_change(uint16_t address) const
+    {
+        const uint64_t machine_cycles_until_next_event = event_scheduler.get_machine_cycles_until_next_event();
+        if (address == 0xFF04)
+            return std::min<uint64_t>(machine_cycles_until_next_event, internal_timer.get_machine_cycles_until_div_change());
+        if (address == 0xFF05)
+            return std::min(machine_cycles_until_next_event, internal_timer.get_machine_cycles_until_tima_change());
+        if (address == 0xFF0F || (address >= 0xFF40 && address <= 0xFF4B))
+            return machine_cycles_until_next_event;
+        return 0;
+    }
+
+    uint8_t read_byte(uint16_t address) const
+    {
+        if (is_pixel_processing_unit_synchronized_on_access(address))
+        {
+            pixel_processing_unit.catch_up_to_machine_cycle(event_scheduler.get_current_machine_cycle());
+        }
+        return memory_management_unit.read_byte(address, false);
+    }
+
+    uint8_t step_single_machine_cycle_and_read_byte(uint16_t address)
+    {
+        step_single_machine_cycle();
+        return read_byte(address);
+    }
+
+    // Runs the translated block at the address when it can not reach the next scheduled event or the machine cycle limit, since the
+    // machine cycles it takes are only advanced once it returns. Returns the machine cycles it took, or 0 when nothing was executed
+    uint32_t execute_translated_block(uint16_t address, RegisterFile<std::endian::native>& register_file, uint64_t machine_cycles_until_limit)
+    {
+        if (watched_write_address != NO_WATCHED_WRITE_ADDRESS)
+            return 0;
+
+        const TranslatedBlock* translated_block = memory_management_unit.get_translated_block(address);
+        if (translated_block == nullptr)
+            return 0;
+
+        const uint32_t machine_cycle_budget = static_cast<uint32_t>(std::min<uint64_t>(
+            {event_scheduler.get_machine_cycles_until_next_event(), machine_cycles_until_limit, UINT32_MAX}));
+        if (translated_block->max_machine_cycles > machine_cycle_budget)
+            return 0;
+
+        const uint32_t machine_cycles_executed = memory_management_unit.execute_translated_block(*translated_block, register_file, machine_cycle_budget);
+        if (machine_cycles_executed > 0)
+        {
+            // The final machine cycle is stepped by the fetch of the next instruction
+            event_scheduler.advance_machine_cycles(machine_cycles_executed - 1);
+        }
+        return machine_cycles_executed;
+    }
+
+    void step_single_machine_cycle_and_write_byte(uint16_t address, uint8_t value)
+    {
+        step_single_machine_cycle();
+        if (is_pixel_processing_unit_synchronized_on_access(address))
+        {
+            pixel_processing_unit.catch_up_to_machine_cycle(event_scheduler.get_current_machine_cycle());
+            memory_management_unit.write_byte(address, value, false);
+            if (does_write_affect_pixel_processing_unit_timing(address))
+            {
+                pixel_processing_unit.schedule_synchronization_on_next_machine_cycle();
+            }
+        }
+        else
+        {
+            memory_management_unit.write_byte(address, value, false);
+        }
+        if (address == watched_write_address)
+        {
+            was_watched_address_written = true;
+        }
+    }
+
+    bool is_instruction_fetch_redirected_by_oam_dma() const
+    {
+        return pixel_processing_unit.is_oam_dma_in_progress;
+    }
+
+    uint64_t get_elapsed_machine_cycles() const
+    {
+        return event_scheduler.get_current_machine_cycle();
+    }
+
+    uint64_t get_published_frame_count() const
+    {
+        return pixel_processing_unit.get_published_frame_count();
+    }
+
+    void watch_write_address(std::optional<uint16_t> address)
+    {
+        watched_write_address = address.has_value() ? *address : NO_WATCHED_WRITE_ADDRESS;
+        was_watched_address_written = false;
+    }
+
+    bool was_watched_write_address_written() const
+    {
+        return was_watched_address_written;
+    }
+
+    uint8_t get_pending_interrupt_mask() const
+    {
+        return interrupt_registers.get_pending_interrupt_mask();
+    }
+
+    void clear_interrupt_flag_bit(uint8_t interrupt_flag_mask)
+    {
+        interrupt_registers.clear_interrupt_flag_bit(interrupt_flag_mask);
+    }
+
+private:
+    // Video RAM, object attribute memory, the LCD registers and the interrupt flag register the pixel processing unit requests interrupts in
+    static bool is_pixel_processing_unit_synchronized_on_access(uint16_t address)
+    {
+        return (address >= VIDEO_RAM_START && address < VIDEO_RAM_START + VIDEO_RAM_SIZE) ||
+               (address >= OBJECT_ATTRIBUTE_MEMORY_START && address < UNUSABLE_MEMORY_START) ||
+               (address >= 0xFF40 && address <= 0xFF4B) ||
+               address == 0xFF0F;
+    }
+
+    // LCDC, STAT, LY and LYC writes can change the mode or the LY=LYC comparison, so the next state change may come sooner than scheduled
+    static bool does_write_affect_pixel_processing_unit_timing(uint16_t address)
+    {
+        return address >= 0xFF40 && address <= 0xFF45;
+    }
+
+    // OAM DMA acts before the pixel processing unit within a machine cycle, so the pixel processing unit is only caught up to the previous one
+    void handle_due_scheduled_events()
+    {
+        while (event_scheduler.is_event_due())
+        {
+            switch (event_scheduler.pop_due_event())
+            {
+                case ScheduledEventType::TimerCounterReload:
+                    internal_timer.reload_tima_after_overflow();
+                    break;
+                case ScheduledEventType::ObjectAttributeMemoryDirectMemoryAccessTransfer:
+                    pixel_processing_unit.catch_up_to_machine_cycle(event_scheduler.get_current_machine_cycle() - 1);
+                    memory_management_unit.transfer_oam_dma_byte();
+                    break;
+                case ScheduledEventType::ObjectAttributeMemoryDirectMemoryAccessStartup:
+                    pixel_processing_unit.catch_up_to_machine_cycle(event_scheduler.get_current_machine_cycle() - 1);
+                    memory_management_unit.start_oam_dma();
+                    break;
+                case ScheduledEventType::PixelProcessingUnitSynchronization:
+                    pixel_processing_unit.catch_up_to_machine_cycle(event_scheduler.get_current_machine_cycle());
+                    break;
+            }
+        }
+    }
+
+    InterruptRegisters& interrupt_registers;
+    InternalTimer& internal_timer;
+    MemoryManagementUnit& memory_management_unit;
+    PixelProcessingUnit& pixel_processing_unit;
+    EventScheduler& event_scheduler;
+
+    uint32_t watched_write_address{NO_WATCHED_WRITE_ADDRESS};
+    bool was_watched_address_written{};
+};
+
+// Hands every machine cycle and memory access to runtime callbacks so test harnesses can drive and observe the central processing unit in isolation
+class CallbackSystemBus
+{
+public:
+    CallbackSystemBus(
+        std::function<void()> step_single_machine_cycle,
+        std::function<uint8_t(uint16_t)> step_single_machine_cycle_and_read_byte,
+        std::function<void(uint16_t, uint8_t)> step_single_machine_cycle_and_write_byte,
+        std::function<uint8_t(uint16_t)> read_byte,
+        InterruptRegisters& interrupt_registers_reference)
+        : step_single_machine_cycle_callback{step_single_machine_cycle},
+          step_single_machine_cycle_and_read_byte_callback{step_single_machine_cycle_and_read_byte},
+          step_single_machine_cycle_and_write_byte_callback{step_single_machine_cycle_and_write_byte},
+          read_byte_callback{read_byte},
+          interrupt_registers{interrupt_registers_reference}
+    {
+    }
+
+    void step_single_machine_cycle()
+    {
+        step_single_machine_cycle_callback();
+        elapsed_machine_cycles++;
+    }
+
+    // Interrupts can be requested from any callback, so only one machine cycle is stepped between checks
+    uint32_t step_machine_cycles_until_interrupt_pending([[maybe_unused]] uint32_t max_machine_cycle_count)
+    {
+        step_single_machine_cycle();
+        return 1;
+    }
+
+    void step_machine_cycles(uint32_t machine_cycle_count)
+    {
+        for (uint32_t machine_cycle = 0; machine_cycle < machine_cycle_count; machine_cycle++)
+        {
+            step_single_machine_cycle();
+        }
+    }
+
+    // The callbacks may change any register on any machine cycle
+    uint64_t get_machine_cycles_until_register_may_change(uint16_t) const
+    {
+        return 0;
+    }
+
+    uint8_t read_byte(uint16_t address) const
+    {
+        return read_byte_callback(address);
+    }
+
+    uint8_t step_single_machine_cycle_and_read_byte(uint16_t address)
+    {
+        elapsed_machine_cycles++;
+        return step_single_machine_cycle_and_read_byte_callback(address);
+    }
+
+    // The callbacks may serve any byte on any machine cycle, so nothing is ever translated
+    uint32_t execute_translated_block(uint16_t, RegisterFile<std::endian::native>&, uint64_t)
+    {
+        return 0;
+    }
+
+    void step_single_machine_cycle_and_write_byte(uint16_t address, uint8_t value)
+    {
+        elapsed_machine_cycles++;
+        step_single_machine_cycle_and_write_byte_callback(address, value);
+        if (address == watched_write_address)
+        {
+            was_watched_address_written = true;
+        }
+    }
+
+    // The callbacks may serve any byte on any machine cycle, so fetches can never be assumed to return the bytes in memory
+    bool is_instruction_fetch_redirected_by_oam_dma() const
+    {
+        return true;
+    }
+
+    uint8_t get_pending_interrupt_mask() const
+    {
+        return interrupt_registers.get_pending_interrupt_mask();
+    }
+
+    void clear_interrupt_flag_bit(uint8_t interrupt_flag_mask)
+    {
+        interrupt_registers.clear_interrupt_flag_bit(interrupt_flag_mask);
+    }
+
+    uint64_t get_elapsed_machine_cycles() const
+    {
+        return elapsed_machine_cycles;
+    }
+
+    // There is no pixel processing unit behind the callbacks
+    uint64_t get_published_frame_count() const
+    {
+        return 0;
+    }
+
+    void watch_write_address(std::optional<uint16_t> address)
+    {
+        watched_write_address = address.has_value() ? *address : NO_WATCHED_WRITE_ADDRESS;
+        was_watched_address_written = false;
+    }
+
+    bool was_watched_write_address_written() const
+    {
+        return was_watched_address_written;
+    }
+
+private:
+    std::function<void()> step_single_machine_cycle_callback;
+    std::function<uint8_t(uint16_t)> step_single_machine_cycle_and_read_byte_callback;
+    std::function<void(uint16_t, uint8_t)> step_single_machine_cycle_and_write_byte_callback;
+    std::function<uint8_t(uint16_t)> read_byte_callback;
+    InterruptRegisters& interrupt_registers;
+
+    uint64_t elapsed_machine_cycles{};
+    uint32_t watched_write_address{NO_WATCHED_WRITE_ADDRESS};
+    bool was_watched_address_written{};
+};
+
+} // namespace GameBoyEmulator
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <bit>
+#include <set>
+
+#include "cartridge_save_file.h"
+#include "console_output_utilities.h"
+#include "memory_bank_controllers.h"
+
+namespace GameBoyEmulator
+{
+
+// Two instances mapping the same .sav file would overwrite each other's RAM, so each file is only opened once per process
+static std::mutex open_save_file_paths_mutex;
+static std::set<std::string> open_save_file_paths;
+
+std::unique_ptr<CartridgeSaveFile> CartridgeSaveFile::try_open(
+    const std::filesystem::path& save_file_path,
+    uint32_t ram_size,
+    uint8_t initial_ram_value,
+    bool has_real_time_clock,
+    std::string& error_message)
+{
+    std::error_code error_code;
+    std::filesystem::path canonical_save_file_path = std::filesystem::weakly_canonical(save_file_path, error_code);
+    if (error_code)
+    {
+        canonical_save_file_path = save_file_path;
+    }
+
+    std::lock_guard<std::mutex> open_save_file_paths_lock{open_save_file_paths_mutex};
+    if (open_save_file_paths.contains(canonical_save_file_path.string()))
+    {
+        set_error_message_and_fail(std::string("Save file ") + save_file_path.string() + " is already in use by another instance.", error_message);
+        return nullptr;
+    }
+
+    const size_t save_file_size = ram_size + (has_real_time_clock ? REAL_TIME_CLOCK_SAVE_DATA_SIZE : 0);
+    size_t previous_save_file_size = 0;
+    std::unique_ptr<MemoryMappedFile> memory_mapped_file =
+        MemoryMappedFile::try_map_read_write(canonical_save_file_path, save_file_size, previous_save_file_size, error_message);
+    if (memory_mapped_file == nullptr)
+    {
+        return nullptr;
+    }
+
+    // RAM the file did not cover yet starts out the way the cartridge would power on
+    if (previous_save_file_size < ram_size)
+    {
+        std::fill(memory_mapped_file->data() + previous_save_file_size, memory_mapped_file->data() + ram_size, initial_ram_value);
+    }
+    open_save_file_paths.insert(canonical_save_file_path.string());
+    return std::unique_ptr<CartridgeSaveFile>{new CartridgeSaveFile{canonical_save_file_path, std::move(memory_mapped_file), ram_size}};
+}
+
+CartridgeSaveFile::CartridgeSaveFile(const std::filesystem::path& save_file_path, std::unique_ptr<MemoryMappedFile> mapped_file, uint32_t save_file_ram_size)
+    : save_file_path_key{save_file_path.string()},
+      memory_mapped_file{std::move(mapped_file)},
+      ram_size{save_file_ram_size}
+{
+    flush_thread = std::jthread{[this](std::stop_token stop_token)
+    {
+        std::unique_lock<std::mutex> flush_lock{flush_mutex};
+        while (!stop_token.stop_requested())
+        {
+            flush_condition.wait_for(flush_lock, stop_token, CARTRIDGE_SAVE_FILE_FLUSH_INTERVAL, [] { return false; });
+            flush_dirty_save_data();
+        }
+    }};
+}
+
+CartridgeSaveFile::~CartridgeSaveFile()
+{
+    flush_thread.request_stop();
+    flush_thread.join();
+    flush_dirty_save_data();
+
+    std::lock_guard<std::mutex> open_save_file_paths_lock{open_save_file_paths_mutex};
+    open_save_file_paths.erase(save_file_path_key);
+}
+
+void CartridgeSaveFile::flush_dirty_save_data()
+{
+    uint32_t dirty_save_data = dirty_save_data_mask.exchange(0, std::memory_order_acquire);
+
+    if ((dirty_save_data & REAL_TIME_CLOCK_SAVE_DATA_DIRTY_MASK) != 0)
+    {
+        memory_mapped_file->flush(ram_size, memory_mapped_file->size() - ram_size);
+        dirty_save_data &= ~REAL_TIME_CLOCK_SAVE_DATA_DIRTY_MASK;
+    }
+
+    while (dirty_save_data != 0)
+    {
+        const uint32_t ram_bank_number = std::countr_zero(dirty_save_data);
+        const uint32_t ram_bank_offset = ram_bank_number << RAM_BANK_SIZE_POWER_OF_TWO;
+        memory_mapped_file->flush(ram_bank_offset, std::min<uint32_t>(RAM_BANK_SIZE, ram_size - ram_bank_offset));
+        dirty_save_data &= dirty_save_data - 1;
+    }
+}
+
+} // namespace GameBoyEmulator
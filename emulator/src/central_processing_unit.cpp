@@ -1,36 +1,74 @@
+#include <algorithm>
+#include <array>
 #include <bit>
 #include <iomanip>
 #include <iostream>
+#include <optional>
+#include <utility>
 
 #include "central_processing_unit.h"
 #include "bitwise_utilities.h"
+#include "system_bus.h"
 
 namespace GameBoyEmulator
 {
 
-CentralProcessingUnit::CentralProcessingUnit(
-    std::function<void()> emulator_step_single_machine_cycle,
-    MemoryManagementUnit& memory_management_unit_reference)
-    : emulator_step_single_machine_cycle_callback{emulator_step_single_machine_cycle},
-      memory_management_unit{memory_management_unit_reference}
+#if defined(GAME_BOY_EMULATOR_LAZY_FLAGS)
+constexpr bool IS_LAZY_FLAG_EVALUATION_ENABLED = true;
+#else
+constexpr bool IS_LAZY_FLAG_EVALUATION_ENABLED = false;
+#endif
+
+#if defined(GAME_BOY_EMULATOR_DYNAMIC_RECOMPILER)
+constexpr bool IS_DYNAMIC_RECOMPILATION_ENABLED = true;
+#else
+constexpr bool IS_DYNAMIC_RECOMPILATION_ENABLED = false;
+#endif
+
+static constexpr bool does_unprefixed_opcode_ignore_flags(uint8_t opcode)
+{
+    return opcode == 0x00 || opcode == 0x08 || opcode == 0x10 || opcode == 0x18 ||
+           (opcode & 0b11001111) == 0x01 || (opcode & 0b11001111) == 0x02 || (opcode & 0b11001111) == 0x03 ||
+           (opcode & 0b11001111) == 0x0A || (opcode & 0b11001111) == 0x0B || (opcode & 0b11000111) == 0x06 ||
+           (opcode >= 0x40 && opcode <= 0x7F) ||
+           opcode == 0xC1 || opcode == 0xD1 || opcode == 0xE1 || opcode == 0xC5 || opcode == 0xD5 || opcode == 0xE5 ||
+           opcode == 0xC3 || opcode == 0xC9 || opcode == 0xCD || opcode == 0xD9 || (opcode & 0b11000111) == 0xC7 ||
+           opcode == 0xE0 || opcode == 0xE2 || opcode == 0xE9 || opcode == 0xEA ||
+           opcode == 0xF0 || opcode == 0xF2 || opcode == 0xF3 || opcode == 0xF9 || opcode == 0xFA || opcode == 0xFB;
+}
+
+// 8-bit arithmetic and logic operations on A overwrite every flag, so their flags are deferred until something reads them
+static constexpr bool does_unprefixed_opcode_defer_flags(uint8_t opcode)
+{
+    return (opcode & 0b11000000) == 0x80 || (opcode & 0b11000111) == 0xC6;
+}
+
+template <typename SystemBus>
+CentralProcessingUnit<SystemBus>::CentralProcessingUnit(SystemBus system_bus_instance)
+    : system_bus{system_bus_instance}
 {
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
 }
 
-void CentralProcessingUnit::reset_state(bool should_add_startup_machine_cycle)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::reset_state(bool should_add_startup_machine_cycle)
 {
     if (should_add_startup_machine_cycle)
     {
-        emulator_step_single_machine_cycle_callback();
+        system_bus.step_single_machine_cycle();
     }
     set_register_file_state(RegisterFile<std::endian::native>{});
     interrupt_master_enable_ime = InterruptMasterEnableState::Disabled;
     instruction_register_ir = 0x00;
     is_current_instruction_prefixed = false;
     is_halted = false;
+    fast_forwarded_halted_machine_cycles = 0;
+    skipped_idle_loop_machine_cycles = 0;
+    translated_block_machine_cycles = 0;
 }
 
-void CentralProcessingUnit::set_post_boot_state()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::set_post_boot_state()
 {
     reset_state(false);
     register_file.A = 0x01;
@@ -39,7 +77,7 @@ void CentralProcessingUnit::set_post_boot_state()
     uint8_t header_checksum = 0;
     for (uint16_t address = CARTRIDGE_HEADER_START; address <= CARTRIDGE_HEADER_END; address++)
     {
-        header_checksum -= memory_management_unit.read_byte(BOOTROM_SIZE + address, false) - 1;
+        header_checksum -= system_bus.read_byte(BOOTROM_SIZE + address) - 1;
     }
     update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, header_checksum != 0);
     update_flag(register_file.flags, CARRY_FLAG_MASK, header_checksum != 0);
@@ -53,15 +91,20 @@ void CentralProcessingUnit::set_post_boot_state()
     register_file.stack_pointer = 0xFFFE;
 }
 
-RegisterFile<std::endian::native> CentralProcessingUnit::get_register_file() const
+template <typename SystemBus>
+RegisterFile<std::endian::native> CentralProcessingUnit<SystemBus>::get_register_file() const
 {
-    return register_file;
+    RegisterFile<std::endian::native> register_file_with_materialized_flags = register_file;
+    register_file_with_materialized_flags.flags = get_materialized_flags();
+    return register_file_with_materialized_flags;
 }
 
-void CentralProcessingUnit::set_register_file_state(const RegisterFile<std::endian::native>& new_register_values)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::set_register_file_state(const RegisterFile<std::endian::native>& new_register_values)
 {
     register_file.A = new_register_values.A;
     register_file.flags = new_register_values.flags & 0xF0; // Lower nibble of flags must always be zeroed
+    deferred_flags.operation = DeferredFlagsOperation::None;
     register_file.BC = new_register_values.BC;
     register_file.DE = new_register_values.DE;
     register_file.HL = new_register_values.HL;
@@ -69,29 +112,73 @@ void CentralProcessingUnit::set_register_file_state(const RegisterFile<std::endi
     register_file.stack_pointer = new_register_values.stack_pointer;
 }
 
-void CentralProcessingUnit::step_single_instruction()
+template <typename SystemBus>
+uint64_t CentralProcessingUnit<SystemBus>::get_elapsed_machine_cycles() const
+{
+    return system_bus.get_elapsed_machine_cycles();
+}
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::set_halt_fast_forward_enabled(bool is_enabled)
+{
+    is_halt_fast_forward_enabled = is_enabled;
+}
+
+template <typename SystemBus>
+uint64_t CentralProcessingUnit<SystemBus>::get_fast_forwarded_halted_machine_cycles() const
+{
+    return fast_forwarded_halted_machine_cycles;
+}
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::set_idle_loop_skip_enabled(bool is_enabled)
+{
+    is_idle_loop_skip_enabled = is_enabled;
+}
+
+template <typename SystemBus>
+uint64_t CentralProcessingUnit<SystemBus>::get_skipped_idle_loop_machine_cycles() const
+{
+    return skipped_idle_loop_machine_cycles;
+}
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::set_dynamic_recompilation_enabled(bool is_enabled)
+{
+    is_dynamic_recompilation_enabled = is_enabled;
+}
+
+template <typename SystemBus>
+uint64_t CentralProcessingUnit<SystemBus>::get_translated_block_machine_cycles() const
+{
+    return translated_block_machine_cycles;
+}
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::step_single_instruction()
 {
     if (is_halted)
-        emulator_step_single_machine_cycle_callback();
-    else
+        step_halted_machine_cycles();
+    else if (!try_skip_idle_loop() && !try_execute_translated_block())
     {
-        if (is_current_instruction_prefixed)
-        {
-            decode_current_prefixed_opcode_and_execute();
-        }
-        else
-        {
-            decode_current_unprefixed_opcode_and_execute();
-        }
+        const uint16_t handler_index = (is_current_instruction_prefixed ? NUMBER_OF_OPCODES : 0) + instruction_register_ir;
+        (this->*INSTRUCTION_HANDLERS[handler_index])();
         fetch_next_instruction();
     }
+    service_interrupt_and_update_interrupt_master_enable();
+}
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::service_interrupt_and_update_interrupt_master_enable()
+{
     service_interrupt();
 
     if (interrupt_master_enable_ime == InterruptMasterEnableState::WillEnable)
         interrupt_master_enable_ime = InterruptMasterEnableState::Enabled;
 }
 
-void CentralProcessingUnit::fetch_next_instruction()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::fetch_next_instruction()
 {
     const uint8_t immediate8 = fetch_immediate8_and_step_emulator_components();
     is_current_instruction_prefixed = (immediate8 == INSTRUCTION_PREFIX_BYTE);
@@ -99,7 +186,7 @@ void CentralProcessingUnit::fetch_next_instruction()
     // Produces the halt bug
     if (is_halted)
     {
-        const bool is_interrupt_pending = (memory_management_unit.get_pending_interrupt_mask() != 0);
+        const bool is_interrupt_pending = (system_bus.get_pending_interrupt_mask() != 0);
 
         if (is_interrupt_pending && interrupt_master_enable_ime != InterruptMasterEnableState::Enabled)
         {
@@ -112,9 +199,251 @@ void CentralProcessingUnit::fetch_next_instruction()
         : immediate8;
 }
 
-void CentralProcessingUnit::service_interrupt()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::step_halted_machine_cycles()
 {
-    bool is_interrupt_pending = (memory_management_unit.get_pending_interrupt_mask() != 0);
+    // IME must finish enabling on the first halted machine cycle so a pending interrupt is serviced rather than only ending the halt
+    if (!is_halt_fast_forward_enabled || interrupt_master_enable_ime == InterruptMasterEnableState::WillEnable)
+    {
+        system_bus.step_single_machine_cycle();
+        return;
+    }
+    // Every halted machine cycle is an instruction boundary, so the fast-forward stops exactly at the machine cycle limit
+    const uint32_t max_machine_cycle_count = static_cast<uint32_t>(std::clamp<uint64_t>(get_machine_cycles_until_limit(), 1, MAX_HALTED_MACHINE_CYCLES_PER_STEP));
+    fast_forwarded_halted_machine_cycles += system_bus.step_machine_cycles_until_interrupt_pending(max_machine_cycle_count);
+}
+
+// Recognizes polling loops of the form LDH A,(a8); up to two of AND/XOR/OR/CP d8; JR cc back to the LDH.
+// They only touch A and the flags, so iterations that read an unchanged value are skipped in one bus step, and the iteration
+// where the value may change is run without instruction fetch and dispatch while stepping the machine cycles and reading the
+// polled register exactly as the interpreter would, stopping at the first instruction boundary where anything else can happen
+template <typename SystemBus>
+bool CentralProcessingUnit<SystemBus>::try_skip_idle_loop()
+{
+    const bool can_skip_idle_loop = is_idle_loop_skip_enabled &&
+                                    instruction_register_ir == LOAD_A_FROM_INPUT_OUTPUT_REGISTER_OPCODE &&
+                                    !is_current_instruction_prefixed &&
+                                    !are_instruction_boundaries_observed &&
+                                    interrupt_master_enable_ime != InterruptMasterEnableState::WillEnable &&
+                                    !system_bus.is_instruction_fetch_redirected_by_oam_dma();
+    if (!can_skip_idle_loop)
+        return false;
+
+    const uint16_t loop_start_address = register_file.program_counter - 1;
+    const uint8_t polled_address_low_byte = system_bus.read_byte(register_file.program_counter);
+
+    std::array<uint8_t, MAX_IDLE_LOOP_ARITHMETIC_LOGIC_OPERATIONS> arithmetic_logic_opcodes{};
+    std::array<uint8_t, MAX_IDLE_LOOP_ARITHMETIC_LOGIC_OPERATIONS> arithmetic_logic_operands{};
+    uint8_t arithmetic_logic_operation_count = 0;
+    uint16_t jump_address = loop_start_address + 2;
+
+    while (arithmetic_logic_operation_count < MAX_IDLE_LOOP_ARITHMETIC_LOGIC_OPERATIONS)
+    {
+        const uint8_t opcode = system_bus.read_byte(jump_address);
+        const bool is_idle_loop_arithmetic_logic_opcode = opcode == 0xE6 || opcode == 0xEE || opcode == 0xF6 || opcode == 0xFE;
+        if (!is_idle_loop_arithmetic_logic_opcode)
+            break;
+
+        arithmetic_logic_opcodes[arithmetic_logic_operation_count] = opcode;
+        arithmetic_logic_operands[arithmetic_logic_operation_count] = system_bus.read_byte(jump_address + 1);
+        arithmetic_logic_operation_count++;
+        jump_address += 2;
+    }
+
+    const uint8_t jump_opcode = system_bus.read_byte(jump_address);
+    const int8_t jump_offset = static_cast<int8_t>(system_bus.read_byte(jump_address + 1));
+    const bool is_idle_loop = arithmetic_logic_operation_count > 0 &&
+                              (jump_opcode & 0b11100111) == 0x20 &&
+                              static_cast<uint16_t>(jump_address + 2 + jump_offset) == loop_start_address;
+    if (!is_idle_loop)
+        return false;
+
+    // Stops at the first instruction boundary the interpreter would have stopped at for the machine cycle limit
+    const uint32_t max_machine_cycles = static_cast<uint32_t>(std::clamp<uint64_t>(get_machine_cycles_until_limit(), 1, MAX_IDLE_LOOP_MACHINE_CYCLES_PER_STEP));
+    uint32_t machine_cycles_stepped = 0;
+    const auto should_stop_at_instruction_boundary = [&]()
+    {
+        return is_interrupt_serviceable() || machine_cycles_stepped >= max_machine_cycles;
+    };
+
+    while (true)
+    {
+        machine_cycles_stepped += skip_idle_loop_iterations_while_polled_register_is_unchanged(
+            INPUT_OUTPUT_REGISTERS_START + polled_address_low_byte,
+            arithmetic_logic_opcodes,
+            arithmetic_logic_operands,
+            arithmetic_logic_operation_count,
+            jump_opcode,
+            max_machine_cycles - std::min(machine_cycles_stepped, max_machine_cycles));
+        if (should_stop_at_instruction_boundary() || system_bus.is_instruction_fetch_redirected_by_oam_dma())
+            break;
+
+        system_bus.step_single_machine_cycle();
+        register_file.A = system_bus.step_single_machine_cycle_and_read_byte(INPUT_OUTPUT_REGISTERS_START + polled_address_low_byte);
+        system_bus.step_single_machine_cycle();
+        register_file.program_counter = loop_start_address + 3;
+        instruction_register_ir = arithmetic_logic_opcodes[0];
+        machine_cycles_stepped += 3;
+        if (should_stop_at_instruction_boundary())
+            break;
+
+        for (uint8_t operation_index = 0; operation_index < arithmetic_logic_operation_count; operation_index++)
+        {
+            system_bus.step_single_machine_cycle();
+            execute_idle_loop_arithmetic_logic_operation(arithmetic_logic_opcodes[operation_index], arithmetic_logic_operands[operation_index]);
+            system_bus.step_single_machine_cycle();
+            register_file.program_counter += 2;
+            instruction_register_ir = (operation_index + 1 < arithmetic_logic_operation_count)
+                ? arithmetic_logic_opcodes[operation_index + 1]
+                : jump_opcode;
+            machine_cycles_stepped += 2;
+            if (should_stop_at_instruction_boundary())
+                break;
+        }
+        if (instruction_register_ir != jump_opcode || should_stop_at_instruction_boundary())
+            break;
+
+        system_bus.step_single_machine_cycle();
+        if (!is_jump_condition_met(jump_opcode))
+        {
+            register_file.program_counter = jump_address + 2;
+            fetch_next_instruction();
+            machine_cycles_stepped += is_current_instruction_prefixed ? 3 : 2;
+            break;
+        }
+        system_bus.step_single_machine_cycle();
+        system_bus.step_single_machine_cycle();
+        register_file.program_counter = loop_start_address + 1;
+        instruction_register_ir = LOAD_A_FROM_INPUT_OUTPUT_REGISTER_OPCODE;
+        machine_cycles_stepped += 3;
+        if (should_stop_at_instruction_boundary())
+            break;
+    }
+    skipped_idle_loop_machine_cycles += machine_cycles_stepped;
+    return true;
+}
+
+// A translated block runs as a single step, so it is only entered where no stop condition needs to see the boundaries inside it
+// and no interrupt can be serviced at one of them. An interrupt left pending by EI is serviced after the next instruction
+template <typename SystemBus>
+bool CentralProcessingUnit<SystemBus>::try_execute_translated_block()
+{
+    if constexpr (!IS_DYNAMIC_RECOMPILATION_ENABLED)
+        return false;
+
+    const bool can_execute_translated_block = is_dynamic_recompilation_enabled &&
+                                              !is_current_instruction_prefixed &&
+                                              !are_instruction_boundaries_observed &&
+                                              interrupt_master_enable_ime != InterruptMasterEnableState::WillEnable &&
+                                              !is_interrupt_serviceable() &&
+                                              !system_bus.is_instruction_fetch_redirected_by_oam_dma();
+    if (!can_execute_translated_block)
+        return false;
+
+    if constexpr (IS_LAZY_FLAG_EVALUATION_ENABLED)
+        materialize_flags();
+
+    const uint16_t block_start_address = register_file.program_counter - 1;
+    const uint64_t machine_cycles_until_limit = std::min<uint64_t>(get_machine_cycles_until_limit(), MAX_TRANSLATED_BLOCK_MACHINE_CYCLES_PER_STEP);
+    const uint32_t machine_cycles_executed = system_bus.execute_translated_block(block_start_address, register_file, machine_cycles_until_limit);
+    if (machine_cycles_executed == 0)
+    {
+        register_file.program_counter = block_start_address + 1;
+        return false;
+    }
+    fetch_next_instruction();
+    translated_block_machine_cycles += machine_cycles_executed;
+    return true;
+}
+
+// Every iteration that reads the same value as the previous one leaves the same A and flags and jumps back, so the iterations
+// that end before the polled register or anything else on the bus can change are stepped at once. Returns the machine cycles stepped
+template <typename SystemBus>
+uint32_t CentralProcessingUnit<SystemBus>::skip_idle_loop_iterations_while_polled_register_is_unchanged(
+    uint16_t polled_address,
+    const std::array<uint8_t, MAX_IDLE_LOOP_ARITHMETIC_LOGIC_OPERATIONS>& arithmetic_logic_opcodes,
+    const std::array<uint8_t, MAX_IDLE_LOOP_ARITHMETIC_LOGIC_OPERATIONS>& arithmetic_logic_operands,
+    uint8_t arithmetic_logic_operation_count,
+    uint8_t jump_opcode,
+    uint32_t max_machine_cycles)
+{
+    // LDH and the taken JR take 3 machine cycles each, every AND/XOR/OR/CP d8 takes 2
+    const uint32_t iteration_machine_cycles = 6 + 2 * arithmetic_logic_operation_count;
+    const uint64_t machine_cycles_until_change = std::min<uint64_t>(
+        system_bus.get_machine_cycles_until_register_may_change(polled_address),
+        max_machine_cycles);
+    const uint32_t iteration_count = static_cast<uint32_t>(machine_cycles_until_change / iteration_machine_cycles);
+    if (iteration_count == 0)
+        return 0;
+
+    const uint8_t previous_a = register_file.A;
+    const uint8_t previous_flags = register_file.flags;
+    const DeferredFlags previous_deferred_flags = deferred_flags;
+    register_file.A = system_bus.read_byte(polled_address);
+    for (uint8_t operation_index = 0; operation_index < arithmetic_logic_operation_count; operation_index++)
+    {
+        execute_idle_loop_arithmetic_logic_operation(arithmetic_logic_opcodes[operation_index], arithmetic_logic_operands[operation_index]);
+    }
+    if (!is_jump_condition_met(jump_opcode))
+    {
+        register_file.A = previous_a;
+        register_file.flags = previous_flags;
+        deferred_flags = previous_deferred_flags;
+        return 0;
+    }
+
+    const uint32_t machine_cycles_stepped = iteration_count * iteration_machine_cycles;
+    system_bus.step_machine_cycles(machine_cycles_stepped);
+    return machine_cycles_stepped;
+}
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::execute_idle_loop_arithmetic_logic_operation(uint8_t opcode, uint8_t value)
+{
+    switch (opcode)
+    {
+        case 0xE6:
+            and_a(value);
+            break;
+        case 0xEE:
+            xor_a(value);
+            break;
+        case 0xF6:
+            or_a(value);
+            break;
+        default:
+            compare_a(value);
+            break;
+    }
+}
+
+template <typename SystemBus>
+bool CentralProcessingUnit<SystemBus>::is_jump_condition_met(uint8_t opcode)
+{
+    materialize_flags();
+    switch ((opcode >> 3) & 0b11)
+    {
+        case 0:
+            return is_condition_met<0>();
+        case 1:
+            return is_condition_met<1>();
+        case 2:
+            return is_condition_met<2>();
+        default:
+            return is_condition_met<3>();
+    }
+}
+
+template <typename SystemBus>
+bool CentralProcessingUnit<SystemBus>::is_interrupt_serviceable() const
+{
+    return interrupt_master_enable_ime == InterruptMasterEnableState::Enabled && system_bus.get_pending_interrupt_mask() != 0;
+}
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::service_interrupt()
+{
+    bool is_interrupt_pending = (system_bus.get_pending_interrupt_mask() != 0);
     if (is_interrupt_pending && is_halted)
     {
         is_halted = false;
@@ -122,14 +451,14 @@ void CentralProcessingUnit::service_interrupt()
     if (interrupt_master_enable_ime != InterruptMasterEnableState::Enabled || !is_interrupt_pending)
         return;
 
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
     register_file.program_counter -= is_current_instruction_prefixed ? 2 : 1;
     decrement_and_step_emulator_components(register_file.stack_pointer);
     write_byte_and_step_emulator_components(register_file.stack_pointer--, register_file.program_counter >> 8);
-    uint8_t interrupt_flag_mask = memory_management_unit.get_pending_interrupt_mask();
+    uint8_t interrupt_flag_mask = system_bus.get_pending_interrupt_mask();
     write_byte_and_step_emulator_components(register_file.stack_pointer, register_file.program_counter & 0xFF);
 
-    memory_management_unit.clear_interrupt_flag_bit(interrupt_flag_mask);
+    system_bus.clear_interrupt_flag_bit(interrupt_flag_mask);
     interrupt_master_enable_ime = InterruptMasterEnableState::Disabled;
     register_file.program_counter = (interrupt_flag_mask == 0x00)
         ? 0x00
@@ -138,908 +467,557 @@ void CentralProcessingUnit::service_interrupt()
     fetch_next_instruction();
 }
 
-uint8_t CentralProcessingUnit::read_byte_and_step_emulator_components(uint16_t address)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::defer_flags(
+    DeferredFlagsOperation operation,
+    uint8_t first_operand,
+    uint8_t second_operand,
+    uint8_t carry_in,
+    uint8_t result)
+{
+    deferred_flags = DeferredFlags{operation, first_operand, second_operand, carry_in, result};
+    if constexpr (!IS_LAZY_FLAG_EVALUATION_ENABLED)
+        materialize_flags();
+}
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::materialize_flags()
+{
+    if (deferred_flags.operation == DeferredFlagsOperation::None)
+        return;
+
+    register_file.flags = get_materialized_flags();
+    deferred_flags.operation = DeferredFlagsOperation::None;
+}
+
+template <typename SystemBus>
+uint8_t CentralProcessingUnit<SystemBus>::get_materialized_flags() const
+{
+    const uint8_t first_operand = deferred_flags.first_operand;
+    const uint8_t second_operand = deferred_flags.second_operand;
+    const uint8_t carry_in = deferred_flags.carry_in;
+    uint8_t flags = 0;
+
+    switch (deferred_flags.operation)
+    {
+        case DeferredFlagsOperation::None:
+            return register_file.flags;
+        case DeferredFlagsOperation::Add:
+            update_flag(flags, HALF_CARRY_FLAG_MASK, (first_operand & 0x0F) + (second_operand & 0x0F) + carry_in > 0x0F);
+            update_flag(flags, CARRY_FLAG_MASK, static_cast<uint16_t>(first_operand) + second_operand + carry_in > 0xFF);
+            break;
+        case DeferredFlagsOperation::Subtract:
+            update_flag(flags, SUBTRACT_FLAG_MASK, true);
+            update_flag(flags, HALF_CARRY_FLAG_MASK, (first_operand & 0x0F) < (second_operand & 0x0F) + carry_in);
+            update_flag(flags, CARRY_FLAG_MASK, first_operand < second_operand + carry_in);
+            break;
+        case DeferredFlagsOperation::And:
+            update_flag(flags, HALF_CARRY_FLAG_MASK, true);
+            break;
+        case DeferredFlagsOperation::ExclusiveOrInclusiveOr:
+            break;
+    }
+    update_flag(flags, ZERO_FLAG_MASK, deferred_flags.result == 0);
+    return flags;
+}
+
+template <typename SystemBus>
+uint8_t CentralProcessingUnit<SystemBus>::read_byte_and_step_emulator_components(uint16_t address)
 {
-    emulator_step_single_machine_cycle_callback();
-    return memory_management_unit.read_byte(address, false);
+    return system_bus.step_single_machine_cycle_and_read_byte(address);
 }
 
-void CentralProcessingUnit::write_byte_and_step_emulator_components(uint16_t address, uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::write_byte_and_step_emulator_components(uint16_t address, uint8_t value)
 {
-    emulator_step_single_machine_cycle_callback();
-    memory_management_unit.write_byte(address, value, false);
+    system_bus.step_single_machine_cycle_and_write_byte(address, value);
 }
 
-uint8_t CentralProcessingUnit::fetch_immediate8_and_step_emulator_components()
+template <typename SystemBus>
+uint8_t CentralProcessingUnit<SystemBus>::fetch_immediate8_and_step_emulator_components()
 {
     uint8_t immediate8 = read_byte_and_step_emulator_components(register_file.program_counter++);
     return immediate8;
 }
 
-uint16_t CentralProcessingUnit::fetch_immediate16_and_step_emulator_components()
+template <typename SystemBus>
+uint16_t CentralProcessingUnit<SystemBus>::fetch_immediate16_and_step_emulator_components()
 {
     const uint8_t low_byte = fetch_immediate8_and_step_emulator_components();
     return low_byte | static_cast<uint16_t>(fetch_immediate8_and_step_emulator_components() << 8);
 }
 
-uint8_t& CentralProcessingUnit::get_register_by_index(uint8_t index)
+template <typename SystemBus>
+template <uint8_t register_index>
+uint8_t& CentralProcessingUnit<SystemBus>::get_register_by_index()
+{
+    static_assert(register_index < 8 && register_index != MEMORY_HL_OPERAND_INDEX, "Invalid register index provided to get_register_by_index()");
+
+    if constexpr (register_index == 0)
+        return register_file.B;
+    else if constexpr (register_index == 1)
+        return register_file.C;
+    else if constexpr (register_index == 2)
+        return register_file.D;
+    else if constexpr (register_index == 3)
+        return register_file.E;
+    else if constexpr (register_index == 4)
+        return register_file.H;
+    else if constexpr (register_index == 5)
+        return register_file.L;
+    else
+        return register_file.A;
+}
+
+template <typename SystemBus>
+template <uint8_t register_pair_index>
+uint16_t& CentralProcessingUnit<SystemBus>::get_register_pair_by_index()
+{
+    static_assert(register_pair_index < 4, "Invalid register pair index provided to get_register_pair_by_index()");
+
+    if constexpr (register_pair_index == 0)
+        return register_file.BC;
+    else if constexpr (register_pair_index == 1)
+        return register_file.DE;
+    else if constexpr (register_pair_index == 2)
+        return register_file.HL;
+    else
+        return register_file.stack_pointer;
+}
+
+template <typename SystemBus>
+template <uint8_t operand_index>
+uint8_t CentralProcessingUnit<SystemBus>::read_operand_and_step_emulator_components()
+{
+    if constexpr (operand_index == MEMORY_HL_OPERAND_INDEX)
+        return read_byte_and_step_emulator_components(register_file.HL);
+    else
+        return get_register_by_index<operand_index>();
+}
+
+template <typename SystemBus>
+template <uint8_t operand_index>
+void CentralProcessingUnit<SystemBus>::write_operand_and_step_emulator_components(uint8_t value)
+{
+    if constexpr (operand_index == MEMORY_HL_OPERAND_INDEX)
+        load_memory(register_file.HL, value);
+    else
+        load(get_register_by_index<operand_index>(), value);
+}
+
+template <typename SystemBus>
+template <uint8_t condition_index>
+bool CentralProcessingUnit<SystemBus>::is_condition_met() const
+{
+    static_assert(condition_index < 4, "Invalid condition index provided to is_condition_met()");
+
+    if constexpr (condition_index == 0)
+        return !is_flag_set(register_file.flags, ZERO_FLAG_MASK);
+    else if constexpr (condition_index == 1)
+        return is_flag_set(register_file.flags, ZERO_FLAG_MASK);
+    else if constexpr (condition_index == 2)
+        return !is_flag_set(register_file.flags, CARRY_FLAG_MASK);
+    else
+        return is_flag_set(register_file.flags, CARRY_FLAG_MASK);
+}
+
+template <typename SystemBus>
+template <uint8_t operation_index>
+void CentralProcessingUnit<SystemBus>::execute_arithmetic_logic_operation_a(uint8_t value)
+{
+    if constexpr (operation_index == 0)
+        add_a(value);
+    else if constexpr (operation_index == 1)
+        add_with_carry_a(value);
+    else if constexpr (operation_index == 2)
+        subtract_a(value);
+    else if constexpr (operation_index == 3)
+        subtract_with_carry_a(value);
+    else if constexpr (operation_index == 4)
+        and_a(value);
+    else if constexpr (operation_index == 5)
+        xor_a(value);
+    else if constexpr (operation_index == 6)
+        or_a(value);
+    else
+        compare_a(value);
+}
+
+template <typename SystemBus>
+template <uint8_t opcode>
+void CentralProcessingUnit<SystemBus>::execute_unprefixed_opcode()
 {
-    switch (index)
+    constexpr uint8_t destination_operand_index = ((opcode >> 3) & 0b111);
+    constexpr uint8_t source_operand_index = (opcode & 0b111);
+    constexpr uint8_t register_pair_index = ((opcode >> 4) & 0b11);
+    constexpr uint8_t condition_index = ((opcode >> 3) & 0b11);
+
+    if constexpr (IS_LAZY_FLAG_EVALUATION_ENABLED && !does_unprefixed_opcode_ignore_flags(opcode) && !does_unprefixed_opcode_defer_flags(opcode))
+        materialize_flags();
+
+    if constexpr (opcode == 0x00 || opcode == 0x10)
     {
-        case 0:
-            return register_file.B;
-        case 1:
-            return register_file.C;
-        case 2:
-            return register_file.D;
-        case 3:
-            return register_file.E;
-        case 4:
-            return register_file.H;
-        case 5:
-            return register_file.L;
-        case 7:
-            return register_file.A;
-        default:
-            throw std::runtime_error{"Error: invalid register index provided to get_register_by_index(uint8_t index)."};
+        // no operation instruction - NOP, stop instruction - STOP - unused until Game Boy Color
     }
+    else if constexpr ((opcode & 0b11001111) == 0x01)
+        load(get_register_pair_by_index<register_pair_index>(), fetch_immediate16_and_step_emulator_components());
+    else if constexpr (opcode == 0x02)
+        load_memory(register_file.BC, register_file.A);
+    else if constexpr (opcode == 0x12)
+        load_memory(register_file.DE, register_file.A);
+    else if constexpr (opcode == 0x22)
+        load_memory(register_file.HL++, register_file.A);
+    else if constexpr (opcode == 0x32)
+        load_memory(register_file.HL--, register_file.A);
+    else if constexpr ((opcode & 0b11001111) == 0x03)
+        increment_and_step_emulator_components(get_register_pair_by_index<register_pair_index>());
+    else if constexpr ((opcode & 0b11000111) == 0x04)
+    {
+        if constexpr (destination_operand_index == MEMORY_HL_OPERAND_INDEX)
+        {
+            uint8_t memory_hl = read_byte_and_step_emulator_components(register_file.HL);
+            increment(memory_hl);
+            write_byte_and_step_emulator_components(register_file.HL, memory_hl);
+        }
+        else
+            increment(get_register_by_index<destination_operand_index>());
+    }
+    else if constexpr ((opcode & 0b11000111) == 0x05)
+    {
+        if constexpr (destination_operand_index == MEMORY_HL_OPERAND_INDEX)
+        {
+            uint8_t memory_hl = read_byte_and_step_emulator_components(register_file.HL);
+            decrement(memory_hl);
+            write_byte_and_step_emulator_components(register_file.HL, memory_hl);
+        }
+        else
+            decrement(get_register_by_index<destination_operand_index>());
+    }
+    else if constexpr ((opcode & 0b11000111) == 0x06)
+        write_operand_and_step_emulator_components<destination_operand_index>(fetch_immediate8_and_step_emulator_components());
+    else if constexpr (opcode == 0x07)
+        rotate_left_circular_a_0x07();
+    else if constexpr (opcode == 0x08)
+        load_memory_immediate16_stack_pointer_0x08();
+    else if constexpr ((opcode & 0b11001111) == 0x09)
+        add_hl(get_register_pair_by_index<register_pair_index>());
+    else if constexpr (opcode == 0x0A)
+        load(register_file.A, read_byte_and_step_emulator_components(register_file.BC));
+    else if constexpr (opcode == 0x1A)
+        load(register_file.A, read_byte_and_step_emulator_components(register_file.DE));
+    else if constexpr (opcode == 0x2A)
+        load(register_file.A, read_byte_and_step_emulator_components(register_file.HL++));
+    else if constexpr (opcode == 0x3A)
+        load(register_file.A, read_byte_and_step_emulator_components(register_file.HL--));
+    else if constexpr ((opcode & 0b11001111) == 0x0B)
+        decrement_and_step_emulator_components(get_register_pair_by_index<register_pair_index>());
+    else if constexpr (opcode == 0x0F)
+        rotate_right_circular_a_0x0F();
+    else if constexpr (opcode == 0x17)
+        rotate_left_through_carry_a_0x17();
+    else if constexpr (opcode == 0x18)
+        jump_relative_conditional_signed_immediate8(true);
+    else if constexpr (opcode == 0x1F)
+        rotate_right_through_carry_a_0x1F();
+    else if constexpr ((opcode & 0b11100111) == 0x20)
+        jump_relative_conditional_signed_immediate8(is_condition_met<condition_index>());
+    else if constexpr (opcode == 0x27)
+        decimal_adjust_a_0x27();
+    else if constexpr (opcode == 0x2F)
+        complement_a_0x2F();
+    else if constexpr (opcode == 0x37)
+        set_carry_flag_0x37();
+    else if constexpr (opcode == 0x3F)
+        complement_carry_flag_0x3F();
+    else if constexpr (opcode == 0x76)
+        halt_0x76();
+    else if constexpr (opcode >= 0x40 && opcode <= 0x7F)
+        write_operand_and_step_emulator_components<destination_operand_index>(read_operand_and_step_emulator_components<source_operand_index>());
+    else if constexpr (opcode >= 0x80 && opcode <= 0xBF)
+        execute_arithmetic_logic_operation_a<destination_operand_index>(read_operand_and_step_emulator_components<source_operand_index>());
+    else if constexpr ((opcode & 0b11100111) == 0xC0)
+        return_conditional(is_condition_met<condition_index>());
+    else if constexpr (opcode == 0xF1)
+        pop_stack_af_0xF1();
+    else if constexpr ((opcode & 0b11001111) == 0xC1)
+        pop_stack(get_register_pair_by_index<register_pair_index>());
+    else if constexpr ((opcode & 0b11100111) == 0xC2)
+        jump_conditional_immediate16(is_condition_met<condition_index>());
+    else if constexpr (opcode == 0xC3)
+        jump_conditional_immediate16(true);
+    else if constexpr ((opcode & 0b11100111) == 0xC4)
+        call_conditional_immediate16(is_condition_met<condition_index>());
+    else if constexpr (opcode == 0xF5)
+        push_stack(register_file.AF);
+    else if constexpr ((opcode & 0b11001111) == 0xC5)
+        push_stack(get_register_pair_by_index<register_pair_index>());
+    else if constexpr ((opcode & 0b11000111) == 0xC6)
+        execute_arithmetic_logic_operation_a<destination_operand_index>(fetch_immediate8_and_step_emulator_components());
+    else if constexpr ((opcode & 0b11000111) == 0xC7)
+        restart_at_address(opcode & 0b00111000);
+    else if constexpr (opcode == 0xC9)
+        return_0xC9();
+    else if constexpr (opcode == 0xCD)
+        call_conditional_immediate16(true);
+    else if constexpr (opcode == 0xD9)
+        return_from_interrupt_0xD9();
+    else if constexpr (opcode == 0xE0)
+        load_memory(INPUT_OUTPUT_REGISTERS_START + fetch_immediate8_and_step_emulator_components(), register_file.A);
+    else if constexpr (opcode == 0xE2)
+        load_memory(INPUT_OUTPUT_REGISTERS_START + register_file.C, register_file.A);
+    else if constexpr (opcode == 0xE8)
+        add_stack_pointer_signed_immediate8_0xE8();
+    else if constexpr (opcode == 0xE9)
+        jump_hl_0xE9();
+    else if constexpr (opcode == 0xEA)
+        load_memory(fetch_immediate16_and_step_emulator_components(), register_file.A);
+    else if constexpr (opcode == 0xF0)
+        load(register_file.A, read_byte_and_step_emulator_components(INPUT_OUTPUT_REGISTERS_START + fetch_immediate8_and_step_emulator_components()));
+    else if constexpr (opcode == 0xF2)
+        load(register_file.A, read_byte_and_step_emulator_components(INPUT_OUTPUT_REGISTERS_START + register_file.C));
+    else if constexpr (opcode == 0xF3)
+        disable_interrupts_0xF3();
+    else if constexpr (opcode == 0xF8)
+        load_hl_stack_pointer_with_signed_offset_0xF8();
+    else if constexpr (opcode == 0xF9)
+        load_stack_pointer_hl_0xF9();
+    else if constexpr (opcode == 0xFA)
+        load(register_file.A, read_byte_and_step_emulator_components(fetch_immediate16_and_step_emulator_components()));
+    else if constexpr (opcode == 0xFB)
+        enable_interrupts_0xFB();
+    else
+        unused_opcode();
+}
+
+template <typename SystemBus>
+template <uint8_t opcode>
+void CentralProcessingUnit<SystemBus>::execute_prefixed_operation(uint8_t& register8)
+{
+    constexpr uint8_t bit_position = ((opcode >> 3) & 0b111);
+
+    if constexpr (opcode <= 0x07)
+        rotate_left_circular(register8);
+    else if constexpr (opcode <= 0x0F)
+        rotate_right_circular(register8);
+    else if constexpr (opcode <= 0x17)
+        rotate_left_through_carry(register8);
+    else if constexpr (opcode <= 0x1F)
+        rotate_right_through_carry(register8);
+    else if constexpr (opcode <= 0x27)
+        shift_left_arithmetic(register8);
+    else if constexpr (opcode <= 0x2F)
+        shift_right_arithmetic(register8);
+    else if constexpr (opcode <= 0x37)
+        swap_nibbles(register8);
+    else if constexpr (opcode <= 0x3F)
+        shift_right_logical(register8);
+    else if constexpr (opcode <= 0x7F)
+        test_bit(bit_position, register8);
+    else if constexpr (opcode <= 0xBF)
+        reset_bit(bit_position, register8);
+    else
+        set_bit(bit_position, register8);
 }
 
-void CentralProcessingUnit::decode_current_unprefixed_opcode_and_execute()
+template <typename SystemBus>
+template <uint8_t opcode>
+void CentralProcessingUnit<SystemBus>::execute_prefixed_opcode()
 {
-    const uint8_t destination_register_index = ((instruction_register_ir >> 3) & 0b111);
-    const uint8_t source_register_index = (instruction_register_ir & 0b111);
+    constexpr uint8_t destination_operand_index = (opcode & 0b111);
+    constexpr bool is_bit_test_operation = (opcode >= 0x40 && opcode <= 0x7F);
+    constexpr bool does_operation_ignore_flags = (opcode >= 0x80);
+
+    if constexpr (IS_LAZY_FLAG_EVALUATION_ENABLED && !does_operation_ignore_flags)
+        materialize_flags();
 
-    switch (instruction_register_ir)
+    if constexpr (destination_operand_index == MEMORY_HL_OPERAND_INDEX)
     {
-        case 0x00:
-            // no operation instruction - NOP
-            break;
-        case 0x01:
-            load(register_file.BC, fetch_immediate16_and_step_emulator_components());
-            break;
-        case 0x02:
-            load_memory(register_file.BC, register_file.A);
-            break;
-        case 0x03:
-            increment_and_step_emulator_components(register_file.BC);
-            break;
-        case 0x04:
-            increment(register_file.B);
-            break;
-        case 0x05:
-            decrement(register_file.B);
-            break;
-        case 0x06:
-            load(register_file.B, fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0x07:
-            rotate_left_circular_a_0x07();
-            break;
-        case 0x08:
-            load_memory_immediate16_stack_pointer_0x08();
-            break;
-        case 0x09:
-            add_hl(register_file.BC);
-            break;
-        case 0x0A:
-            load(register_file.A, read_byte_and_step_emulator_components(register_file.BC));
-            break;
-        case 0x0B:
-            decrement_and_step_emulator_components(register_file.BC);
-            break;
-        case 0x0C:
-            increment(register_file.C);
-            break;
-        case 0x0D:
-            decrement(register_file.C);
-            break;
-        case 0x0E:
-            load(register_file.C, fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0x0F:
-            rotate_right_circular_a_0x0F();
-            break;
-        case 0x10:
-            // stop instruction - STOP - unused until Game Boy Color
-            break;
-        case 0x11:
-            load(register_file.DE, fetch_immediate16_and_step_emulator_components());
-            break;
-        case 0x12:
-            load_memory(register_file.DE, register_file.A);
-            break;
-        case 0x13:
-            increment_and_step_emulator_components(register_file.DE);
-            break;
-        case 0x14:
-            increment(register_file.D);
-            break;
-        case 0x15:
-            decrement(register_file.D);
-            break;
-        case 0x16:
-            load(register_file.D, fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0x17:
-            rotate_left_through_carry_a_0x17();
-            break;
-        case 0x18:
-            jump_relative_conditional_signed_immediate8(true);
-            break;
-        case 0x19:
-            add_hl(register_file.DE);
-            break;
-        case 0x1A:
-            load(register_file.A, read_byte_and_step_emulator_components(register_file.DE));
-            break;
-        case 0x1B:
-            decrement_and_step_emulator_components(register_file.DE);
-            break;
-        case 0x1C:
-            increment(register_file.E);
-            break;
-        case 0x1D:
-            decrement(register_file.E);
-            break;
-        case 0x1E:
-            load(register_file.E, fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0x1F:
-            rotate_right_through_carry_a_0x1F();
-            break;
-        case 0x20:
-            jump_relative_conditional_signed_immediate8(!is_flag_set(register_file.flags, ZERO_FLAG_MASK));
-            break;
-        case 0x21:
-            load(register_file.HL, fetch_immediate16_and_step_emulator_components());
-            break;
-        case 0x22:
-            load_memory(register_file.HL++, register_file.A);
-            break;
-        case 0x23:
-            increment_and_step_emulator_components(register_file.HL);
-            break;
-        case 0x24:
-            increment(register_file.H);
-            break;
-        case 0x25:
-            decrement(register_file.H);
-            break;
-        case 0x26:
-            load(register_file.H, fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0x27:
-            decimal_adjust_a_0x27();
-            break;
-        case 0x28:
-            jump_relative_conditional_signed_immediate8(is_flag_set(register_file.flags, ZERO_FLAG_MASK));
-            break;
-        case 0x29:
-            add_hl(register_file.HL);
-            break;
-        case 0x2A:
-            load(register_file.A, read_byte_and_step_emulator_components(register_file.HL++));
-            break;
-        case 0x2B:
-            decrement_and_step_emulator_components(register_file.HL);
-            break;
-        case 0x2C:
-            increment(register_file.L);
-            break;
-        case 0x2D:
-            decrement(register_file.L);
-            break;
-        case 0x2E:
-            load(register_file.L, fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0x2F:
-            complement_a_0x2F();
-            break;
-        case 0x30:
-            jump_relative_conditional_signed_immediate8(!is_flag_set(register_file.flags, CARRY_FLAG_MASK));
-            break;
-        case 0x31:
-            load(register_file.stack_pointer, fetch_immediate16_and_step_emulator_components());
-            break;
-        case 0x32:
-            load_memory(register_file.HL--, register_file.A);
-            break;
-        case 0x33:
-            increment_and_step_emulator_components(register_file.stack_pointer);
-            break;
-        case 0x34:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::increment);
-            break;
-        case 0x35:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::decrement);
-            break;
-        case 0x36:
-            load_memory(register_file.HL, fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0x37:
-            set_carry_flag_0x37();
-            break;
-        case 0x38:
-            jump_relative_conditional_signed_immediate8(is_flag_set(register_file.flags, CARRY_FLAG_MASK));
-            break;
-        case 0x39:
-            add_hl(register_file.stack_pointer);
-            break;
-        case 0x3A:
-            load(register_file.A, read_byte_and_step_emulator_components(register_file.HL--));
-            break;
-        case 0x3B:
-            decrement_and_step_emulator_components(register_file.stack_pointer);
-            break;
-        case 0x3C:
-            increment(register_file.A);
-            break;
-        case 0x3D:
-            decrement(register_file.A);
-            break;
-        case 0x3E:
-            load(register_file.A, fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0x3F:
-            complement_carry_flag_0x3F();
-            break;
-        case 0x40:
-        case 0x41:
-        case 0x42:
-        case 0x43:
-        case 0x44:
-        case 0x45:
-        case 0x47:
-        case 0x48:
-        case 0x49:
-        case 0x4A:
-        case 0x4B:
-        case 0x4C:
-        case 0x4D:
-        case 0x4F:
-        case 0x50:
-        case 0x51:
-        case 0x52:
-        case 0x53:
-        case 0x54:
-        case 0x55:
-        case 0x57:
-        case 0x58:
-        case 0x59:
-        case 0x5A:
-        case 0x5B:
-        case 0x5C:
-        case 0x5D:
-        case 0x5F:
-        case 0x60:
-        case 0x61:
-        case 0x62:
-        case 0x63:
-        case 0x64:
-        case 0x65:
-        case 0x67:
-        case 0x68:
-        case 0x69:
-        case 0x6A:
-        case 0x6B:
-        case 0x6C:
-        case 0x6D:
-        case 0x6F:
-        case 0x78:
-        case 0x79:
-        case 0x7A:
-        case 0x7B:
-        case 0x7C:
-        case 0x7D:
-        case 0x7F:
-            load(get_register_by_index(destination_register_index), get_register_by_index(source_register_index));
-            break;
-        case 0x46:
-        case 0x56:
-        case 0x66:
-        case 0x4E:
-        case 0x5E:
-        case 0x6E:
-        case 0x7E:
-            load(get_register_by_index(destination_register_index), read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0x70:
-        case 0x71:
-        case 0x72:
-        case 0x73:
-        case 0x74:
-        case 0x75:
-        case 0x77:
-            load_memory(register_file.HL, get_register_by_index(source_register_index));
-            break;
-        case 0x76:
-            halt_0x76();
-            break;
-        case 0x80:
-        case 0x81:
-        case 0x82:
-        case 0x83:
-        case 0x84:
-        case 0x85:
-        case 0x87:
-            add_a(get_register_by_index(source_register_index));
-            break;
-        case 0x86:
-            add_a(read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0x88:
-        case 0x89:
-        case 0x8A:
-        case 0x8B:
-        case 0x8C:
-        case 0x8D:
-        case 0x8F:
-            add_with_carry_a(get_register_by_index(source_register_index));
-            break;
-        case 0x8E:
-            add_with_carry_a(read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0x90:
-        case 0x91:
-        case 0x92:
-        case 0x93:
-        case 0x94:
-        case 0x95:
-        case 0x97:
-            subtract_a(get_register_by_index(source_register_index));
-            break;
-        case 0x96:
-            subtract_a(read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0x98:
-        case 0x99:
-        case 0x9A:
-        case 0x9B:
-        case 0x9C:
-        case 0x9D:
-        case 0x9F:
-            subtract_with_carry_a(get_register_by_index(source_register_index));
-            break;
-        case 0x9E:
-            subtract_with_carry_a(read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0xA0:
-        case 0xA1:
-        case 0xA2:
-        case 0xA3:
-        case 0xA4:
-        case 0xA5:
-        case 0xA7:
-            and_a(get_register_by_index(source_register_index));
-            break;
-        case 0xA6:
-            and_a(read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0xA8:
-        case 0xA9:
-        case 0xAA:
-        case 0xAB:
-        case 0xAC:
-        case 0xAD:
-        case 0xAF:
-            xor_a(get_register_by_index(source_register_index));
-            break;
-        case 0xAE:
-            xor_a(read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0xB0:
-        case 0xB1:
-        case 0xB2:
-        case 0xB3:
-        case 0xB4:
-        case 0xB5:
-        case 0xB7:
-            or_a(get_register_by_index(source_register_index));
-            break;
-        case 0xB6:
-            or_a(read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0xB8:
-        case 0xB9:
-        case 0xBA:
-        case 0xBB:
-        case 0xBC:
-        case 0xBD:
-        case 0xBF:
-            compare_a(get_register_by_index(source_register_index));
-            break;
-        case 0xBE:
-            compare_a(read_byte_and_step_emulator_components(register_file.HL));
-            break;
-        case 0xC0:
-            return_conditional(!is_flag_set(register_file.flags, ZERO_FLAG_MASK));
-            break;
-        case 0xC1:
-            pop_stack(register_file.BC);
-            break;
-        case 0xC2:
-            jump_conditional_immediate16(!is_flag_set(register_file.flags, ZERO_FLAG_MASK));
-            break;
-        case 0xC3:
-            jump_conditional_immediate16(true);
-            break;
-        case 0xC4:
-            call_conditional_immediate16(!is_flag_set(register_file.flags, ZERO_FLAG_MASK));
-            break;
-        case 0xC5:
-            push_stack(register_file.BC);
-            break;
-        case 0xC6:
-            add_a(fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0xC7:
-            restart_at_address(0x00);
-            break;
-        case 0xC8:
-            return_conditional(is_flag_set(register_file.flags, ZERO_FLAG_MASK));
-            break;
-        case 0xC9:
-            return_0xC9();
-            break;
-        case 0xCA:
-            jump_conditional_immediate16(is_flag_set(register_file.flags, ZERO_FLAG_MASK));
-            break;
-        case 0xCC:
-            call_conditional_immediate16(is_flag_set(register_file.flags, ZERO_FLAG_MASK));
-            break;
-        case 0xCD:
-            call_conditional_immediate16(true);
-            break;
-        case 0xCE:
-            add_with_carry_a(fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0xCF:
-            restart_at_address(0x08);
-            break;
-        case 0xD0:
-            return_conditional(!is_flag_set(register_file.flags, CARRY_FLAG_MASK));
-            break;
-        case 0xD1:
-            pop_stack(register_file.DE);
-            break;
-        case 0xD2:
-            jump_conditional_immediate16(!is_flag_set(register_file.flags, CARRY_FLAG_MASK));
-            break;
-        case 0xD4:
-            call_conditional_immediate16(!is_flag_set(register_file.flags, CARRY_FLAG_MASK));
-            break;
-        case 0xD5:
-            push_stack(register_file.DE);
-            break;
-        case 0xD6:
-            subtract_a(fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0xD7:
-            restart_at_address(0x10);
-            break;
-        case 0xD8:
-            return_conditional(is_flag_set(register_file.flags, CARRY_FLAG_MASK));
-            break;
-        case 0xD9:
-            return_from_interrupt_0xD9();
-            break;
-        case 0xDA:
-            jump_conditional_immediate16(is_flag_set(register_file.flags, CARRY_FLAG_MASK));
-            break;
-        case 0xDC:
-            call_conditional_immediate16(is_flag_set(register_file.flags, CARRY_FLAG_MASK));
-            break;
-        case 0xDE:
-            subtract_with_carry_a(fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0xDF:
-            restart_at_address(0x18);
-            break;
-        case 0xE0:
-            load_memory(INPUT_OUTPUT_REGISTERS_START + fetch_immediate8_and_step_emulator_components(), register_file.A);
-            break;
-        case 0xE1:
-            pop_stack(register_file.HL);
-            break;
-        case 0xE2:
-            load_memory(INPUT_OUTPUT_REGISTERS_START + register_file.C, register_file.A);
-            break;
-        case 0xE5:
-            push_stack(register_file.HL);
-            break;
-        case 0xE6:
-            and_a(fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0xE7:
-            restart_at_address(0x20);
-            break;
-        case 0xE8:
-            add_stack_pointer_signed_immediate8_0xE8();
-            break;
-        case 0xE9:
-            jump_hl_0xE9();
-            break;
-        case 0xEA:
-            load_memory(fetch_immediate16_and_step_emulator_components(), register_file.A);
-            break;
-        case 0xEE:
-            xor_a(fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0xEF:
-            restart_at_address(0x28);
-            break;
-        case 0xF0:
-            load(register_file.A, read_byte_and_step_emulator_components(INPUT_OUTPUT_REGISTERS_START + fetch_immediate8_and_step_emulator_components()));
-            break;
-        case 0xF1:
-            pop_stack_af_0xF1();
-            break;
-        case 0xF2:
-            load(register_file.A, read_byte_and_step_emulator_components(INPUT_OUTPUT_REGISTERS_START + register_file.C));
-            break;
-        case 0xF3:
-            disable_interrupts_0xF3();
-            break;
-        case 0xF5:
-            push_stack(register_file.AF);
-            break;
-        case 0xF6:
-            or_a(fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0xF7:
-            restart_at_address(0x30);
-            break;
-        case 0xF8:
-            load_hl_stack_pointer_with_signed_offset_0xF8();
-            break;
-        case 0xF9:
-            load_stack_pointer_hl_0xF9();
-            break;
-        case 0xFA:
-            load(register_file.A, read_byte_and_step_emulator_components(fetch_immediate16_and_step_emulator_components()));
-            break;
-        case 0xFB:
-            enable_interrupts_0xFB();
-            break;
-        case 0xFE:
-            compare_a(fetch_immediate8_and_step_emulator_components());
-            break;
-        case 0xFF:
-            restart_at_address(0x38);
-            break;
-        default:
-            unused_opcode();
-            break;
+        uint8_t memory_hl = read_byte_and_step_emulator_components(register_file.HL);
+        execute_prefixed_operation<opcode>(memory_hl);
+        if constexpr (!is_bit_test_operation)
+            write_byte_and_step_emulator_components(register_file.HL, memory_hl);
+    }
+    else
+        execute_prefixed_operation<opcode>(get_register_by_index<destination_operand_index>());
+}
+
+template <typename SystemBus>
+template <size_t... opcodes>
+constexpr std::array<typename CentralProcessingUnit<SystemBus>::InstructionHandler, 2 * NUMBER_OF_OPCODES> CentralProcessingUnit<SystemBus>::create_instruction_handler_table(std::index_sequence<opcodes...>)
+{
+    return {&CentralProcessingUnit::execute_unprefixed_opcode<opcodes>...,
+            &CentralProcessingUnit::execute_prefixed_opcode<opcodes>...};
+}
+
+template <typename SystemBus>
+constinit const std::array<typename CentralProcessingUnit<SystemBus>::InstructionHandler, 2 * NUMBER_OF_OPCODES> CentralProcessingUnit<SystemBus>::INSTRUCTION_HANDLERS =
+    create_instruction_handler_table(std::make_index_sequence<NUMBER_OF_OPCODES>{});
+
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::step_instructions(uint32_t instruction_count)
+{
+#if defined(GAME_BOY_EMULATOR_THREADED_DISPATCH) && defined(__GNUC__)
+    // Each handler ends with its own indirect jump to the next handler so the host branch predictor sees opcode pairs
+#define FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, HIGH_NIBBLE) \
+    MACRO(HIGH_NIBBLE##0) MACRO(HIGH_NIBBLE##1) MACRO(HIGH_NIBBLE##2) MACRO(HIGH_NIBBLE##3) \
+    MACRO(HIGH_NIBBLE##4) MACRO(HIGH_NIBBLE##5) MACRO(HIGH_NIBBLE##6) MACRO(HIGH_NIBBLE##7) \
+    MACRO(HIGH_NIBBLE##8) MACRO(HIGH_NIBBLE##9) MACRO(HIGH_NIBBLE##A) MACRO(HIGH_NIBBLE##B) \
+    MACRO(HIGH_NIBBLE##C) MACRO(HIGH_NIBBLE##D) MACRO(HIGH_NIBBLE##E) MACRO(HIGH_NIBBLE##F)
+#define FOR_EACH_OPCODE(MACRO) \
+    FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x0) FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x1) \
+    FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x2) FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x3) \
+    FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x4) FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x5) \
+    FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x6) FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x7) \
+    FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x8) FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0x9) \
+    FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0xA) FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0xB) \
+    FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0xC) FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0xD) \
+    FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0xE) FOR_EACH_OPCODE_WITH_HIGH_NIBBLE(MACRO, 0xF)
+#define UNPREFIXED_OPCODE_LABEL_ADDRESS(opcode) &&unprefixed_opcode_##opcode,
+#define PREFIXED_OPCODE_LABEL_ADDRESS(opcode) &&prefixed_opcode_##opcode,
+#define DISPATCH_NEXT_INSTRUCTION() \
+    if (is_halted) \
+        goto halted; \
+    if (instruction_register_ir == LOAD_A_FROM_INPUT_OUTPUT_REGISTER_OPCODE && !is_current_instruction_prefixed) \
+        goto idle_loop; \
+    if (try_execute_translated_block()) \
+        goto translated_block; \
+    goto *(is_current_instruction_prefixed ? prefixed_opcode_labels : unprefixed_opcode_labels)[instruction_register_ir];
+#define FINISH_INSTRUCTION_AND_DISPATCH_NEXT() \
+    service_interrupt_and_update_interrupt_master_enable(); \
+    if (--instruction_count == 0) \
+        return; \
+    DISPATCH_NEXT_INSTRUCTION()
+#define UNPREFIXED_OPCODE_LABEL(opcode) \
+    unprefixed_opcode_##opcode: \
+    execute_unprefixed_opcode<opcode>(); \
+    fetch_next_instruction(); \
+    FINISH_INSTRUCTION_AND_DISPATCH_NEXT()
+#define PREFIXED_OPCODE_LABEL(opcode) \
+    prefixed_opcode_##opcode: \
+    execute_prefixed_opcode<opcode>(); \
+    fetch_next_instruction(); \
+    FINISH_INSTRUCTION_AND_DISPATCH_NEXT()
+
+    static void* const unprefixed_opcode_labels[NUMBER_OF_OPCODES]{FOR_EACH_OPCODE(UNPREFIXED_OPCODE_LABEL_ADDRESS)};
+    static void* const prefixed_opcode_labels[NUMBER_OF_OPCODES]{FOR_EACH_OPCODE(PREFIXED_OPCODE_LABEL_ADDRESS)};
+
+    if (instruction_count == 0)
+        return;
+    DISPATCH_NEXT_INSTRUCTION()
+
+halted:
+    step_halted_machine_cycles();
+    FINISH_INSTRUCTION_AND_DISPATCH_NEXT()
+
+idle_loop:
+    if (!try_skip_idle_loop())
+        goto unprefixed_opcode_0xF0;
+    FINISH_INSTRUCTION_AND_DISPATCH_NEXT()
+
+translated_block:
+    FINISH_INSTRUCTION_AND_DISPATCH_NEXT()
+
+    FOR_EACH_OPCODE(UNPREFIXED_OPCODE_LABEL)
+    FOR_EACH_OPCODE(PREFIXED_OPCODE_LABEL)
+
+#undef PREFIXED_OPCODE_LABEL
+#undef UNPREFIXED_OPCODE_LABEL
+#undef FINISH_INSTRUCTION_AND_DISPATCH_NEXT
+#undef DISPATCH_NEXT_INSTRUCTION
+#undef PREFIXED_OPCODE_LABEL_ADDRESS
+#undef UNPREFIXED_OPCODE_LABEL_ADDRESS
+#undef FOR_EACH_OPCODE
+#undef FOR_EACH_OPCODE_WITH_HIGH_NIBBLE
+#else
+    for (; instruction_count > 0; instruction_count--)
+    {
+        step_single_instruction();
     }
+#endif
 }
 
-void CentralProcessingUnit::decode_current_prefixed_opcode_and_execute()
+template <typename SystemBus>
+EmulationStopResult CentralProcessingUnit<SystemBus>::step_instructions_until_stopped(const EmulationStopConditions& stop_conditions)
 {
-    const uint8_t destination_register_index = (instruction_register_ir & 0b111);
-    const uint8_t bit_position = ((instruction_register_ir >> 3) & 0b111);
+    machine_cycle_limit = system_bus.get_elapsed_machine_cycles() + stop_conditions.machine_cycle_budget;
+    are_instruction_boundaries_observed = stop_conditions.breakpoint_opcode.has_value() || !stop_conditions.register_patterns.empty();
+    const uint64_t initial_published_frame_count = system_bus.get_published_frame_count();
+    system_bus.watch_write_address(stop_conditions.watched_write_address);
 
-    switch (instruction_register_ir)
+    // Conditions are checked after each instruction rather than before so that resuming from a stop always makes progress
+    std::optional<EmulationStopResult> stop_result{};
+    while (!stop_result.has_value())
     {
-        case 0x00:
-        case 0x01:
-        case 0x02:
-        case 0x03:
-        case 0x04:
-        case 0x05:
-        case 0x07:
-            rotate_left_circular(get_register_by_index(destination_register_index));
-            break;
-        case 0x06:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::rotate_left_circular);
-            break;
-        case 0x08:
-        case 0x09:
-        case 0x0A:
-        case 0x0B:
-        case 0x0C:
-        case 0x0D:
-        case 0x0F:
-            rotate_right_circular(get_register_by_index(destination_register_index));
-            break;
-        case 0x0E:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::rotate_right_circular);
-            break;
-        case 0x10:
-        case 0x11:
-        case 0x12:
-        case 0x13:
-        case 0x14:
-        case 0x15:
-        case 0x17:
-            rotate_left_through_carry(get_register_by_index(destination_register_index));
-            break;
-        case 0x16:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::rotate_left_through_carry);
-            break;
-        case 0x18:
-        case 0x19:
-        case 0x1A:
-        case 0x1B:
-        case 0x1C:
-        case 0x1D:
-        case 0x1F:
-            rotate_right_through_carry(get_register_by_index(destination_register_index));
-            break;
-        case 0x1E:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::rotate_right_through_carry);
-            break;
-        case 0x20:
-        case 0x21:
-        case 0x22:
-        case 0x23:
-        case 0x24:
-        case 0x25:
-        case 0x27:
-            shift_left_arithmetic(get_register_by_index(destination_register_index));
-            break;
-        case 0x26:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::shift_left_arithmetic);
-            break;
-        case 0x28:
-        case 0x29:
-        case 0x2A:
-        case 0x2B:
-        case 0x2C:
-        case 0x2D:
-        case 0x2F:
-            shift_right_arithmetic(get_register_by_index(destination_register_index));
-            break;
-        case 0x2E:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::shift_right_arithmetic);
-            break;
-        case 0x30:
-        case 0x31:
-        case 0x32:
-        case 0x33:
-        case 0x34:
-        case 0x35:
-        case 0x37:
-            swap_nibbles(get_register_by_index(destination_register_index));
-            break;
-        case 0x36:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::swap_nibbles);
-            break;
-        case 0x38:
-        case 0x39:
-        case 0x3A:
-        case 0x3B:
-        case 0x3C:
-        case 0x3D:
-        case 0x3F:
-            shift_right_logical(get_register_by_index(destination_register_index));
-            break;
-        case 0x3E:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::shift_right_logical);
-            break;        
-        case 0x40:
-        case 0x41:
-        case 0x42:
-        case 0x43:
-        case 0x44:
-        case 0x45:
-        case 0x47:
-        case 0x48:
-        case 0x49:
-        case 0x4A:
-        case 0x4B:
-        case 0x4C:
-        case 0x4D:
-        case 0x4F:
-        case 0x50:
-        case 0x51:
-        case 0x52:
-        case 0x53:
-        case 0x54:
-        case 0x55:
-        case 0x57:
-        case 0x58:
-        case 0x59:
-        case 0x5A:
-        case 0x5B:
-        case 0x5C:
-        case 0x5D:
-        case 0x5F:
-        case 0x60:
-        case 0x61:
-        case 0x62:
-        case 0x63:
-        case 0x64:
-        case 0x65:
-        case 0x67:
-        case 0x68:
-        case 0x69:
-        case 0x6A:
-        case 0x6B:
-        case 0x6C:
-        case 0x6D:
-        case 0x6F:
-        case 0x70:
-        case 0x71:
-        case 0x72:
-        case 0x73:
-        case 0x74:
-        case 0x75:
-        case 0x77:
-        case 0x78:
-        case 0x79:
-        case 0x7A:
-        case 0x7B:
-        case 0x7C:
-        case 0x7D:
-        case 0x7F:
-            test_bit(bit_position, get_register_by_index(destination_register_index));
-            break;
-        case 0x46:
-        case 0x4E:
-        case 0x56:
-        case 0x5E:
-        case 0x66:
-        case 0x6E:
-        case 0x76:
-        case 0x7E:
-            operate_on_register_hl(&CentralProcessingUnit::test_bit, bit_position);
-            break;
-        case 0x80:
-        case 0x81:
-        case 0x82:
-        case 0x83:
-        case 0x84:
-        case 0x85:
-        case 0x87:
-        case 0x88:
-        case 0x89:
-        case 0x8A:
-        case 0x8B:
-        case 0x8C:
-        case 0x8D:
-        case 0x8F:
-        case 0x90:
-        case 0x91:
-        case 0x92:
-        case 0x93:
-        case 0x94:
-        case 0x95:
-        case 0x97:
-        case 0x98:
-        case 0x99:
-        case 0x9A:
-        case 0x9B:
-        case 0x9C:
-        case 0x9D:
-        case 0x9F:
-        case 0xA0:
-        case 0xA1:
-        case 0xA2:
-        case 0xA3:
-        case 0xA4:
-        case 0xA5:
-        case 0xA7:
-        case 0xA8:
-        case 0xA9:
-        case 0xAA:
-        case 0xAB:
-        case 0xAC:
-        case 0xAD:
-        case 0xAF:
-        case 0xB0:
-        case 0xB1:
-        case 0xB2:
-        case 0xB3:
-        case 0xB4:
-        case 0xB5:
-        case 0xB7:
-        case 0xB8:
-        case 0xB9:
-        case 0xBA:
-        case 0xBB:
-        case 0xBC:
-        case 0xBD:
-        case 0xBF:
-            reset_bit(bit_position, get_register_by_index(destination_register_index));
-            break;
-        case 0x86:
-        case 0x8E:
-        case 0x96:
-        case 0x9E:
-        case 0xA6:
-        case 0xAE:
-        case 0xB6:
-        case 0xBE:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::reset_bit, bit_position);
-            break;
-        case 0xC0:
-        case 0xC1:
-        case 0xC2:
-        case 0xC3:
-        case 0xC4:
-        case 0xC5:
-        case 0xC7:
-        case 0xC8:
-        case 0xC9:
-        case 0xCA:
-        case 0xCB:
-        case 0xCC:
-        case 0xCD:
-        case 0xCF:
-        case 0xD0:
-        case 0xD1:
-        case 0xD2:
-        case 0xD3:
-        case 0xD4:
-        case 0xD5:
-        case 0xD7:
-        case 0xD8:
-        case 0xD9:
-        case 0xDA:
-        case 0xDB:
-        case 0xDC:
-        case 0xDD:
-        case 0xDF:
-        case 0xE0:
-        case 0xE1:
-        case 0xE2:
-        case 0xE3:
-        case 0xE4:
-        case 0xE5:
-        case 0xE7:
-        case 0xE8:
-        case 0xE9:
-        case 0xEA:
-        case 0xEB:
-        case 0xEC:
-        case 0xED:
-        case 0xEF:
-        case 0xF0:
-        case 0xF1:
-        case 0xF2:
-        case 0xF3:
-        case 0xF4:
-        case 0xF5:
-        case 0xF7:
-        case 0xF8:
-        case 0xF9:
-        case 0xFA:
-        case 0xFB:
-        case 0xFC:
-        case 0xFD:
-        case 0xFF:
-            set_bit(bit_position, get_register_by_index(destination_register_index));
-            break;
-        case 0xC6:
-        case 0xCE:
-        case 0xD6:
-        case 0xDE:
-        case 0xE6:
-        case 0xEE:
-        case 0xF6:
-        case 0xFE:
-            operate_on_register_hl_and_write(&CentralProcessingUnit::set_bit, bit_position);
-            break;
+        step_single_instruction();
+        stop_result = get_stop_result(stop_conditions, machine_cycle_limit, initial_published_frame_count);
+    }
+    system_bus.watch_write_address(std::nullopt);
+    machine_cycle_limit = UINT64_MAX;
+    are_instruction_boundaries_observed = false;
+    return *stop_result;
+}
+
+template <typename SystemBus>
+std::optional<EmulationStopResult> CentralProcessingUnit<SystemBus>::get_stop_result(
+    const EmulationStopConditions& stop_conditions,
+    uint64_t machine_cycle_limit,
+    uint64_t initial_published_frame_count) const
+{
+    if (system_bus.was_watched_write_address_written())
+        return EmulationStopResult{EmulationStopReason::WatchedAddressWritten};
+
+    if (stop_conditions.should_stop_at_published_frame && system_bus.get_published_frame_count() != initial_published_frame_count)
+        return EmulationStopResult{EmulationStopReason::FramePublished};
+
+    const bool is_breakpoint_opcode_reached = stop_conditions.breakpoint_opcode.has_value() &&
+                                              !is_halted &&
+                                              !is_current_instruction_prefixed &&
+                                              instruction_register_ir == *stop_conditions.breakpoint_opcode;
+    if (is_breakpoint_opcode_reached)
+        return EmulationStopResult{EmulationStopReason::BreakpointOpcodeReached};
+
+    if (!stop_conditions.register_patterns.empty())
+    {
+        const RegisterFile<std::endian::native> current_register_file = get_register_file();
+        for (size_t pattern_index = 0; pattern_index < stop_conditions.register_patterns.size(); pattern_index++)
+        {
+            if (stop_conditions.register_patterns[pattern_index].does_match(current_register_file))
+                return EmulationStopResult{EmulationStopReason::RegisterPatternMatched, pattern_index};
+        }
     }
+
+    if (system_bus.get_elapsed_machine_cycles() >= machine_cycle_limit)
+        return EmulationStopResult{EmulationStopReason::MachineCycleBudgetExhausted};
+
+    return std::nullopt;
+}
+
+template <typename SystemBus>
+uint64_t CentralProcessingUnit<SystemBus>::get_machine_cycles_until_limit() const
+{
+    const uint64_t elapsed_machine_cycles = system_bus.get_elapsed_machine_cycles();
+    return (machine_cycle_limit > elapsed_machine_cycles) ? machine_cycle_limit - elapsed_machine_cycles : 0;
 }
 
 // ================================
 // ===== Generic Instructions =====
 // ================================
 
+template <typename SystemBus>
 template <typename T>
-void CentralProcessingUnit::load(T& destination_register, T value)
+void CentralProcessingUnit<SystemBus>::load(T& destination_register, T value)
 {
     destination_register = value;
 }
 
-void CentralProcessingUnit::load_memory(uint16_t address, uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::load_memory(uint16_t address, uint8_t value)
 {
     write_byte_and_step_emulator_components(address, value);
 }
 
-void CentralProcessingUnit::increment(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::increment(uint8_t& register8)
 {
     const bool does_half_carry_occur = (register8 & 0x0F) == 0x0F;
     register8++;
@@ -1048,13 +1026,15 @@ void CentralProcessingUnit::increment(uint8_t& register8)
     update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, does_half_carry_occur);
 }
 
-void CentralProcessingUnit::increment_and_step_emulator_components(uint16_t& register16)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::increment_and_step_emulator_components(uint16_t& register16)
 {
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
     register16++;
 }
 
-void CentralProcessingUnit::decrement(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::decrement(uint8_t& register8)
 {
     const bool does_half_carry_occur = (register8 & 0x0F) == 0x00;
     register8--;
@@ -1063,15 +1043,17 @@ void CentralProcessingUnit::decrement(uint8_t& register8)
     update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, does_half_carry_occur);
 }
 
-void CentralProcessingUnit::decrement_and_step_emulator_components(uint16_t& register16)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::decrement_and_step_emulator_components(uint16_t& register16)
 {
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
     register16--;
 }
 
-void CentralProcessingUnit::add_hl(uint16_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::add_hl(uint16_t value)
 {
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
     const bool does_half_carry_occur = (register_file.HL & 0x0FFF) + (value & 0x0FFF) > 0x0FFF;
     const bool does_carry_occur = static_cast<uint32_t>(register_file.HL) + value > 0xFFFF;
     register_file.HL += value;
@@ -1080,143 +1062,127 @@ void CentralProcessingUnit::add_hl(uint16_t value)
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::add_a(uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::add_a(uint8_t value)
 {
-    const bool does_half_carry_occur = (register_file.A & 0x0F) + (value & 0x0F) > 0x0F;
-    const bool does_carry_occur = static_cast<uint16_t>(register_file.A) + value > 0xFF;
+    defer_flags(DeferredFlagsOperation::Add, register_file.A, value, 0, register_file.A + value);
     register_file.A += value;
-    update_flag(register_file.flags, ZERO_FLAG_MASK, register_file.A == 0);
-    update_flag(register_file.flags, SUBTRACT_FLAG_MASK, false);
-    update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, does_half_carry_occur);
-    update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::add_with_carry_a(uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::add_with_carry_a(uint8_t value)
 {
+    materialize_flags();
     const uint8_t carry_in = is_flag_set(register_file.flags, CARRY_FLAG_MASK) ? 1 : 0;
-    const bool does_half_carry_occur = (register_file.A & 0x0F) + (value & 0x0F) + carry_in > 0x0F;
-    const bool does_carry_occur = static_cast<uint16_t>(register_file.A) + value + carry_in > 0xFF;
+    defer_flags(DeferredFlagsOperation::Add, register_file.A, value, carry_in, register_file.A + value + carry_in);
     register_file.A += value + carry_in;
-    update_flag(register_file.flags, ZERO_FLAG_MASK, register_file.A == 0);
-    update_flag(register_file.flags, SUBTRACT_FLAG_MASK, false);
-    update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, does_half_carry_occur);
-    update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::subtract_a(uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::subtract_a(uint8_t value)
 {
-    const bool does_half_carry_occur = (register_file.A & 0x0F) < (value & 0x0F);
-    const bool does_carry_occur = register_file.A < value;
+    defer_flags(DeferredFlagsOperation::Subtract, register_file.A, value, 0, register_file.A - value);
     register_file.A -= value;
-    update_flag(register_file.flags, ZERO_FLAG_MASK, register_file.A == 0);
-    update_flag(register_file.flags, SUBTRACT_FLAG_MASK, true);
-    update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, does_half_carry_occur);
-    update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::subtract_with_carry_a(uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::subtract_with_carry_a(uint8_t value)
 {
+    materialize_flags();
     const uint8_t carry_in = is_flag_set(register_file.flags, CARRY_FLAG_MASK) ? 1 : 0;
-    const bool does_half_carry_occur = (register_file.A & 0x0F) < (value & 0x0F) + carry_in;
-    const bool does_carry_occur = register_file.A < value + carry_in;
+    defer_flags(DeferredFlagsOperation::Subtract, register_file.A, value, carry_in, register_file.A - value - carry_in);
     register_file.A -= value + carry_in;
-    update_flag(register_file.flags, ZERO_FLAG_MASK, register_file.A == 0);
-    update_flag(register_file.flags, SUBTRACT_FLAG_MASK, true);
-    update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, does_half_carry_occur);
-    update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::and_a(uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::and_a(uint8_t value)
 {
     register_file.A &= value;
-    update_flag(register_file.flags, ZERO_FLAG_MASK, register_file.A == 0);
-    update_flag(register_file.flags, SUBTRACT_FLAG_MASK, false);
-    update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, true);
-    update_flag(register_file.flags, CARRY_FLAG_MASK, false);
+    defer_flags(DeferredFlagsOperation::And, register_file.A, value, 0, register_file.A);
 }
 
-void CentralProcessingUnit::xor_a(uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::xor_a(uint8_t value)
 {
     register_file.A ^= value;
-    update_flag(register_file.flags, ZERO_FLAG_MASK, register_file.A == 0);
-    update_flag(register_file.flags, SUBTRACT_FLAG_MASK, false);
-    update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, false);
-    update_flag(register_file.flags, CARRY_FLAG_MASK, false);
+    defer_flags(DeferredFlagsOperation::ExclusiveOrInclusiveOr, register_file.A, value, 0, register_file.A);
 }
 
-void CentralProcessingUnit::or_a(uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::or_a(uint8_t value)
 {
     register_file.A |= value;
-    update_flag(register_file.flags, ZERO_FLAG_MASK, register_file.A == 0);
-    update_flag(register_file.flags, SUBTRACT_FLAG_MASK, false);
-    update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, false);
-    update_flag(register_file.flags, CARRY_FLAG_MASK, false);
+    defer_flags(DeferredFlagsOperation::ExclusiveOrInclusiveOr, register_file.A, value, 0, register_file.A);
 }
 
-void CentralProcessingUnit::compare_a(uint8_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::compare_a(uint8_t value)
 {
-    const bool does_half_carry_occur = (register_file.A & 0x0F) < (value & 0x0F);
-    const bool does_carry_occur = register_file.A < value;
-    update_flag(register_file.flags, ZERO_FLAG_MASK, register_file.A == value);
-    update_flag(register_file.flags, SUBTRACT_FLAG_MASK, true);
-    update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, does_half_carry_occur);
-    update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
+    defer_flags(DeferredFlagsOperation::Subtract, register_file.A, value, 0, register_file.A - value);
 }
 
-void CentralProcessingUnit::jump_relative_conditional_signed_immediate8(bool is_condition_met)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::jump_relative_conditional_signed_immediate8(bool is_condition_met)
 {
     const int8_t signed_offset = static_cast<int8_t>(fetch_immediate8_and_step_emulator_components());
     if (is_condition_met)
     {
-        emulator_step_single_machine_cycle_callback();
+        system_bus.step_single_machine_cycle();
         register_file.program_counter += signed_offset;
     }
 }
 
-void CentralProcessingUnit::jump_conditional_immediate16(bool is_condition_met)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::jump_conditional_immediate16(bool is_condition_met)
 {
     const uint16_t jump_address = fetch_immediate16_and_step_emulator_components();
     if (is_condition_met)
     {
-        emulator_step_single_machine_cycle_callback();
+        system_bus.step_single_machine_cycle();
         register_file.program_counter = jump_address;
     }
 }
 
-void CentralProcessingUnit::pop_stack(uint16_t& destination_register16)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::pop_stack(uint16_t& destination_register16)
 {
     uint8_t low_byte = read_byte_and_step_emulator_components(register_file.stack_pointer++);
     destination_register16 = low_byte | static_cast<uint16_t>(read_byte_and_step_emulator_components(register_file.stack_pointer++) << 8);
 }
 
-void CentralProcessingUnit::push_stack(uint16_t value)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::push_stack(uint16_t value)
 {
     decrement_and_step_emulator_components(register_file.stack_pointer);
     write_byte_and_step_emulator_components(register_file.stack_pointer--, value >> 8);
     write_byte_and_step_emulator_components(register_file.stack_pointer, value & 0xFF);
 }
 
-void CentralProcessingUnit::call_conditional_immediate16(bool is_condition_met)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::call_conditional_immediate16(bool is_condition_met)
 {
     const uint16_t subroutine_address = fetch_immediate16_and_step_emulator_components();
     if (is_condition_met)
         restart_at_address(subroutine_address);
 }
 
-void CentralProcessingUnit::return_conditional(bool is_condition_met)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::return_conditional(bool is_condition_met)
 {
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
     if (is_condition_met)
         return_0xC9();
 }
 
-void CentralProcessingUnit::restart_at_address(uint16_t address)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::restart_at_address(uint16_t address)
 {
     push_stack(register_file.program_counter);
     register_file.program_counter = address;
 }
 
-void CentralProcessingUnit::rotate_left_circular(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::rotate_left_circular(uint8_t& register8)
 {
     const bool does_carry_occur = (register8 & 0b10000000) != 0;
     register8 = (register8 << 1) | (register8 >> 7);
@@ -1226,7 +1192,8 @@ void CentralProcessingUnit::rotate_left_circular(uint8_t& register8)
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::rotate_right_circular(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::rotate_right_circular(uint8_t& register8)
 {
     const bool does_carry_occur = (register8 & 0b00000001) != 0;
     register8 = (register8 << 7) | (register8 >> 1);
@@ -1236,7 +1203,8 @@ void CentralProcessingUnit::rotate_right_circular(uint8_t& register8)
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::rotate_left_through_carry(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::rotate_left_through_carry(uint8_t& register8)
 {
     const uint8_t carry_in = is_flag_set(register_file.flags, CARRY_FLAG_MASK) ? 1 : 0;
     const bool does_carry_occur = (register8 & 0b10000000) != 0;
@@ -1247,7 +1215,8 @@ void CentralProcessingUnit::rotate_left_through_carry(uint8_t& register8)
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::rotate_right_through_carry(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::rotate_right_through_carry(uint8_t& register8)
 {
     const uint8_t carry_in = is_flag_set(register_file.flags, CARRY_FLAG_MASK) ? 1 : 0;
     const bool does_carry_occur = (register8 & 0b00000001) != 0;
@@ -1258,7 +1227,8 @@ void CentralProcessingUnit::rotate_right_through_carry(uint8_t& register8)
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::shift_left_arithmetic(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::shift_left_arithmetic(uint8_t& register8)
 {
     const bool does_carry_occur = (register8 & 0b10000000) != 0;
     register8 <<= 1;
@@ -1268,7 +1238,8 @@ void CentralProcessingUnit::shift_left_arithmetic(uint8_t& register8)
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::shift_right_arithmetic(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::shift_right_arithmetic(uint8_t& register8)
 {
     const bool does_carry_occur = (register8 & 0b00000001) != 0;
     const uint8_t preserved_sign_bit = register8 & 0b10000000;
@@ -1279,7 +1250,8 @@ void CentralProcessingUnit::shift_right_arithmetic(uint8_t& register8)
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::swap_nibbles(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::swap_nibbles(uint8_t& register8)
 {
     register8 = ((register8 & 0x0F) << 4) | ((register8 & 0xF0) >> 4);
     update_flag(register_file.flags, ZERO_FLAG_MASK, register8 == 0);
@@ -1288,7 +1260,8 @@ void CentralProcessingUnit::swap_nibbles(uint8_t& register8)
     update_flag(register_file.flags, CARRY_FLAG_MASK, false);
 }
 
-void CentralProcessingUnit::shift_right_logical(uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::shift_right_logical(uint8_t& register8)
 {
     const bool does_carry_occur = (register8 & 0b00000001) != 0;
     register8 >>= 1;
@@ -1298,7 +1271,8 @@ void CentralProcessingUnit::shift_right_logical(uint8_t& register8)
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::test_bit(uint8_t bit_position_to_test, uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::test_bit(uint8_t bit_position_to_test, uint8_t& register8)
 {
     const bool is_bit_set = (register8 & (1 << bit_position_to_test)) != 0;
     update_flag(register_file.flags, ZERO_FLAG_MASK, !is_bit_set);
@@ -1306,41 +1280,24 @@ void CentralProcessingUnit::test_bit(uint8_t bit_position_to_test, uint8_t& regi
     update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, true);
 }
 
-void CentralProcessingUnit::reset_bit(uint8_t bit_position_to_reset, uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::reset_bit(uint8_t bit_position_to_reset, uint8_t& register8)
 {
     register8 &= ~(1 << bit_position_to_reset);
 }
 
-void CentralProcessingUnit::set_bit(uint8_t bit_position_to_set, uint8_t& register8)
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::set_bit(uint8_t bit_position_to_set, uint8_t& register8)
 {
     register8 |= (1 << bit_position_to_set);
 }
 
-void CentralProcessingUnit::operate_on_register_hl(void (CentralProcessingUnit::* operation)(uint8_t, uint8_t&), uint8_t bit_position)
-{
-    uint8_t memory_hl = read_byte_and_step_emulator_components(register_file.HL);
-    (this->*operation)(bit_position, memory_hl);
-}
-
-void CentralProcessingUnit::operate_on_register_hl_and_write(void (CentralProcessingUnit::* operation)(uint8_t, uint8_t&), uint8_t bit_position)
-{
-    uint8_t memory_hl = read_byte_and_step_emulator_components(register_file.HL);
-    (this->*operation)(bit_position, memory_hl);
-    write_byte_and_step_emulator_components(register_file.HL, memory_hl);
-}
-
-void CentralProcessingUnit::operate_on_register_hl_and_write(void (CentralProcessingUnit::* operation)(uint8_t&))
-{
-    uint8_t memory_hl = read_byte_and_step_emulator_components(register_file.HL);
-    (this->*operation)(memory_hl);
-    write_byte_and_step_emulator_components(register_file.HL, memory_hl);
-}
-
 // ======================================
 // ===== Miscellaneous Instructions =====
 // ======================================
 
-void CentralProcessingUnit::unused_opcode() const
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::unused_opcode() const
 {
     std::cerr << std::hex << std::setfill('0');
     std::cerr << "Warning: Unused opcode 0x" << std::setw(2) 
@@ -1349,13 +1306,15 @@ void CentralProcessingUnit::unused_opcode() const
               << static_cast<int>(register_file.program_counter - 1) << "\n";
 }
 
-void CentralProcessingUnit::rotate_left_circular_a_0x07()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::rotate_left_circular_a_0x07()
 {
     rotate_left_circular(register_file.A);
     update_flag(register_file.flags, ZERO_FLAG_MASK, false);
 }
 
-void CentralProcessingUnit::load_memory_immediate16_stack_pointer_0x08()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::load_memory_immediate16_stack_pointer_0x08()
 {
     uint16_t immediate16 = fetch_immediate16_and_step_emulator_components();
     const uint8_t stack_pointer_low_byte = static_cast<uint8_t>(register_file.stack_pointer & 0xFF);
@@ -1364,25 +1323,29 @@ void CentralProcessingUnit::load_memory_immediate16_stack_pointer_0x08()
     write_byte_and_step_emulator_components(immediate16 + 1, stack_pointer_high_byte);
 }
 
-void CentralProcessingUnit::rotate_right_circular_a_0x0F()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::rotate_right_circular_a_0x0F()
 {
     rotate_right_circular(register_file.A);
     update_flag(register_file.flags, ZERO_FLAG_MASK, false);
 }
 
-void CentralProcessingUnit::rotate_left_through_carry_a_0x17()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::rotate_left_through_carry_a_0x17()
 {
     rotate_left_through_carry(register_file.A);
     update_flag(register_file.flags, ZERO_FLAG_MASK, false);
 }
 
-void CentralProcessingUnit::rotate_right_through_carry_a_0x1F()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::rotate_right_through_carry_a_0x1F()
 {
     rotate_right_through_carry(register_file.A);
     update_flag(register_file.flags, ZERO_FLAG_MASK, false);
 }
 
-void CentralProcessingUnit::decimal_adjust_a_0x27()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::decimal_adjust_a_0x27()
 {
     const bool was_addition_most_recent = !is_flag_set(register_file.flags, SUBTRACT_FLAG_MASK);
     bool does_carry_occur = false;
@@ -1405,52 +1368,59 @@ void CentralProcessingUnit::decimal_adjust_a_0x27()
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::complement_a_0x2F()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::complement_a_0x2F()
 {
     register_file.A = ~register_file.A;
     update_flag(register_file.flags, SUBTRACT_FLAG_MASK, true);
     update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, true);
 }
 
-void CentralProcessingUnit::set_carry_flag_0x37()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::set_carry_flag_0x37()
 {
     update_flag(register_file.flags, SUBTRACT_FLAG_MASK, false);
     update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, false);
     update_flag(register_file.flags, CARRY_FLAG_MASK, true);
 }
 
-void CentralProcessingUnit::complement_carry_flag_0x3F()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::complement_carry_flag_0x3F()
 {
     update_flag(register_file.flags, SUBTRACT_FLAG_MASK, false);
     update_flag(register_file.flags, HALF_CARRY_FLAG_MASK, false);
     update_flag(register_file.flags, CARRY_FLAG_MASK, !is_flag_set(register_file.flags, CARRY_FLAG_MASK));
 }
 
-void CentralProcessingUnit::halt_0x76()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::halt_0x76()
 {
     is_halted = true;
 }
 
-void CentralProcessingUnit::return_0xC9()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::return_0xC9()
 {
     uint16_t stack_top = 0;
     pop_stack(stack_top);
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
     register_file.program_counter = stack_top;
 }
 
-void CentralProcessingUnit::return_from_interrupt_0xD9()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::return_from_interrupt_0xD9()
 {
     return_0xC9();
     interrupt_master_enable_ime = InterruptMasterEnableState::Enabled;
 }
 
-void CentralProcessingUnit::add_stack_pointer_signed_immediate8_0xE8()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::add_stack_pointer_signed_immediate8_0xE8()
 {
     // Carries are based on the unsigned immediate byte while the result is based on its signed equivalent
     const uint8_t unsigned_offset = fetch_immediate8_and_step_emulator_components();
-    emulator_step_single_machine_cycle_callback();
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
+    system_bus.step_single_machine_cycle();
     const bool does_half_carry_occur = (register_file.stack_pointer & 0x0F) + (unsigned_offset & 0x0F) > 0x0F;
     const bool does_carry_occur = (register_file.stack_pointer & 0xFF) + (unsigned_offset & 0xFF) > 0xFF;
     register_file.stack_pointer += static_cast<int8_t>(unsigned_offset);
@@ -1460,27 +1430,31 @@ void CentralProcessingUnit::add_stack_pointer_signed_immediate8_0xE8()
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
  }
 
-void CentralProcessingUnit::jump_hl_0xE9()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::jump_hl_0xE9()
 {
     register_file.program_counter = register_file.HL;
 }
 
-void CentralProcessingUnit::pop_stack_af_0xF1()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::pop_stack_af_0xF1()
 {
     pop_stack(register_file.AF);
     register_file.flags &= 0xF0; // Lower nibble of flags must always be zeroed
 }
 
-void CentralProcessingUnit::disable_interrupts_0xF3()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::disable_interrupts_0xF3()
 {
     interrupt_master_enable_ime = InterruptMasterEnableState::Disabled;
 }
 
-void CentralProcessingUnit::load_hl_stack_pointer_with_signed_offset_0xF8()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::load_hl_stack_pointer_with_signed_offset_0xF8()
 {
     // Carries are based on the unsigned immediate byte while the result is based on its signed equivalent
     const uint8_t unsigned_offset = fetch_immediate8_and_step_emulator_components();
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
     const bool does_half_carry_occur = (register_file.stack_pointer & 0x0F) + (unsigned_offset & 0x0F) > 0x0F;
     const bool does_carry_occur = (register_file.stack_pointer & 0xFF) + (unsigned_offset & 0xFF) > 0xFF;
     register_file.HL = register_file.stack_pointer + static_cast<int8_t>(unsigned_offset);
@@ -1490,16 +1464,21 @@ void CentralProcessingUnit::load_hl_stack_pointer_with_signed_offset_0xF8()
     update_flag(register_file.flags, CARRY_FLAG_MASK, does_carry_occur);
 }
 
-void CentralProcessingUnit::load_stack_pointer_hl_0xF9()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::load_stack_pointer_hl_0xF9()
 {
-    emulator_step_single_machine_cycle_callback();
+    system_bus.step_single_machine_cycle();
     register_file.stack_pointer = register_file.HL;
 }
 
-void CentralProcessingUnit::enable_interrupts_0xFB()
+template <typename SystemBus>
+void CentralProcessingUnit<SystemBus>::enable_interrupts_0xFB()
 {
     if (interrupt_master_enable_ime == InterruptMasterEnableState::Disabled)
         interrupt_master_enable_ime = InterruptMasterEnableState::WillEnable;
 }
 
+template class CentralProcessingUnit<EmulatorSystemBus>;
+template class CentralProcessingUnit<CallbackSystemBus>;
+
 } // namespace GameBoyEmulator
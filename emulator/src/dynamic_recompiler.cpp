@@ -0,0 +1,886 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DYNAMIC_RECOMPILER_X86_64
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#endif
+
+#include "dynamic_recompiler.h"
+#include "memory_management_unit.h"
+
+namespace GameBoyEmulator
+{
+
+#if defined(DYNAMIC_RECOMPILER_X86_64)
+
+namespace
+{
+
+constexpr size_t TRANSLATED_CODE_ALIGNMENT = 16;
+constexpr size_t EXECUTABLE_MEMORY_PAGE_SIZE = 4096;
+constexpr uint8_t INSTRUCTION_PREFIX_OPCODE = 0xCB;
+constexpr uint8_t MEMORY_HL_REGISTER_INDEX = 0b110;
+
+// x86-64 is little-endian, so the translated code addresses registers at their offsets in the little-endian register file
+using LittleEndianRegisterFile = RegisterFile<std::endian::little>;
+static_assert(std::endian::native == std::endian::little);
+
+constexpr uint8_t FLAGS_OFFSET = offsetof(LittleEndianRegisterFile, flags);
+constexpr uint8_t A_OFFSET = offsetof(LittleEndianRegisterFile, A);
+constexpr uint8_t HL_OFFSET = offsetof(LittleEndianRegisterFile, HL);
+constexpr uint8_t STACK_POINTER_OFFSET = offsetof(LittleEndianRegisterFile, stack_pointer);
+constexpr uint8_t PROGRAM_COUNTER_OFFSET = offsetof(LittleEndianRegisterFile, program_counter);
+
+// Indexed the same way as the register operands of opcodes: B, C, D, E, H, L, (HL), A
+constexpr std::array<uint8_t, 8> REGISTER_OFFSETS
+{
+    offsetof(LittleEndianRegisterFile, B), offsetof(LittleEndianRegisterFile, C),
+    offsetof(LittleEndianRegisterFile, D), offsetof(LittleEndianRegisterFile, E),
+    offsetof(LittleEndianRegisterFile, H), offsetof(LittleEndianRegisterFile, L),
+    0, offsetof(LittleEndianRegisterFile, A)
+};
+
+// BC, DE, HL, SP
+constexpr std::array<uint8_t, 4> REGISTER_PAIR_OFFSETS
+{
+    offsetof(LittleEndianRegisterFile, BC), offsetof(LittleEndianRegisterFile, DE),
+    offsetof(LittleEndianRegisterFile, HL), offsetof(LittleEndianRegisterFile, stack_pointer)
+};
+
+constexpr uint8_t HOST_CARRY_FLAG_MASK = 1 << 0;
+constexpr uint8_t HOST_AUXILIARY_CARRY_FLAG_MASK = 1 << 4;
+constexpr uint8_t HOST_ZERO_FLAG_MASK = 1 << 6;
+
+// The host carry, auxiliary carry and zero flags of 8-bit additions, subtractions, increments and decrements match C, H and Z
+constexpr std::array<uint8_t, 0x100> create_flags_from_host_flags_table()
+{
+    std::array<uint8_t, 0x100> flags_from_host_flags{};
+    for (uint16_t host_flags = 0; host_flags < 0x100; host_flags++)
+    {
+        flags_from_host_flags[host_flags] = static_cast<uint8_t>(
+            ((host_flags & HOST_ZERO_FLAG_MASK) ? ZERO_FLAG_MASK : 0) |
+            ((host_flags & HOST_AUXILIARY_CARRY_FLAG_MASK) ? HALF_CARRY_FLAG_MASK : 0) |
+            ((host_flags & HOST_CARRY_FLAG_MASK) ? CARRY_FLAG_MASK : 0));
+    }
+    return flags_from_host_flags;
+}
+
+alignas(64) constexpr std::array<uint8_t, 0x100> FLAGS_FROM_HOST_FLAGS = create_flags_from_host_flags_table();
+
+enum class InstructionTranslation
+{
+    Untranslatable,
+    Translated,
+    EndsBlock
+};
+
+// Emits one function per block. rbx holds the register file, r12 and r13 the read and write page tables, r14 the flag table,
+// r15d the machine cycles of completed loop iterations and ebp the machine cycle budget. eax, ecx and edx are scratch
+class BlockTranslator
+{
+public:
+    BlockTranslator(uint16_t start_address, uint32_t end_address, const uint8_t* const* read_memory_pages)
+        : start_address{start_address},
+          end_address{end_address},
+          read_memory_pages{read_memory_pages}
+    {
+    }
+
+    bool translate()
+    {
+        emit_prologue();
+        loop_start_position = code.size();
+
+        uint16_t address = start_address;
+        uint32_t machine_cycles = 0;
+        while (true)
+        {
+            instruction_address = address;
+            machine_cycles_before_instruction = machine_cycles;
+            const InstructionTranslation instruction_translation = (address - start_address < MAX_TRANSLATED_BLOCK_SIZE)
+                ? translate_instruction()
+                : InstructionTranslation::Untranslatable;
+
+            if (instruction_translation == InstructionTranslation::EndsBlock)
+                break;
+            if (instruction_translation == InstructionTranslation::Untranslatable)
+            {
+                if (address == start_address)
+                    return false;
+                emit_exit(address, machine_cycles);
+                break;
+            }
+            address += instruction_length;
+            machine_cycles += instruction_machine_cycles;
+        }
+
+        for (const SideExit& side_exit : side_exits)
+        {
+            patch_rel32(side_exit.jump_position, code.size());
+            emit_exit(side_exit.program_counter, side_exit.machine_cycles);
+        }
+        return true;
+    }
+
+    const std::vector<uint8_t>& get_code() const
+    {
+        return code;
+    }
+
+    uint32_t get_max_machine_cycles() const
+    {
+        return max_machine_cycles;
+    }
+
+private:
+    struct SideExit
+    {
+        size_t jump_position{};
+        uint16_t program_counter{};
+        uint32_t machine_cycles{};
+    };
+
+    const uint16_t start_address;
+    const uint32_t end_address;
+    const uint8_t* const* const read_memory_pages;
+
+    std::vector<uint8_t> code{};
+    std::vector<SideExit> side_exits{};
+    size_t loop_start_position{};
+    uint32_t max_machine_cycles{};
+
+    uint16_t instruction_address{};
+    uint32_t machine_cycles_before_instruction{};
+    uint8_t instruction_length{};
+    uint8_t instruction_machine_cycles{};
+
+    bool try_read_instruction_byte(uint8_t offset, uint8_t& value) const
+    {
+        const uint32_t address = instruction_address + offset;
+        if (address >= end_address)
+            return false;
+
+        const uint8_t* read_memory_page = read_memory_pages[address >> MEMORY_PAGE_SIZE_POWER_OF_TWO];
+        if (read_memory_page == nullptr)
+            return false;
+
+        value = read_memory_page[address & (MEMORY_PAGE_SIZE - 1)];
+        return true;
+    }
+
+    // Decides whether the instruction is translated before emitting anything for it
+    InstructionTranslation translate_instruction()
+    {
+        uint8_t opcode{};
+        uint8_t immediate_low{};
+        uint8_t immediate_high{};
+        if (!try_read_instruction_byte(0, opcode))
+            return InstructionTranslation::Untranslatable;
+
+        const uint8_t destination_index = (opcode >> 3) & 0b111;
+        const uint8_t source_index = opcode & 0b111;
+        const uint8_t register_pair_offset = REGISTER_PAIR_OFFSETS[(opcode >> 4) & 0b11];
+        const bool has_immediate8 = ((opcode & 0b11000111) == 0x06) || ((opcode & 0b11000111) == 0xC6) ||
+                                    ((opcode & 0b11100111) == 0x20) || opcode == 0x18 || opcode == INSTRUCTION_PREFIX_OPCODE;
+        const bool has_immediate16 = ((opcode & 0b11001111) == 0x01) || ((opcode & 0b11100111) == 0xC2) ||
+                                     opcode == 0xC3 || opcode == 0xEA || opcode == 0xFA;
+        instruction_length = has_immediate16 ? 3 : (has_immediate8 ? 2 : 1);
+
+        const bool are_immediates_readable = (instruction_length < 2 || try_read_instruction_byte(1, immediate_low)) &&
+                                             (instruction_length < 3 || try_read_instruction_byte(2, immediate_high));
+        if (!are_immediates_readable)
+            return InstructionTranslation::Untranslatable;
+
+        const uint16_t immediate16 = static_cast<uint16_t>((immediate_high << 8) | immediate_low);
+        const uint16_t next_instruction_address = instruction_address + instruction_length;
+
+        if (opcode == 0x00)
+        {
+            instruction_machine_cycles = 1;
+        }
+        else if ((opcode & 0b11001111) == 0x01)
+        {
+            instruction_machine_cycles = 3;
+            emit_store_immediate16_to_register_pair(register_pair_offset, immediate16);
+        }
+        else if (opcode == 0x02 || opcode == 0x12 || opcode == 0x22 || opcode == 0x32)
+        {
+            instruction_machine_cycles = 2;
+            emit_load_register_pair_to_eax((opcode < 0x20) ? register_pair_offset : HL_OFFSET);
+            emit_write_register_to_memory_at_eax(A_OFFSET);
+            emit_post_increment_or_decrement_hl(opcode);
+        }
+        else if (opcode == 0x0A || opcode == 0x1A || opcode == 0x2A || opcode == 0x3A)
+        {
+            instruction_machine_cycles = 2;
+            emit_load_register_pair_to_eax((opcode < 0x20) ? register_pair_offset : HL_OFFSET);
+            emit_read_memory_at_eax_to_eax();
+            emit_store_al_to_register(A_OFFSET);
+            emit_post_increment_or_decrement_hl(opcode);
+        }
+        else if ((opcode & 0b11000111) == 0x03)
+        {
+            instruction_machine_cycles = 2;
+            // inc word [rbx + rr] / dec word [rbx + rr]
+            emit({0x66, 0xFF, static_cast<uint8_t>(((opcode & 0b1000) != 0) ? 0x4B : 0x43), register_pair_offset});
+        }
+        else if ((opcode & 0b11000110) == 0x04 && destination_index != MEMORY_HL_REGISTER_INDEX)
+        {
+            instruction_machine_cycles = 1;
+            emit_increment_or_decrement_register(REGISTER_OFFSETS[destination_index], (opcode & 1) != 0);
+        }
+        else if ((opcode & 0b11000111) == 0x06)
+        {
+            if (destination_index == MEMORY_HL_REGISTER_INDEX)
+            {
+                instruction_machine_cycles = 3;
+                emit_load_register_pair_to_eax(HL_OFFSET);
+                emit_write_immediate_to_memory_at_eax(immediate_low);
+            }
+            else
+            {
+                instruction_machine_cycles = 2;
+                // mov byte [rbx + r], n
+                emit({0xC6, 0x43, REGISTER_OFFSETS[destination_index], immediate_low});
+            }
+        }
+        else if (opcode == 0x07 || opcode == 0x0F || opcode == 0x17 || opcode == 0x1F)
+        {
+            instruction_machine_cycles = 1;
+            emit_rotate_a(opcode);
+        }
+        else if ((opcode & 0b11001111) == 0x09)
+        {
+            instruction_machine_cycles = 2;
+            emit_add_hl(register_pair_offset);
+        }
+        else if (opcode == 0x2F)
+        {
+            instruction_machine_cycles = 1;
+            // not byte [rbx + A]; or byte [rbx + F], N | H
+            emit({0xF6, 0x53, A_OFFSET});
+            emit({0x80, 0x4B, FLAGS_OFFSET, SUBTRACT_FLAG_MASK | HALF_CARRY_FLAG_MASK});
+        }
+        else if (opcode == 0x37)
+        {
+            instruction_machine_cycles = 1;
+            // and byte [rbx + F], Z; or byte [rbx + F], C
+            emit({0x80, 0x63, FLAGS_OFFSET, ZERO_FLAG_MASK});
+            emit({0x80, 0x4B, FLAGS_OFFSET, CARRY_FLAG_MASK});
+        }
+        else if (opcode == 0x3F)
+        {
+            instruction_machine_cycles = 1;
+            // and byte [rbx + F], Z | C; xor byte [rbx + F], C
+            emit({0x80, 0x63, FLAGS_OFFSET, ZERO_FLAG_MASK | CARRY_FLAG_MASK});
+            emit({0x80, 0x73, FLAGS_OFFSET, CARRY_FLAG_MASK});
+        }
+        else if (opcode >= 0x40 && opcode <= 0x7F && opcode != 0x76)
+        {
+            instruction_machine_cycles = (destination_index == MEMORY_HL_REGISTER_INDEX || source_index == MEMORY_HL_REGISTER_INDEX) ? 2 : 1;
+            emit_load(destination_index, source_index);
+        }
+        else if (opcode >= 0x80 && opcode <= 0xBF)
+        {
+            if (source_index == MEMORY_HL_REGISTER_INDEX)
+            {
+                instruction_machine_cycles = 2;
+                emit_load_register_pair_to_eax(HL_OFFSET);
+                emit_read_memory_at_eax_to_eax();
+                // mov ecx, eax
+                emit({0x89, 0xC1});
+            }
+            else
+            {
+                instruction_machine_cycles = 1;
+                // mov cl, [rbx + r]
+                emit({0x8A, 0x4B, REGISTER_OFFSETS[source_index]});
+            }
+            emit_arithmetic_logic_operation_a(destination_index);
+        }
+        else if ((opcode & 0b11000111) == 0xC6)
+        {
+            instruction_machine_cycles = 2;
+            // mov cl, n
+            emit({0xB1, immediate_low});
+            emit_arithmetic_logic_operation_a(destination_index);
+        }
+        else if (opcode == 0xEA || opcode == 0xFA)
+        {
+            instruction_machine_cycles = 4;
+            emit_load_immediate_to_eax(immediate16);
+            if (opcode == 0xEA)
+            {
+                emit_write_register_to_memory_at_eax(A_OFFSET);
+            }
+            else
+            {
+                emit_read_memory_at_eax_to_eax();
+                emit_store_al_to_register(A_OFFSET);
+            }
+        }
+        else if (opcode == 0xF9)
+        {
+            instruction_machine_cycles = 2;
+            // movzx eax, word [rbx + HL]; mov [rbx + SP], ax
+            emit({0x0F, 0xB7, 0x43, HL_OFFSET});
+            emit({0x66, 0x89, 0x43, STACK_POINTER_OFFSET});
+        }
+        else if (opcode == INSTRUCTION_PREFIX_OPCODE)
+        {
+            if ((immediate_low & 0b111) == MEMORY_HL_REGISTER_INDEX)
+                return InstructionTranslation::Untranslatable;
+            instruction_machine_cycles = 2;
+            emit_prefixed_operation(immediate_low);
+        }
+        else if (opcode == 0x18)
+        {
+            emit_jump(static_cast<uint16_t>(next_instruction_address + static_cast<int8_t>(immediate_low)), 3);
+            return InstructionTranslation::EndsBlock;
+        }
+        else if ((opcode & 0b11100111) == 0x20)
+        {
+            emit_conditional_jump(destination_index & 0b11, static_cast<uint16_t>(next_instruction_address + static_cast<int8_t>(immediate_low)), 3, next_instruction_address, 2);
+            return InstructionTranslation::EndsBlock;
+        }
+        else if (opcode == 0xC3)
+        {
+            emit_jump(immediate16, 4);
+            return InstructionTranslation::EndsBlock;
+        }
+        else if ((opcode & 0b11100111) == 0xC2)
+        {
+            emit_conditional_jump(destination_index & 0b11, immediate16, 4, next_instruction_address, 3);
+            return InstructionTranslation::EndsBlock;
+        }
+        else if (opcode == 0xE9)
+        {
+            // movzx eax, word [rbx + HL]; mov [rbx + PC], ax
+            emit({0x0F, 0xB7, 0x43, HL_OFFSET});
+            emit({0x66, 0x89, 0x43, PROGRAM_COUNTER_OFFSET});
+            emit_return(machine_cycles_before_instruction + 1);
+            return InstructionTranslation::EndsBlock;
+        }
+        else
+            return InstructionTranslation::Untranslatable;
+
+        return InstructionTranslation::Translated;
+    }
+
+    void emit(std::initializer_list<uint8_t> bytes)
+    {
+        code.insert(code.end(), bytes);
+    }
+
+    void emit_immediate(uint64_t value, uint8_t size)
+    {
+        for (uint8_t i = 0; i < size; i++)
+        {
+            code.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    size_t emit_rel32_placeholder()
+    {
+        const size_t position = code.size();
+        emit_immediate(0, 4);
+        return position;
+    }
+
+    void patch_rel32(size_t position, size_t target_position)
+    {
+        const int32_t displacement = static_cast<int32_t>(static_cast<int64_t>(target_position) - static_cast<int64_t>(position + 4));
+        std::memcpy(&code[position], &displacement, sizeof(displacement));
+    }
+
+    void emit_prologue()
+    {
+        // push rbx; push rbp; push r12; push r13; push r14; push r15
+        emit({0x53, 0x55, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57});
+#ifdef _WIN32
+        // mov rbx, rcx; mov r12, rdx; mov r13, r8; mov ebp, r9d
+        emit({0x48, 0x89, 0xCB, 0x49, 0x89, 0xD4, 0x4D, 0x89, 0xC5, 0x44, 0x89, 0xCD});
+#else
+        // mov rbx, rdi; mov r12, rsi; mov r13, rdx; mov ebp, ecx
+        emit({0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4, 0x49, 0x89, 0xD5, 0x89, 0xCD});
+#endif
+        // mov r14, FLAGS_FROM_HOST_FLAGS; xor r15d, r15d
+        emit({0x49, 0xBE});
+        emit_immediate(reinterpret_cast<uint64_t>(FLAGS_FROM_HOST_FLAGS.data()), 8);
+        emit({0x45, 0x31, 0xFF});
+    }
+
+    void emit_return(uint32_t machine_cycles)
+    {
+        max_machine_cycles = std::max(max_machine_cycles, machine_cycles);
+        // lea eax, [r15 + machine_cycles]
+        emit({0x41, 0x8D, 0x87});
+        emit_immediate(machine_cycles, 4);
+        // pop r15; pop r14; pop r13; pop r12; pop rbp; pop rbx; ret
+        emit({0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5D, 0x5B, 0xC3});
+    }
+
+    void emit_exit(uint16_t program_counter, uint32_t machine_cycles)
+    {
+        // mov word [rbx + PC], program_counter
+        emit({0x66, 0xC7, 0x43, PROGRAM_COUNTER_OFFSET});
+        emit_immediate(program_counter, 2);
+        emit_return(machine_cycles);
+    }
+
+    // A jump back to the block start loops in place while another iteration, which takes at most as long as this one, fits the budget
+    void emit_jump(uint16_t target_address, uint32_t jump_machine_cycles)
+    {
+        const uint32_t machine_cycles = machine_cycles_before_instruction + jump_machine_cycles;
+        if (target_address != start_address)
+        {
+            emit_exit(target_address, machine_cycles);
+            return;
+        }
+
+        // add r15d, machine_cycles; lea eax, [r15 + machine_cycles]; cmp eax, ebp; ja exit; jmp loop_start
+        emit({0x41, 0x81, 0xC7});
+        emit_immediate(machine_cycles, 4);
+        emit({0x41, 0x8D, 0x87});
+        emit_immediate(machine_cycles, 4);
+        emit({0x39, 0xE8});
+        emit({0x0F, 0x87});
+        const size_t exit_jump_position = emit_rel32_placeholder();
+        emit({0xE9});
+        patch_rel32(emit_rel32_placeholder(), loop_start_position);
+        patch_rel32(exit_jump_position, code.size());
+        max_machine_cycles = std::max(max_machine_cycles, machine_cycles);
+        emit_exit(start_address, 0);
+    }
+
+    // Conditions are NZ, Z, NC and C
+    void emit_conditional_jump(
+        uint8_t condition_index,
+        uint16_t taken_address,
+        uint32_t taken_machine_cycles,
+        uint16_t not_taken_address,
+        uint32_t not_taken_machine_cycles)
+    {
+        const uint8_t flag_mask = (condition_index < 2) ? ZERO_FLAG_MASK : CARRY_FLAG_MASK;
+        const bool is_taken_when_flag_set = (condition_index & 1) != 0;
+        // test byte [rbx + F], flag_mask; jnz/jz taken
+        emit({0xF6, 0x43, FLAGS_OFFSET, flag_mask});
+        emit({0x0F, static_cast<uint8_t>(is_taken_when_flag_set ? 0x85 : 0x84)});
+        const size_t taken_jump_position = emit_rel32_placeholder();
+        emit_exit(not_taken_address, machine_cycles_before_instruction + not_taken_machine_cycles);
+        patch_rel32(taken_jump_position, code.size());
+        emit_jump(taken_address, taken_machine_cycles);
+    }
+
+    void emit_load_register_pair_to_eax(uint8_t register_pair_offset)
+    {
+        // movzx eax, word [rbx + rr]
+        emit({0x0F, 0xB7, 0x43, register_pair_offset});
+    }
+
+    void emit_load_immediate_to_eax(uint16_t value)
+    {
+        // mov eax, value
+        emit({0xB8});
+        emit_immediate(value, 4);
+    }
+
+    void emit_store_al_to_register(uint8_t register_offset)
+    {
+        // mov [rbx + r], al
+        emit({0x88, 0x43, register_offset});
+    }
+
+    void emit_store_immediate16_to_register_pair(uint8_t register_pair_offset, uint16_t value)
+    {
+        // mov word [rbx + rr], value
+        emit({0x66, 0xC7, 0x43, register_pair_offset});
+        emit_immediate(value, 2);
+    }
+
+    // Leaves the host address of the guest byte at eax in rdx + rcx, or leaves the block before this instruction when the page goes through the handlers
+    void emit_memory_page_lookup(bool is_write)
+    {
+        // mov ecx, eax; shr ecx, 8
+        emit({0x89, 0xC1, 0xC1, 0xE9, MEMORY_PAGE_SIZE_POWER_OF_TWO});
+        if (is_write)
+        {
+            // mov rdx, [r13 + rcx * 8]
+            emit({0x49, 0x8B, 0x54, 0xCD, 0x00});
+        }
+        else
+        {
+            // mov rdx, [r12 + rcx * 8]
+            emit({0x49, 0x8B, 0x14, 0xCC});
+        }
+        // test rdx, rdx; jz side_exit
+        emit({0x48, 0x85, 0xD2, 0x0F, 0x84});
+        side_exits.push_back(SideExit{emit_rel32_placeholder(), instruction_address, machine_cycles_before_instruction});
+        // movzx ecx, al
+        emit({0x0F, 0xB6, 0xC8});
+    }
+
+    void emit_read_memory_at_eax_to_eax()
+    {
+        emit_memory_page_lookup(false);
+        // movzx eax, byte [rdx + rcx]
+        emit({0x0F, 0xB6, 0x04, 0x0A});
+    }
+
+    void emit_write_register_to_memory_at_eax(uint8_t register_offset)
+    {
+        emit_memory_page_lookup(true);
+        // mov al, [rbx + r]; mov [rdx + rcx], al
+        emit({0x8A, 0x43, register_offset, 0x88, 0x04, 0x0A});
+    }
+
+    void emit_write_immediate_to_memory_at_eax(uint8_t value)
+    {
+        emit_memory_page_lookup(true);
+        // mov al, value; mov [rdx + rcx], al
+        emit({0xB0, value, 0x88, 0x04, 0x0A});
+    }
+
+    // LD (HL+),A, LD (HL-),A, LD A,(HL+) and LD A,(HL-)
+    void emit_post_increment_or_decrement_hl(uint8_t opcode)
+    {
+        if (opcode == 0x22 || opcode == 0x2A)
+        {
+            // inc word [rbx + HL]
+            emit({0x66, 0xFF, 0x43, HL_OFFSET});
+        }
+        else if (opcode == 0x32 || opcode == 0x3A)
+        {
+            // dec word [rbx + HL]
+            emit({0x66, 0xFF, 0x4B, HL_OFFSET});
+        }
+    }
+
+    void emit_load(uint8_t destination_index, uint8_t source_index)
+    {
+        if (source_index == MEMORY_HL_REGISTER_INDEX)
+        {
+            emit_load_register_pair_to_eax(HL_OFFSET);
+            emit_read_memory_at_eax_to_eax();
+            emit_store_al_to_register(REGISTER_OFFSETS[destination_index]);
+        }
+        else if (destination_index == MEMORY_HL_REGISTER_INDEX)
+        {
+            emit_load_register_pair_to_eax(HL_OFFSET);
+            emit_write_register_to_memory_at_eax(REGISTER_OFFSETS[source_index]);
+        }
+        else if (destination_index != source_index)
+        {
+            // mov al, [rbx + r']; mov [rbx + r], al
+            emit({0x8A, 0x43, REGISTER_OFFSETS[source_index]});
+            emit_store_al_to_register(REGISTER_OFFSETS[destination_index]);
+        }
+    }
+
+    void emit_load_flags_from_host_flags_to_dl()
+    {
+        // pushfq; pop rdx; movzx edx, dl; mov dl, [r14 + rdx]
+        emit({0x9C, 0x5A, 0x0F, 0xB6, 0xD2, 0x41, 0x8A, 0x14, 0x16});
+    }
+
+    void emit_load_carry_flag_to_host_carry()
+    {
+        // mov dl, [rbx + F]; shr dl, 5
+        emit({0x8A, 0x53, FLAGS_OFFSET, 0xC0, 0xEA, 0x05});
+    }
+
+    // ADD, ADC, SUB, SBC, AND, XOR, OR and CP of A with the operand in cl
+    void emit_arithmetic_logic_operation_a(uint8_t operation_index)
+    {
+        constexpr std::array<uint8_t, 8> HOST_OPCODES{0x00, 0x10, 0x28, 0x18, 0x20, 0x30, 0x08, 0x38};
+
+        // mov al, [rbx + A]
+        emit({0x8A, 0x43, A_OFFSET});
+        if (operation_index == 1 || operation_index == 3)
+        {
+            emit_load_carry_flag_to_host_carry();
+        }
+        // <operation> al, cl
+        emit({HOST_OPCODES[operation_index], 0xC8});
+        emit_load_flags_from_host_flags_to_dl();
+
+        if (operation_index == 2 || operation_index == 3 || operation_index == 7)
+        {
+            // or dl, N
+            emit({0x80, 0xCA, SUBTRACT_FLAG_MASK});
+        }
+        else if (operation_index >= 4 && operation_index <= 6)
+        {
+            // and dl, Z
+            emit({0x80, 0xE2, ZERO_FLAG_MASK});
+            if (operation_index == 4)
+            {
+                // or dl, H
+                emit({0x80, 0xCA, HALF_CARRY_FLAG_MASK});
+            }
+        }
+        if (operation_index != 7)
+        {
+            emit_store_al_to_register(A_OFFSET);
+        }
+        // mov [rbx + F], dl
+        emit({0x88, 0x53, FLAGS_OFFSET});
+    }
+
+    void emit_increment_or_decrement_register(uint8_t register_offset, bool is_decrement)
+    {
+        // inc byte [rbx + r] / dec byte [rbx + r]
+        emit({0xFE, static_cast<uint8_t>(is_decrement ? 0x4B : 0x43), register_offset});
+        emit_load_flags_from_host_flags_to_dl();
+        // and dl, Z | H; mov al, [rbx + F]; and al, C; or al, dl
+        emit({0x80, 0xE2, ZERO_FLAG_MASK | HALF_CARRY_FLAG_MASK});
+        emit({0x8A, 0x43, FLAGS_OFFSET, 0x24, CARRY_FLAG_MASK, 0x08, 0xD0});
+        if (is_decrement)
+        {
+            // or al, N
+            emit({0x0C, SUBTRACT_FLAG_MASK});
+        }
+        emit_store_al_to_register(FLAGS_OFFSET);
+    }
+
+    // RLCA, RRCA, RLA and RRA only set the carry flag
+    void emit_rotate_a(uint8_t opcode)
+    {
+        if (opcode == 0x17 || opcode == 0x1F)
+        {
+            emit_load_carry_flag_to_host_carry();
+        }
+        // rol/ror/rcl/rcr byte [rbx + A], 1
+        const uint8_t host_operation = static_cast<uint8_t>(0x43 | ((opcode >> 3) << 3));
+        emit({0xD0, host_operation, A_OFFSET});
+        // setc al; shl al, 4
+        emit({0x0F, 0x92, 0xC0, 0xC0, 0xE0, 0x04});
+        emit_store_al_to_register(FLAGS_OFFSET);
+    }
+
+    void emit_add_hl(uint8_t register_pair_offset)
+    {
+        // movzx eax, word [rbx + HL]; movzx ecx, word [rbx + rr]
+        emit({0x0F, 0xB7, 0x43, HL_OFFSET, 0x0F, 0xB7, 0x4B, register_pair_offset});
+        // mov edx, eax; xor edx, ecx; add eax, ecx; xor edx, eax; mov [rbx + HL], ax
+        emit({0x89, 0xC2, 0x31, 0xCA, 0x01, 0xC8, 0x31, 0xC2, 0x66, 0x89, 0x43, HL_OFFSET});
+        // The carry into bit 12 is H and the carry out of bit 15 is C: shr edx, 7; and edx, H; shr eax, 12; and eax, C; or eax, edx
+        emit({0xC1, 0xEA, 0x07, 0x83, 0xE2, HALF_CARRY_FLAG_MASK, 0xC1, 0xE8, 0x0C, 0x83, 0xE0, CARRY_FLAG_MASK, 0x09, 0xD0});
+        // mov dl, [rbx + F]; and dl, Z; or al, dl
+        emit({0x8A, 0x53, FLAGS_OFFSET, 0x80, 0xE2, ZERO_FLAG_MASK, 0x08, 0xD0});
+        emit_store_al_to_register(FLAGS_OFFSET);
+    }
+
+    // Prefixed operations on registers other than (HL)
+    void emit_prefixed_operation(uint8_t prefixed_opcode)
+    {
+        const uint8_t register_offset = REGISTER_OFFSETS[prefixed_opcode & 0b111];
+        const uint8_t bit_mask = static_cast<uint8_t>(1 << ((prefixed_opcode >> 3) & 0b111));
+
+        if (prefixed_opcode >= 0x40 && prefixed_opcode <= 0x7F)
+        {
+            // test byte [rbx + r], bit_mask; setz al; shl al, 7; or al, H
+            emit({0xF6, 0x43, register_offset, bit_mask, 0x0F, 0x94, 0xC0, 0xC0, 0xE0, 0x07, 0x0C, HALF_CARRY_FLAG_MASK});
+            // mov dl, [rbx + F]; and dl, C; or al, dl
+            emit({0x8A, 0x53, FLAGS_OFFSET, 0x80, 0xE2, CARRY_FLAG_MASK, 0x08, 0xD0});
+            emit_store_al_to_register(FLAGS_OFFSET);
+            return;
+        }
+        if (prefixed_opcode >= 0x80)
+        {
+            // and byte [rbx + r], ~bit_mask / or byte [rbx + r], bit_mask
+            const bool is_set = prefixed_opcode >= 0xC0;
+            emit({0x80, static_cast<uint8_t>(is_set ? 0x4B : 0x63), register_offset, static_cast<uint8_t>(is_set ? bit_mask : ~bit_mask)});
+            return;
+        }
+
+        // RLC, RRC, RL, RR, SLA, SRA, SWAP and SRL as rol, ror, rcl, rcr, shl, sar, rol by 4 and shr
+        constexpr std::array<uint8_t, 8> HOST_OPERATION_MODRM_BYTES{0xC0, 0xC8, 0xD0, 0xD8, 0xE0, 0xF8, 0xC0, 0xE8};
+        const uint8_t operation_index = prefixed_opcode >> 3;
+
+        // movzx eax, byte [rbx + r]
+        emit({0x0F, 0xB6, 0x43, register_offset});
+        if (operation_index == 2 || operation_index == 3)
+        {
+            emit_load_carry_flag_to_host_carry();
+        }
+        if (operation_index == 6)
+        {
+            // rol al, 4; clc
+            emit({0xC0, 0xC0, 0x04, 0xF8});
+        }
+        else
+        {
+            // <operation> al, 1
+            emit({0xD0, HOST_OPERATION_MODRM_BYTES[operation_index]});
+        }
+        // setc dl; mov [rbx + r], al; test al, al; setz cl; shl dl, 4; shl cl, 7; or dl, cl; mov [rbx + F], dl
+        emit({0x0F, 0x92, 0xC2});
+        emit_store_al_to_register(register_offset);
+        emit({0x84, 0xC0, 0x0F, 0x94, 0xC1, 0xC0, 0xE2, 0x04, 0xC0, 0xE1, 0x07, 0x08, 0xCA, 0x88, 0x53, FLAGS_OFFSET});
+    }
+};
+
+// The buffer is never writable and executable at once. It is mapped read/write, and the pages a block is copied into
+// are made executable once the copy is done
+uint8_t* allocate_executable_memory(size_t size)
+{
+#ifdef _WIN32
+    return static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+#else
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (memory == MAP_FAILED) ? nullptr : static_cast<uint8_t*>(memory);
+#endif
+}
+
+bool set_executable_memory_writable(uint8_t* memory, size_t size, bool is_writable)
+{
+#ifdef _WIN32
+    DWORD previous_protection;
+    if (!VirtualProtect(memory, size, is_writable ? PAGE_READWRITE : PAGE_EXECUTE_READ, &previous_protection))
+        return false;
+    return is_writable || FlushInstructionCache(GetCurrentProcess(), memory, size);
+#else
+    return mprotect(memory, size, is_writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) == 0;
+#endif
+}
+
+void free_executable_memory(uint8_t* memory, size_t size)
+{
+#ifdef _WIN32
+    static_cast<void>(size);
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, size);
+#endif
+}
+
+} // namespace
+
+#endif
+
+DynamicRecompiler::~DynamicRecompiler()
+{
+#if defined(DYNAMIC_RECOMPILER_X86_64)
+    if (translated_code != nullptr)
+    {
+        free_executable_memory(translated_code, TRANSLATED_CODE_BUFFER_SIZE);
+    }
+#endif
+}
+
+bool DynamicRecompiler::is_supported()
+{
+#if defined(DYNAMIC_RECOMPILER_X86_64)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Translations of the previously mapped banks are kept, the indices of the new ones are looked up on first use
+void DynamicRecompiler::map_rom_banks(uint16_t rom_bank_x0_number, uint16_t rom_bank_0x_number)
+{
+    const std::array<uint16_t, NUMBER_OF_ROM_BANK_WINDOWS> rom_bank_numbers{rom_bank_x0_number, rom_bank_0x_number};
+    for (uint8_t rom_bank_window = 0; rom_bank_window < NUMBER_OF_ROM_BANK_WINDOWS; rom_bank_window++)
+    {
+        if (mapped_rom_bank_numbers[rom_bank_window] != rom_bank_numbers[rom_bank_window])
+        {
+            mapped_rom_bank_numbers[rom_bank_window] = rom_bank_numbers[rom_bank_window];
+            mapped_translated_block_indices[rom_bank_window] = nullptr;
+        }
+    }
+}
+
+void DynamicRecompiler::clear()
+{
+    translated_code_size = 0;
+    translated_blocks.clear();
+    translated_block_indices_by_rom_bank.clear();
+    mapped_translated_block_indices.fill(nullptr);
+}
+
+uint32_t* DynamicRecompiler::get_translated_block_indices(uint8_t rom_bank_window)
+{
+    uint32_t*& translated_block_indices = mapped_translated_block_indices[rom_bank_window];
+    if (translated_block_indices == nullptr)
+    {
+        const uint32_t rom_bank_key = (static_cast<uint32_t>(rom_bank_window) << 16) | mapped_rom_bank_numbers[rom_bank_window];
+        std::unique_ptr<uint32_t[]>& rom_bank_translated_block_indices = translated_block_indices_by_rom_bank[rom_bank_key];
+        if (rom_bank_translated_block_indices == nullptr)
+        {
+            rom_bank_translated_block_indices = std::make_unique<uint32_t[]>(ROM_BANK_SIZE);
+        }
+        translated_block_indices = rom_bank_translated_block_indices.get();
+    }
+    return translated_block_indices;
+}
+
+const TranslatedBlock* DynamicRecompiler::find_or_translate_block(uint16_t address, const uint8_t* const* read_memory_pages)
+{
+#if defined(DYNAMIC_RECOMPILER_X86_64)
+    const uint8_t rom_bank_window = address >> ROM_BANK_SIZE_POWER_OF_TWO;
+    const uint16_t offset_within_rom_bank = address & (ROM_BANK_SIZE - 1);
+    const uint32_t translated_block_index = get_translated_block_indices(rom_bank_window)[offset_within_rom_bank];
+    if (translated_block_index == UNTRANSLATABLE_BLOCK_INDEX)
+        return nullptr;
+    if (translated_block_index != UNTRANSLATED_BLOCK_INDEX)
+        return &translated_blocks[translated_block_index - 1];
+
+    // A failed allocation is not retried, everything is left to the interpreter from then on
+    if (translated_code == nullptr && !has_executable_memory_allocation_failed)
+    {
+        translated_code = allocate_executable_memory(TRANSLATED_CODE_BUFFER_SIZE);
+        has_executable_memory_allocation_failed = translated_code == nullptr;
+    }
+
+    BlockTranslator block_translator{address, static_cast<uint32_t>(rom_bank_window + 1) * ROM_BANK_SIZE, read_memory_pages};
+    if (translated_code == nullptr || !block_translator.translate())
+    {
+        get_translated_block_indices(rom_bank_window)[offset_within_rom_bank] = UNTRANSLATABLE_BLOCK_INDEX;
+        return nullptr;
+    }
+
+    // Everything is translated again once the buffer is full
+    const std::vector<uint8_t>& code = block_translator.get_code();
+    if (translated_code_size + code.size() > TRANSLATED_CODE_BUFFER_SIZE)
+    {
+        clear();
+    }
+    uint8_t* first_page = translated_code + (translated_code_size & ~(EXECUTABLE_MEMORY_PAGE_SIZE - 1));
+    const size_t pages_size = ((translated_code_size + code.size() + EXECUTABLE_MEMORY_PAGE_SIZE - 1) & ~(EXECUTABLE_MEMORY_PAGE_SIZE - 1)) -
+                              static_cast<size_t>(first_page - translated_code);
+    if (!set_executable_memory_writable(first_page, pages_size, true))
+    {
+        get_translated_block_indices(rom_bank_window)[offset_within_rom_bank] = UNTRANSLATABLE_BLOCK_INDEX;
+        return nullptr;
+    }
+    std::memcpy(translated_code + translated_code_size, code.data(), code.size());
+    if (!set_executable_memory_writable(first_page, pages_size, false))
+    {
+        get_translated_block_indices(rom_bank_window)[offset_within_rom_bank] = UNTRANSLATABLE_BLOCK_INDEX;
+        return nullptr;
+    }
+    translated_blocks.push_back(TranslatedBlock{
+        reinterpret_cast<TranslatedBlockFunction>(translated_code + translated_code_size),
+        block_translator.get_max_machine_cycles()});
+    translated_code_size = (translated_code_size + code.size() + TRANSLATED_CODE_ALIGNMENT - 1) & ~(TRANSLATED_CODE_ALIGNMENT - 1);
+    get_translated_block_indices(rom_bank_window)[offset_within_rom_bank] = static_cast<uint32_t>(translated_blocks.size());
+    return &translated_blocks.back();
+#else
+    static_cast<void>(address);
+    static_cast<void>(read_memory_pages);
+    return nullptr;
+#endif
+}
+
+} // namespace GameBoyEmulator
@@ -10,18 +10,18 @@ namespace GameBoyEmulator
 {
 
 Emulator::Emulator()
-    : internal_timer{[this](uint8_t interrupt_flag_mask) { this->request_interrupt(interrupt_flag_mask); }},
-      pixel_processing_unit{[this](uint8_t interrupt_flag_mask) { this->request_interrupt(interrupt_flag_mask); }},
-      memory_management_unit{std::make_unique<MemoryManagementUnit>(game_cartridge_slot, internal_timer, pixel_processing_unit)},
-      central_processing_unit{[this]()
-                              {
-                                  this->step_components_single_machine_cycle_to_sync_with_central_processing_unit();
-                              }, *memory_management_unit}
+    : internal_timer{interrupt_registers, event_scheduler},
+      pixel_processing_unit{interrupt_registers, event_scheduler},
+      memory_management_unit{std::make_unique<MemoryManagementUnit>(game_cartridge_slot, interrupt_registers, internal_timer, pixel_processing_unit, event_scheduler)},
+      central_processing_unit{EmulatorSystemBus{interrupt_registers, internal_timer, *memory_management_unit, pixel_processing_unit, event_scheduler}}
 {
 }
 
 void Emulator::reset_state()
 {
+    game_cartridge_slot.prepare_for_machine_cycle_counter_reset();
+    event_scheduler.reset_state();
+
     if (is_boot_rom_loaded_in_memory_thread_safe())
     {
         internal_timer.reset_state();
@@ -43,11 +43,86 @@ void Emulator::step_central_processing_unit_single_instruction()
     central_processing_unit.step_single_instruction();
 }
 
+void Emulator::step_central_processing_unit_instructions(uint32_t instruction_count)
+{
+    central_processing_unit.step_instructions(instruction_count);
+}
+
+EmulationStopResult Emulator::run_for_cycles(uint64_t machine_cycle_count)
+{
+    return central_processing_unit.step_instructions_until_stopped(EmulationStopConditions{machine_cycle_count});
+}
+
+EmulationStopResult Emulator::run_until_frame(uint64_t max_machine_cycle_count)
+{
+    return central_processing_unit.step_instructions_until_stopped(EmulationStopConditions{max_machine_cycle_count, true});
+}
+
+EmulationStopResult Emulator::run_until_event(const EmulationStopConditions& stop_conditions)
+{
+    return central_processing_unit.step_instructions_until_stopped(stop_conditions);
+}
+
+uint64_t Emulator::get_elapsed_machine_cycles() const
+{
+    return central_processing_unit.get_elapsed_machine_cycles();
+}
+
 RegisterFile<std::endian::native> Emulator::get_register_file() const
 {
     return central_processing_unit.get_register_file();
 }
 
+void Emulator::set_halt_fast_forward_enabled(bool is_enabled)
+{
+    central_processing_unit.set_halt_fast_forward_enabled(is_enabled);
+}
+
+void Emulator::set_idle_loop_skip_enabled(bool is_enabled)
+{
+    central_processing_unit.set_idle_loop_skip_enabled(is_enabled);
+}
+
+// Only has an effect in builds with GAME_BOY_EMULATOR_DYNAMIC_RECOMPILER on x86-64
+void Emulator::set_dynamic_recompilation_enabled(bool is_enabled)
+{
+    central_processing_unit.set_dynamic_recompilation_enabled(is_enabled);
+}
+
+// Renders 1 in every frame_skip_interval frames for fast-forward and headless runs, timing and interrupts are unaffected
+void Emulator::set_frame_skip_interval(uint8_t frame_skip_interval)
+{
+    pixel_processing_unit.set_frame_skip_interval(frame_skip_interval);
+}
+
+// Disabling it forces every scanline through the pixel FIFO, for checking the render-ahead path against it
+void Emulator::set_scanline_render_ahead_enabled(bool is_enabled)
+{
+    pixel_processing_unit.set_scanline_render_ahead_enabled(is_enabled);
+}
+
+// Takes effect on the next game ROM load
+void Emulator::set_battery_backed_save_files_enabled(bool is_enabled)
+{
+    game_cartridge_slot.set_battery_backed_save_files_enabled(is_enabled);
+}
+
+// Takes effect on the next game ROM load
+void Emulator::set_real_time_clock_time_source(RealTimeClockTimeSource time_source)
+{
+    game_cartridge_slot.set_real_time_clock_time_source(time_source);
+}
+
+EmulationStatistics Emulator::get_emulation_statistics() const
+{
+    return EmulationStatistics
+    {
+        central_processing_unit.get_fast_forwarded_halted_machine_cycles(),
+        central_processing_unit.get_skipped_idle_loop_machine_cycles(),
+        central_processing_unit.get_translated_block_machine_cycles()
+    };
+}
+
 void Emulator::print_register_file_state() const
 {
     GameBoyEmulator::print_register_file_state(central_processing_unit.get_register_file());
@@ -83,18 +158,22 @@ bool Emulator::is_boot_rom_mapped_in_memory() const
     return memory_management_unit->is_boot_rom_mapped();
 }
 
-uint8_t Emulator::read_byte_from_memory(uint16_t address) const
+uint8_t Emulator::read_byte_from_memory(uint16_t address)
 {
+    pixel_processing_unit.catch_up_to_machine_cycle(event_scheduler.get_current_machine_cycle());
     return memory_management_unit->read_byte(address, true);
 }
 
 void Emulator::write_byte_to_memory(uint16_t address, uint8_t value)
 {
+    pixel_processing_unit.catch_up_to_machine_cycle(event_scheduler.get_current_machine_cycle());
     memory_management_unit->write_byte(address, value, false);
+    pixel_processing_unit.schedule_synchronization_on_next_machine_cycle();
 }
 
-void Emulator::print_bytes_in_memory_range(uint16_t start_address, uint16_t end_address) const
+void Emulator::print_bytes_in_memory_range(uint16_t start_address, uint16_t end_address)
 {
+    pixel_processing_unit.catch_up_to_machine_cycle(event_scheduler.get_current_machine_cycle());
     GameBoyEmulator::print_bytes_in_range([&](uint16_t address, bool is_access_for_oam_dma) 
                                       {
                                           return memory_management_unit->read_byte(address, is_access_for_oam_dma);
@@ -133,7 +212,7 @@ std::string Emulator::get_loaded_game_rom_title_thread_safe() const
 
         for (uint16_t address = ROM_TITLE_START; address <= ROM_TITLE_END; address++)
         {
-            const uint8_t title_byte = read_byte_from_memory(address);
+            const uint8_t title_byte = memory_management_unit->read_byte(address, true);
             if (title_byte == 0x00)
             {
                 break;
@@ -144,16 +223,4 @@ std::string Emulator::get_loaded_game_rom_title_thread_safe() const
     return game_rom_title;
 }
 
-void Emulator::step_components_single_machine_cycle_to_sync_with_central_processing_unit()
-{
-    internal_timer.step_single_machine_cycle();
-    memory_management_unit->step_single_machine_cycle();
-    pixel_processing_unit.step_single_machine_cycle();
-}
-
-void Emulator::request_interrupt(uint8_t interrupt_flag_mask)
-{
-    memory_management_unit->request_interrupt(interrupt_flag_mask);
-}
-
 } // namespace GameBoyEmulator
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <format>
+#include <mutex>
+#include <unordered_map>
+
+#include "console_output_utilities.h"
+#include "game_rom_image.h"
+#include "memory_bank_controllers.h"
+
+namespace GameBoyEmulator
+{
+
+// Library scans validate many files, so header problems are only reported by whoever decides to act on them
+static bool set_header_error_message_and_fail(std::string_view error_message_text, std::string& output_error_message)
+{
+    output_error_message = error_message_text;
+    return false;
+}
+
+bool try_parse_cartridge_header(std::span<const uint8_t> rom_bytes, CartridgeHeader& cartridge_header, std::string& error_message)
+{
+    const size_t file_length_in_bytes = rom_bytes.size();
+
+    if (file_length_in_bytes < MemoryBankControllerBase::ROM_ONLY_WITH_NO_MBC_FILE_SIZE)
+    {
+        return set_header_error_message_and_fail(
+            std::string("Provided file of size ") + std::to_string(file_length_in_bytes) +
+                std::string(" bytes does not meet the game ROM size requirement."),
+            error_message);
+    }
+
+    if (!std::equal(std::begin(EXPECTED_LOGO), std::end(EXPECTED_LOGO), rom_bytes.begin() + LOGO_START_POSITION))
+    {
+        return set_header_error_message_and_fail(
+            std::string("Logo in provided ROM does not match the expected pattern."),
+            error_message);
+    }
+
+    const uint8_t color_game_boy_required_flag = rom_bytes[0x143];
+    if (color_game_boy_required_flag == 0xC0)
+    {
+        return set_header_error_message_and_fail(
+            std::string("Provided game ROM requires Game Boy Color functionality to run."),
+            error_message);
+    }
+
+    const uint8_t cartridge_type = rom_bytes[0x147];
+
+    const uint8_t cartridge_rom_size_byte = rom_bytes[0x148];
+    if (cartridge_rom_size_byte > 0x08)
+    {
+        return set_header_error_message_and_fail(
+            std::string("Provided game ROM contains an invalid ROM size byte."),
+            error_message);
+    }
+    const uint32_t expected_cartridge_rom_size = 0x8000 * (1 << cartridge_rom_size_byte);
+    if (file_length_in_bytes != expected_cartridge_rom_size)
+    {
+        return set_header_error_message_and_fail(
+            std::string("Provided file's size does not match the size specified in its header."),
+            error_message);
+    }
+
+    const uint8_t cartridge_ram_size_byte = rom_bytes[0x149];
+    if (cartridge_ram_size_byte == 0x01 || cartridge_ram_size_byte > 0x05)
+    {
+        return set_header_error_message_and_fail(
+            std::string("Provided game ROM contains an invalid RAM size byte."),
+            error_message);
+    }
+    uint32_t cartridge_ram_size = 0;
+    switch (cartridge_ram_size_byte)
+    {
+        case 0x02:
+            cartridge_ram_size = 0x2000;
+            break;
+        case 0x03:
+            cartridge_ram_size = 0x8000;
+            break;
+        case 0x04:
+            cartridge_ram_size = 0x20000;
+            break;
+        case 0x05:
+            cartridge_ram_size = 0x10000;
+            break;
+    }
+
+    cartridge_header = CartridgeHeader{cartridge_type, cartridge_ram_size, false};
+
+    switch (cartridge_type)
+    {
+        case ROM_ONLY_BYTE:
+        {
+            if (file_length_in_bytes > MemoryBankControllerBase::ROM_ONLY_WITH_NO_MBC_FILE_SIZE)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided file does not meet the size requirement for a ROM-only game."),
+                    error_message);
+            }
+            if (cartridge_ram_size != 0)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided game ROM contains an invalid RAM size byte for a ROM-only game."),
+                    error_message);
+            }
+            return true;
+        }
+        case MBC1_BYTE:
+        case MBC1_WITH_RAM_BYTE:
+        case MBC1_WITH_RAM_AND_BATTERY_BYTE:
+        {
+            if (file_length_in_bytes > MBC1::MAX_ROM_SIZE)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided file does not meet the size requirement for an MBC1 game."),
+                    error_message);
+            }
+            if ((cartridge_type == MBC1_BYTE && cartridge_ram_size != 0) ||
+                (file_length_in_bytes > MBC1::MAX_ROM_SIZE_IN_DEFAULT_CONFIGURATION &&
+                 cartridge_ram_size > MBC1::MAX_RAM_SIZE_IN_LARGE_CONFIGURATION))
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided game ROM contains an invalid RAM size byte for its selected memory bank controller."),
+                    error_message);
+            }
+
+            // Multi-game compilations repeat the logo at the start of each 256 KiB sub-ROM
+            if (file_length_in_bytes == MBC1::MBC1M_MULTI_GAME_COMPILATION_CART_ROM_SIZE)
+            {
+                const uint32_t rom_bank_0x10_offset = 0x10 * ROM_BANK_SIZE;
+                cartridge_header.is_mbc1m_multi_game_compilation =
+                    std::equal(std::begin(EXPECTED_LOGO), std::end(EXPECTED_LOGO), rom_bytes.begin() + rom_bank_0x10_offset + LOGO_START_POSITION);
+            }
+            return true;
+        }
+        case MBC2_BYTE:
+        case MBC2_WITH_BATTERY_BYTE:
+        {
+            if (file_length_in_bytes > MBC2::MAX_ROM_SIZE)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided file does not meet the size requirement for an MBC2 game."),
+                    error_message);
+            }
+            if (cartridge_ram_size != 0)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided game ROM contains an invalid RAM size byte for its selected memory bank controller."),
+                    error_message);
+            }
+            return true;
+        }
+        case MBC3_WITH_TIMER_AND_BATTERY_BYTE:
+        case MBC3_WITH_TIMER_AND_RAM_AND_BATTERY_BYTE:
+        case MBC3_BYTE:
+        case MBC3_WITH_RAM_BYTE:
+        case MBC3_WITH_RAM_AND_BATTERY_BYTE:
+        {
+            if (file_length_in_bytes > MBC3::MAX_ROM_SIZE)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided file does not meet the size requirement for an MBC3 game."),
+                    error_message);
+            }
+            if (((cartridge_type == MBC3_BYTE || cartridge_type == MBC3_WITH_TIMER_AND_BATTERY_BYTE) && cartridge_ram_size != 0) ||
+                cartridge_ram_size > MBC3::MAX_RAM_SIZE)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided game ROM contains an invalid RAM size byte for its selected memory bank controller."),
+                    error_message);
+            }
+            return true;
+        }
+        case MBC5_BYTE:
+        case MBC5_WITH_RAM_BYTE:
+        case MBC5_WITH_RAM_AND_BATTERY_BYTE:
+        case MBC5_WITH_RUMBLE_AND_RAM:
+        case MBC5_WITH_RUMBLE_AND_RAM_AND_BATTERY:
+        {
+            if (file_length_in_bytes > MBC5::MAX_ROM_SIZE)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided file does not meet the size requirement for an MBC5 game."),
+                    error_message);
+            }
+            if ((cartridge_type == MBC5_BYTE && cartridge_ram_size != 0) ||
+                cartridge_ram_size > MBC5::MAX_RAM_SIZE)
+            {
+                return set_header_error_message_and_fail(
+                    std::string("Provided game ROM contains an invalid RAM size byte for its selected memory bank controller."),
+                    error_message);
+            }
+            return true;
+        }
+        default:
+        {
+            return set_header_error_message_and_fail(
+                std::format("Game ROM with cartridge type 0x{:02x} is not currently supported.", static_cast<int>(cartridge_type)),
+                error_message);
+        }
+    }
+}
+
+// 64-bit FNV-1a
+static uint64_t get_content_hash(std::span<const uint8_t> rom_bytes)
+{
+    uint64_t content_hash = 0xCBF29CE484222325;
+    for (const uint8_t rom_byte : rom_bytes)
+    {
+        content_hash = (content_hash ^ rom_byte) * 0x100000001B3;
+    }
+    return content_hash;
+}
+
+GameRomImage::GameRomImage(
+    std::unique_ptr<MemoryMappedFile> mapped_file,
+    const CartridgeHeader& header,
+    uint64_t content_hash)
+    : memory_mapped_file{std::move(mapped_file)},
+      cartridge_header{header},
+      rom_content_hash{content_hash}
+{
+}
+
+struct GameRomImagePathEntry
+{
+    std::weak_ptr<const GameRomImage> game_rom_image;
+    std::filesystem::file_time_type last_write_time;
+    uintmax_t file_size;
+};
+
+static std::mutex registry_mutex;
+static std::unordered_map<std::string, GameRomImagePathEntry> game_rom_images_by_path;
+static std::unordered_map<uint64_t, std::weak_ptr<const GameRomImage>> game_rom_images_by_content_hash;
+
+static void erase_expired_game_rom_images()
+{
+    std::erase_if(game_rom_images_by_path, [](const auto& entry) { return entry.second.game_rom_image.expired(); });
+    std::erase_if(game_rom_images_by_content_hash, [](const auto& entry) { return entry.second.expired(); });
+}
+
+std::shared_ptr<const GameRomImage> GameRomImageRegistry::try_acquire(const std::filesystem::path& file_path, std::string& error_message)
+{
+    std::error_code error_code;
+    std::filesystem::path canonical_file_path = std::filesystem::weakly_canonical(file_path, error_code);
+    if (error_code)
+    {
+        canonical_file_path = file_path;
+    }
+    const std::filesystem::file_time_type last_write_time = std::filesystem::last_write_time(canonical_file_path, error_code);
+    if (error_code)
+    {
+        set_error_message_and_fail(std::string("File not found at ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    const uintmax_t file_size = std::filesystem::file_size(canonical_file_path, error_code);
+    if (error_code)
+    {
+        set_error_message_and_fail(std::string("File not found at ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    const std::string path_key = canonical_file_path.string();
+
+    std::lock_guard<std::mutex> registry_lock{registry_mutex};
+
+    // A file that changed on disk gets a new mapping. Instances still holding the old image keep their mapping, which follows the file
+    // and so does not protect them from a ROM rewritten in place, and checking the size keeps a truncated file from being handed out again
+    if (const auto path_entry = game_rom_images_by_path.find(path_key); path_entry != game_rom_images_by_path.end())
+    {
+        std::shared_ptr<const GameRomImage> game_rom_image = path_entry->second.game_rom_image.lock();
+        if (game_rom_image != nullptr && path_entry->second.last_write_time == last_write_time && path_entry->second.file_size == file_size)
+        {
+            return game_rom_image;
+        }
+    }
+
+    std::unique_ptr<MemoryMappedFile> memory_mapped_file = MemoryMappedFile::try_map_read_only(canonical_file_path, error_message);
+    if (memory_mapped_file == nullptr)
+    {
+        return nullptr;
+    }
+    const std::span<const uint8_t> rom_bytes{memory_mapped_file->data(), memory_mapped_file->size()};
+    const uint64_t content_hash = get_content_hash(rom_bytes);
+
+    if (const auto content_hash_entry = game_rom_images_by_content_hash.find(content_hash); content_hash_entry != game_rom_images_by_content_hash.end())
+    {
+        std::shared_ptr<const GameRomImage> game_rom_image = content_hash_entry->second.lock();
+        if (game_rom_image != nullptr && std::ranges::equal(game_rom_image->get_bytes(), rom_bytes))
+        {
+            game_rom_images_by_path[path_key] = GameRomImagePathEntry{game_rom_image, last_write_time, file_size};
+            return game_rom_image;
+        }
+    }
+
+    CartridgeHeader cartridge_header{};
+    std::string header_error_message{};
+    if (!try_parse_cartridge_header(rom_bytes, cartridge_header, header_error_message))
+    {
+        set_error_message_and_fail(header_error_message, error_message);
+        return nullptr;
+    }
+
+    erase_expired_game_rom_images();
+    auto game_rom_image = std::make_shared<const GameRomImage>(std::move(memory_mapped_file), cartridge_header, content_hash);
+    game_rom_images_by_path[path_key] = GameRomImagePathEntry{game_rom_image, last_write_time, file_size};
+    game_rom_images_by_content_hash[content_hash] = game_rom_image;
+    return game_rom_image;
+}
+
+} // namespace GameBoyEmulator
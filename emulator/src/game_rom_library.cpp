@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "emulator.h"
+#include "game_rom_image.h"
+#include "game_rom_library.h"
+#include "memory_bank_controllers.h"
+
+namespace GameBoyEmulator
+{
+
+static constexpr char GAME_ROM_LIBRARY_CACHE_MAGIC[4] = {'G', 'B', 'R', 'L'};
+static constexpr uint32_t GAME_ROM_LIBRARY_CACHE_VERSION = 1;
+static constexpr uint16_t HEADER_CHECKSUM_START = 0x0134;
+static constexpr uint16_t HEADER_CHECKSUM_POSITION = 0x014D;
+static constexpr uint16_t GLOBAL_CHECKSUM_POSITION = 0x014E;
+static constexpr uint16_t MINIMUM_GAME_ROM_LIBRARY_FILE_SIZE = 0x0150;
+
+static std::string get_utf8_string(const std::filesystem::path& path)
+{
+    const std::u8string utf8_path = path.u8string();
+    return std::string(utf8_path.begin(), utf8_path.end());
+}
+
+static std::filesystem::path get_path_from_utf8_string(std::string_view utf8_string)
+{
+    return std::filesystem::path(std::u8string(utf8_string.begin(), utf8_string.end()));
+}
+
+static bool has_game_rom_library_file_extension(const std::filesystem::path& file_path)
+{
+    std::string extension = file_path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return std::ranges::any_of(GAME_ROM_LIBRARY_FILE_EXTENSIONS, [&](const char* library_extension) { return extension == library_extension; });
+}
+
+GameRomLibrary::GameRomLibrary(const std::filesystem::path& cache_file_path)
+    : cache_file_path{cache_file_path}
+{
+}
+
+// Stops a running scan before the members it writes to are destroyed
+GameRomLibrary::~GameRomLibrary()
+{
+    scan_thread.request_stop();
+    if (scan_thread.joinable())
+    {
+        scan_thread.join();
+    }
+}
+
+bool GameRomLibrary::try_read_entry(const std::filesystem::path& file_path, GameRomLibraryEntry& entry)
+{
+    std::error_code error_code;
+    const uint64_t file_size = std::filesystem::file_size(file_path, error_code);
+    if (error_code || file_size < MINIMUM_GAME_ROM_LIBRARY_FILE_SIZE)
+    {
+        return false;
+    }
+    const std::filesystem::file_time_type last_write_time = std::filesystem::last_write_time(file_path, error_code);
+    if (error_code)
+    {
+        return false;
+    }
+
+    entry = GameRomLibraryEntry{};
+    entry.file_path = file_path;
+    entry.file_size = file_size;
+    entry.last_write_time = static_cast<int64_t>(last_write_time.time_since_epoch().count());
+
+    // Files past the largest ROM any supported cartridge holds are listed without being read
+    if (file_size > MBC5::MAX_ROM_SIZE)
+    {
+        entry.load_error_message = "File is larger than the largest supported ROM size.";
+        return true;
+    }
+
+    std::ifstream rom_file(file_path, std::ios::binary);
+    std::vector<uint8_t> rom_bytes(file_size);
+    if (!rom_file.read(reinterpret_cast<char*>(rom_bytes.data()), static_cast<std::streamsize>(file_size)))
+    {
+        return false;
+    }
+
+    for (uint16_t address = ROM_TITLE_START; address <= ROM_TITLE_END && rom_bytes[address] != 0x00; address++)
+    {
+        entry.title.push_back(std::isprint(rom_bytes[address]) ? static_cast<char>(rom_bytes[address]) : '?');
+    }
+    entry.color_game_boy_flag = rom_bytes[0x143];
+    entry.cartridge_type = rom_bytes[0x147];
+    entry.rom_size_byte = rom_bytes[0x148];
+    entry.ram_size_byte = rom_bytes[0x149];
+    entry.is_logo_valid = std::equal(std::begin(EXPECTED_LOGO), std::end(EXPECTED_LOGO), rom_bytes.begin() + LOGO_START_POSITION);
+
+    uint8_t header_checksum = 0;
+    for (uint16_t address = HEADER_CHECKSUM_START; address < HEADER_CHECKSUM_POSITION; address++)
+    {
+        header_checksum = header_checksum - rom_bytes[address] - 1;
+    }
+    entry.is_header_checksum_valid = (header_checksum == rom_bytes[HEADER_CHECKSUM_POSITION]);
+
+    // The global checksum covers every byte except its own two
+    uint16_t global_checksum = 0;
+    for (const uint8_t rom_byte : rom_bytes)
+    {
+        global_checksum += rom_byte;
+    }
+    global_checksum -= rom_bytes[GLOBAL_CHECKSUM_POSITION] + rom_bytes[GLOBAL_CHECKSUM_POSITION + 1];
+    entry.is_global_checksum_valid = (global_checksum == ((rom_bytes[GLOBAL_CHECKSUM_POSITION] << 8) | rom_bytes[GLOBAL_CHECKSUM_POSITION + 1]));
+
+    CartridgeHeader cartridge_header{};
+    entry.is_loadable = try_parse_cartridge_header(rom_bytes, cartridge_header, entry.load_error_message);
+    return true;
+}
+
+void GameRomLibrary::add_directory(const std::filesystem::path& directory_path)
+{
+    std::lock_guard<std::mutex> library_lock{library_mutex};
+    if (std::find(directories.begin(), directories.end(), directory_path) == directories.end())
+    {
+        directories.push_back(directory_path);
+    }
+}
+
+void GameRomLibrary::remove_directory(const std::filesystem::path& directory_path)
+{
+    std::lock_guard<std::mutex> library_lock{library_mutex};
+    std::erase(directories, directory_path);
+}
+
+std::vector<std::filesystem::path> GameRomLibrary::get_directories() const
+{
+    std::lock_guard<std::mutex> library_lock{library_mutex};
+    return directories;
+}
+
+std::shared_ptr<const std::vector<GameRomLibraryEntry>> GameRomLibrary::get_entries() const
+{
+    std::lock_guard<std::mutex> library_lock{library_mutex};
+    return entries;
+}
+
+// A new scan replaces one that is still running, which stops at the next file
+void GameRomLibrary::start_scan()
+{
+    scan_thread = std::jthread{};
+    is_scan_running.store(true, std::memory_order_release);
+    scan_thread = std::jthread{[this](std::stop_token stop_token) { scan(stop_token, get_directories()); }};
+}
+
+bool GameRomLibrary::is_scan_in_progress() const
+{
+    return is_scan_running.load(std::memory_order_acquire);
+}
+
+uint32_t GameRomLibrary::get_scanned_file_count() const
+{
+    return scanned_file_count.load(std::memory_order_relaxed);
+}
+
+uint32_t GameRomLibrary::get_file_count_to_scan() const
+{
+    return file_count_to_scan.load(std::memory_order_relaxed);
+}
+
+// Unchanged files are carried over from the previous snapshot using only the directory walk's size and time,
+// and the rest are split between worker threads that each claim the next unread file
+void GameRomLibrary::scan(std::stop_token stop_token, std::vector<std::filesystem::path> directories_to_scan)
+{
+    const std::shared_ptr<const std::vector<GameRomLibraryEntry>> previous_entries = get_entries();
+    std::unordered_map<std::string, const GameRomLibraryEntry*> previous_entries_by_path;
+    for (const GameRomLibraryEntry& entry : *previous_entries)
+    {
+        previous_entries_by_path.emplace(get_utf8_string(entry.file_path), &entry);
+    }
+
+    std::vector<GameRomLibraryEntry> scanned_entries;
+    std::vector<std::filesystem::path> file_paths_to_read;
+    std::unordered_set<std::string> visited_file_paths;
+    for (const std::filesystem::path& directory_path : directories_to_scan)
+    {
+        std::error_code error_code;
+        std::filesystem::recursive_directory_iterator directory_iterator{directory_path, std::filesystem::directory_options::skip_permission_denied, error_code};
+        for (; !error_code && directory_iterator != std::filesystem::recursive_directory_iterator{}; directory_iterator.increment(error_code))
+        {
+            if (stop_token.stop_requested())
+            {
+                return;
+            }
+            const std::filesystem::directory_entry& directory_entry = *directory_iterator;
+            std::error_code entry_error_code;
+            if (!directory_entry.is_regular_file(entry_error_code) || !has_game_rom_library_file_extension(directory_entry.path()))
+            {
+                continue;
+            }
+            const std::string path_key = get_utf8_string(directory_entry.path());
+            if (!visited_file_paths.insert(path_key).second)
+            {
+                continue;
+            }
+
+            const uint64_t file_size = directory_entry.file_size(entry_error_code);
+            const int64_t last_write_time = static_cast<int64_t>(directory_entry.last_write_time(entry_error_code).time_since_epoch().count());
+            const auto previous_entry = previous_entries_by_path.find(path_key);
+            if (!entry_error_code && previous_entry != previous_entries_by_path.end() &&
+                previous_entry->second->file_size == file_size && previous_entry->second->last_write_time == last_write_time)
+            {
+                scanned_entries.push_back(*previous_entry->second);
+                continue;
+            }
+            file_paths_to_read.push_back(directory_entry.path());
+        }
+    }
+
+    scanned_file_count.store(0, std::memory_order_relaxed);
+    file_count_to_scan.store(static_cast<uint32_t>(file_paths_to_read.size()), std::memory_order_relaxed);
+    std::vector<GameRomLibraryEntry> read_entries(file_paths_to_read.size());
+    std::vector<uint8_t> were_entries_read(file_paths_to_read.size());
+    std::atomic<size_t> next_file_index{};
+    {
+        const uint32_t worker_count = std::clamp<uint32_t>(std::thread::hardware_concurrency(), 1, static_cast<uint32_t>(std::max<size_t>(file_paths_to_read.size(), 1)));
+        std::vector<std::jthread> workers;
+        for (uint32_t i = 0; i < worker_count; i++)
+        {
+            workers.emplace_back([&]
+            {
+                for (size_t file_index = next_file_index++; file_index < file_paths_to_read.size() && !stop_token.stop_requested(); file_index = next_file_index++)
+                {
+                    // An exception escaping a worker would terminate the process, so a file that throws is left out like an unreadable one
+                    try
+                    {
+                        were_entries_read[file_index] = try_read_entry(file_paths_to_read[file_index], read_entries[file_index]);
+                    }
+                    catch (const std::exception&)
+                    {
+                        were_entries_read[file_index] = false;
+                    }
+                    scanned_file_count.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+    }
+    if (stop_token.stop_requested())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < read_entries.size(); i++)
+    {
+        if (were_entries_read[i])
+        {
+            scanned_entries.push_back(std::move(read_entries[i]));
+        }
+    }
+    std::sort(scanned_entries.begin(), scanned_entries.end(), [](const GameRomLibraryEntry& a, const GameRomLibraryEntry& b)
+    {
+        return std::tie(a.title, a.file_path) < std::tie(b.title, b.file_path);
+    });
+
+    {
+        std::lock_guard<std::mutex> library_lock{library_mutex};
+        entries = std::make_shared<const std::vector<GameRomLibraryEntry>>(std::move(scanned_entries));
+    }
+    std::string error_message{};
+    try_save_cache(error_message);
+    is_scan_running.store(false, std::memory_order_release);
+}
+
+static void append_bytes(std::string& buffer, uint64_t value, uint8_t byte_count)
+{
+    for (uint8_t i = 0; i < byte_count; i++)
+    {
+        buffer.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+static void append_string(std::string& buffer, std::string_view value)
+{
+    append_bytes(buffer, value.size(), 2);
+    buffer.append(value);
+}
+
+// Reads little endian fields from the cache and fails every later read once the buffer runs out
+class GameRomLibraryCacheReader
+{
+public:
+    explicit GameRomLibraryCacheReader(std::string_view cache_buffer)
+        : buffer{cache_buffer}
+    {
+    }
+
+    uint64_t read_bytes(uint8_t byte_count)
+    {
+        if (position + byte_count > buffer.size())
+        {
+            is_valid = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (uint8_t i = 0; i < byte_count; i++)
+        {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(buffer[position++])) << (8 * i);
+        }
+        return value;
+    }
+
+    std::string_view read_string()
+    {
+        const size_t string_length = read_bytes(2);
+        if (position + string_length > buffer.size())
+        {
+            is_valid = false;
+            return {};
+        }
+        position += string_length;
+        return buffer.substr(position - string_length, string_length);
+    }
+
+    bool is_valid{true};
+
+private:
+    std::string_view buffer;
+    size_t position{};
+};
+
+// Directories, then entries, with strings prefixed by their 16-bit length and the boolean fields packed into one byte
+bool GameRomLibrary::try_save_cache(std::string& error_message) const
+{
+    const std::vector<std::filesystem::path> cached_directories = get_directories();
+    const std::shared_ptr<const std::vector<GameRomLibraryEntry>> cached_entries = get_entries();
+
+    std::string cache_buffer{std::begin(GAME_ROM_LIBRARY_CACHE_MAGIC), std::end(GAME_ROM_LIBRARY_CACHE_MAGIC)};
+    append_bytes(cache_buffer, GAME_ROM_LIBRARY_CACHE_VERSION, 4);
+    append_bytes(cache_buffer, cached_directories.size(), 4);
+    for (const std::filesystem::path& directory_path : cached_directories)
+    {
+        append_string(cache_buffer, get_utf8_string(directory_path));
+    }
+    append_bytes(cache_buffer, cached_entries->size(), 4);
+    for (const GameRomLibraryEntry& entry : *cached_entries)
+    {
+        append_string(cache_buffer, get_utf8_string(entry.file_path));
+        append_bytes(cache_buffer, entry.file_size, 8);
+        append_bytes(cache_buffer, static_cast<uint64_t>(entry.last_write_time), 8);
+        append_string(cache_buffer, entry.title);
+        append_bytes(cache_buffer, entry.color_game_boy_flag, 1);
+        append_bytes(cache_buffer, entry.cartridge_type, 1);
+        append_bytes(cache_buffer, entry.rom_size_byte, 1);
+        append_bytes(cache_buffer, entry.ram_size_byte, 1);
+        append_bytes(cache_buffer,
+            (entry.is_logo_valid << 0) | (entry.is_header_checksum_valid << 1) | (entry.is_global_checksum_valid << 2) | (entry.is_loadable << 3), 1);
+        append_string(cache_buffer, entry.load_error_message);
+    }
+
+    // Written next to the cache and renamed over it so an interrupted save never leaves a truncated cache behind
+    std::error_code error_code;
+    std::filesystem::create_directories(cache_file_path.parent_path(), error_code);
+    std::filesystem::path temporary_cache_file_path = cache_file_path;
+    temporary_cache_file_path += ".tmp";
+    {
+        std::ofstream cache_file(temporary_cache_file_path, std::ios::binary | std::ios::trunc);
+        if (!cache_file.write(cache_buffer.data(), static_cast<std::streamsize>(cache_buffer.size())))
+        {
+            error_message = std::string("Could not write ROM library cache to ") + temporary_cache_file_path.string();
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary_cache_file_path, cache_file_path, error_code);
+    if (error_code)
+    {
+        error_message = std::string("Could not replace ROM library cache at ") + cache_file_path.string();
+        return false;
+    }
+    return true;
+}
+
+// A missing cache is an empty library, a cache that cannot be parsed is discarded and rebuilt by the next scan
+bool GameRomLibrary::try_load_cache(std::string& error_message)
+{
+    std::ifstream cache_file(cache_file_path, std::ios::binary);
+    if (!cache_file)
+    {
+        return true;
+    }
+    const std::string cache_buffer{std::istreambuf_iterator<char>(cache_file), std::istreambuf_iterator<char>()};
+    GameRomLibraryCacheReader cache_reader{cache_buffer};
+
+    if (cache_buffer.size() < sizeof(GAME_ROM_LIBRARY_CACHE_MAGIC) ||
+        !std::equal(std::begin(GAME_ROM_LIBRARY_CACHE_MAGIC), std::end(GAME_ROM_LIBRARY_CACHE_MAGIC), cache_buffer.begin()))
+    {
+        error_message = std::string("ROM library cache at ") + cache_file_path.string() + " is not a ROM library cache.";
+        return false;
+    }
+    cache_reader.read_bytes(sizeof(GAME_ROM_LIBRARY_CACHE_MAGIC));
+    if (cache_reader.read_bytes(4) != GAME_ROM_LIBRARY_CACHE_VERSION)
+    {
+        error_message = std::string("ROM library cache at ") + cache_file_path.string() + " was written by a different version and will be rebuilt.";
+        return false;
+    }
+
+    const uint32_t directory_count = static_cast<uint32_t>(cache_reader.read_bytes(4));
+    std::vector<std::filesystem::path> cached_directories;
+    for (uint32_t i = 0; i < directory_count && cache_reader.is_valid; i++)
+    {
+        cached_directories.push_back(get_path_from_utf8_string(cache_reader.read_string()));
+    }
+    const uint32_t entry_count = static_cast<uint32_t>(cache_reader.read_bytes(4));
+    std::vector<GameRomLibraryEntry> cached_entries;
+    for (uint32_t i = 0; i < entry_count && cache_reader.is_valid; i++)
+    {
+        GameRomLibraryEntry& entry = cached_entries.emplace_back();
+        entry.file_path = get_path_from_utf8_string(cache_reader.read_string());
+        entry.file_size = cache_reader.read_bytes(8);
+        entry.last_write_time = static_cast<int64_t>(cache_reader.read_bytes(8));
+        entry.title = cache_reader.read_string();
+        entry.color_game_boy_flag = static_cast<uint8_t>(cache_reader.read_bytes(1));
+        entry.cartridge_type = static_cast<uint8_t>(cache_reader.read_bytes(1));
+        entry.rom_size_byte = static_cast<uint8_t>(cache_reader.read_bytes(1));
+        entry.ram_size_byte = static_cast<uint8_t>(cache_reader.read_bytes(1));
+        const uint8_t entry_flags = static_cast<uint8_t>(cache_reader.read_bytes(1));
+        entry.is_logo_valid = (entry_flags & 0b0001) != 0;
+        entry.is_header_checksum_valid = (entry_flags & 0b0010) != 0;
+        entry.is_global_checksum_valid = (entry_flags & 0b0100) != 0;
+        entry.is_loadable = (entry_flags & 0b1000) != 0;
+        entry.load_error_message = cache_reader.read_string();
+    }
+    if (!cache_reader.is_valid)
+    {
+        error_message = std::string("ROM library cache at ") + cache_file_path.string() + " is truncated and will be rebuilt.";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> library_lock{library_mutex};
+    directories = std::move(cached_directories);
+    entries = std::make_shared<const std::vector<GameRomLibraryEntry>>(std::move(cached_entries));
+    return true;
+}
+
+} // namespace GameBoyEmulator
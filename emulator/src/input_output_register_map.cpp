@@ -0,0 +1,64 @@
+#include <iomanip>
+#include <iostream>
+
+#include "input_output_register_map.h"
+
+namespace GameBoyEmulator
+{
+
+static uint8_t read_storage(void* context)
+{
+    return *static_cast<const uint8_t*>(context);
+}
+
+static void write_storage(void* context, uint8_t value)
+{
+    *static_cast<uint8_t*>(context) = value;
+}
+
+// The write context of a read only register is its address
+static void write_read_only_register(void* context, uint8_t)
+{
+    std::cout << std::hex << std::setfill('0')
+              << "Attempted to write to read only address 0x" << std::setw(4) << *static_cast<const uint16_t*>(context) << ". No write will occur.\n";
+}
+
+InputOutputRegisterMap::InputOutputRegisterMap()
+{
+    for (uint8_t index = 0; index < NUMBER_OF_INPUT_OUTPUT_REGISTERS; index++)
+    {
+        read_only_register_addresses[index] = 0xFF00 | index;
+        input_output_registers[index] = InputOutputRegister{&unmapped_storage[index], read_storage, &unmapped_storage[index], write_storage, 0x00};
+    }
+}
+
+void InputOutputRegisterMap::reset_state()
+{
+    unmapped_storage.fill(0);
+}
+
+// A null write handler makes the register read only
+void InputOutputRegisterMap::register_handlers(
+    uint16_t address,
+    void* context,
+    InputOutputRegisterReadHandler read_handler,
+    InputOutputRegisterWriteHandler write_handler,
+    uint8_t read_mask)
+{
+    const uint8_t index = address & INPUT_OUTPUT_REGISTER_INDEX_MASK;
+    input_output_registers[index] = (write_handler != nullptr)
+        ? InputOutputRegister{context, read_handler, context, write_handler, read_mask}
+        : InputOutputRegister{context, read_handler, &read_only_register_addresses[index], write_read_only_register, read_mask};
+}
+
+void InputOutputRegisterMap::register_storage(uint16_t address, uint8_t& storage, uint8_t read_mask)
+{
+    register_handlers(address, &storage, read_storage, write_storage, read_mask);
+}
+
+void InputOutputRegisterMap::set_read_mask(uint16_t address, uint8_t read_mask)
+{
+    input_output_registers[address & INPUT_OUTPUT_REGISTER_INDEX_MASK].read_mask = read_mask;
+}
+
+} // namespace GameBoyEmulator
@@ -1,52 +1,54 @@
-#include "memory_management_unit.h"
 #include "internal_timer.h"
 
 namespace GameBoyEmulator
 {
 
-InternalTimer::InternalTimer(std::function<void(uint8_t)> request_interrupt)
-    : request_interrupt_callback{request_interrupt}
+InternalTimer::InternalTimer(InterruptRegisters& interrupt_registers_reference, EventScheduler& event_scheduler_reference)
+    : interrupt_registers{interrupt_registers_reference},
+      event_scheduler{event_scheduler_reference}
 {
 }
 
 void InternalTimer::reset_state()
 {
-    uint16_t system_counter = 0;
-    uint8_t timer_tima = 0;
-    uint8_t timer_modulo_tma = 0;
-    uint8_t timer_control_tac = 0b11111000;
-    bool is_previously_selected_system_counter_bit_set = false;
-    bool did_tima_overflow_occur = false;
-    bool is_tima_overflow_handled = false;
+    system_counter_base = 0;
+    system_counter_base_machine_cycle = event_scheduler.get_current_machine_cycle();
+    timer_modulo_tma = 0;
+    timer_control_tac = 0b11111000;
+    tima_reload_machine_cycle = UNSCHEDULED_EVENT_MACHINE_CYCLE;
+    set_unwrapped_tima(0);
 }
 
 void InternalTimer::set_post_boot_state()
 {
     reset_state();
-    system_counter = 0xABC8;
+    system_counter_base = 0xABC8;
 }
 
-void InternalTimer::step_single_machine_cycle()
+void InternalTimer::register_input_output_registers(InputOutputRegisterMap& input_output_register_map)
 {
-    system_counter += 4;
+    input_output_register_map.register_member_functions<InternalTimer, &InternalTimer::read_div, &InternalTimer::write_div>(0xFF04, *this);
+    input_output_register_map.register_member_functions<InternalTimer, &InternalTimer::read_tima, &InternalTimer::write_tima>(0xFF05, *this);
+    input_output_register_map.register_member_functions<InternalTimer, &InternalTimer::read_tma, &InternalTimer::write_tma>(0xFF06, *this);
+    input_output_register_map.register_member_functions<InternalTimer, &InternalTimer::read_tac, &InternalTimer::write_tac>(0xFF07, *this);
+}
 
-    if (did_tima_overflow_occur)
-    {
-        request_interrupt_callback(TIMER_INTERRUPT_FLAG_MASK);
-        timer_tima = timer_modulo_tma;
-    }
-    is_tima_overflow_handled = did_tima_overflow_occur;
-    did_tima_overflow_occur = update_tima_and_get_overflow_state();
+// Scheduled on the machine cycle after TIMA overflowed, TIMA reads 0x00 in between
+void InternalTimer::reload_tima_after_overflow()
+{
+    interrupt_registers.request_interrupt(TIMER_INTERRUPT_FLAG_MASK);
+    tima_reload_machine_cycle = event_scheduler.get_current_machine_cycle();
+    set_unwrapped_tima(timer_modulo_tma);
 }
 
 uint8_t InternalTimer::read_div() const
 {
-    return static_cast<uint8_t>(system_counter >> 8);
+    return static_cast<uint8_t>(get_unwrapped_system_counter(event_scheduler.get_current_machine_cycle()) >> 8);
 }
 
 uint8_t InternalTimer::read_tima() const
 {
-    return timer_tima;
+    return static_cast<uint8_t>(get_unwrapped_tima());
 }
 
 uint8_t InternalTimer::read_tma() const
@@ -59,61 +61,135 @@ uint8_t InternalTimer::read_tac() const
     return 0b11111000 | timer_control_tac;
 }
 
+// DIV is the upper byte of the system counter
+uint32_t InternalTimer::get_machine_cycles_until_div_change() const
+{
+    const uint64_t system_counter = get_unwrapped_system_counter(event_scheduler.get_current_machine_cycle());
+    return static_cast<uint32_t>((0x100 - (system_counter & 0xFF) + SYSTEM_COUNTER_INCREMENT_PER_MACHINE_CYCLE - 1) / SYSTEM_COUNTER_INCREMENT_PER_MACHINE_CYCLE);
+}
+
+// A stopped TIMA only changes on writes or on the reload after an overflow, and the reload is a scheduled event
+uint64_t InternalTimer::get_machine_cycles_until_tima_change() const
+{
+    if (!is_tima_enabled())
+        return UINT64_MAX;
+
+    const uint32_t system_counter_bit_period = get_selected_system_counter_bit_period();
+    const uint64_t system_counter = get_unwrapped_system_counter(event_scheduler.get_current_machine_cycle());
+    return (system_counter_bit_period - system_counter % system_counter_bit_period + SYSTEM_COUNTER_INCREMENT_PER_MACHINE_CYCLE - 1) / SYSTEM_COUNTER_INCREMENT_PER_MACHINE_CYCLE;
+}
+
 void InternalTimer::write_div(uint8_t value)
 {
-    system_counter = 0x0000;
-    update_tima_early();
+    const bool was_selected_system_counter_bit_set = is_selected_system_counter_bit_set();
+    const uint16_t unwrapped_tima = get_unwrapped_tima();
+    system_counter_base = 0x0000;
+    system_counter_base_machine_cycle = event_scheduler.get_current_machine_cycle();
+    update_tima_early(was_selected_system_counter_bit_set, unwrapped_tima);
 }
 
 void InternalTimer::write_tima(uint8_t value)
 {
-    if (is_tima_overflow_handled)
+    if (is_tima_overflow_handled())
         return;
 
-    timer_tima = value;
-    did_tima_overflow_occur = false;
+    set_unwrapped_tima(value);
 }
 
 void InternalTimer::write_tma(uint8_t value)
 {
     timer_modulo_tma = value;
 
-    if (is_tima_overflow_handled)
+    if (is_tima_overflow_handled())
     {
-        timer_tima = timer_modulo_tma;
+        set_unwrapped_tima(timer_modulo_tma);
     }
 }
 
 void InternalTimer::write_tac(uint8_t value)
 {
+    const bool was_selected_system_counter_bit_set = is_selected_system_counter_bit_set();
+    const uint16_t unwrapped_tima = get_unwrapped_tima();
     timer_control_tac = 0b11111000 | value;
-    update_tima_early();
+    update_tima_early(was_selected_system_counter_bit_set, unwrapped_tima);
+}
+
+uint64_t InternalTimer::get_unwrapped_system_counter(uint64_t machine_cycle) const
+{
+    return system_counter_base + SYSTEM_COUNTER_INCREMENT_PER_MACHINE_CYCLE * (machine_cycle - system_counter_base_machine_cycle);
+}
+
+// TIMA increments on every falling edge of the selected system counter bit, which is every time the system counter reaches a multiple of the bit period.
+// The unwrapped value is UNWRAPPED_TIMA_OVERFLOW_VALUE or more on the machine cycle between an overflow and its reload
+uint16_t InternalTimer::get_unwrapped_tima() const
+{
+    if (!is_tima_enabled())
+        return timer_tima_base;
+
+    const uint32_t system_counter_bit_period = get_selected_system_counter_bit_period();
+    const uint64_t increment_count = get_unwrapped_system_counter(event_scheduler.get_current_machine_cycle()) / system_counter_bit_period -
+                                     get_unwrapped_system_counter(timer_tima_base_machine_cycle) / system_counter_bit_period;
+    return static_cast<uint16_t>(timer_tima_base + increment_count);
+}
+
+void InternalTimer::set_unwrapped_tima(uint16_t unwrapped_tima)
+{
+    timer_tima_base = unwrapped_tima;
+    timer_tima_base_machine_cycle = event_scheduler.get_current_machine_cycle();
+    schedule_tima_reload();
 }
 
-void InternalTimer::update_tima_early()
+// Writes to DIV and TAC can cause a falling edge on the selected bit, which increments TIMA immediately and reloads it without the usual delay on overflow
+void InternalTimer::update_tima_early(bool was_selected_system_counter_bit_set, uint16_t unwrapped_tima)
 {
-    if (update_tima_and_get_overflow_state())
+    if (was_selected_system_counter_bit_set && !is_selected_system_counter_bit_set() && ++unwrapped_tima == UNWRAPPED_TIMA_OVERFLOW_VALUE)
     {
-        request_interrupt_callback(TIMER_INTERRUPT_FLAG_MASK);
-        timer_tima = timer_modulo_tma;
+        interrupt_registers.request_interrupt(TIMER_INTERRUPT_FLAG_MASK);
+        unwrapped_tima = timer_modulo_tma;
     }
+    set_unwrapped_tima(unwrapped_tima);
 }
 
-bool InternalTimer::update_tima_and_get_overflow_state()
+// A reload that is already pending is kept as it is, since only a TIMA write cancels it
+void InternalTimer::schedule_tima_reload()
 {
-    const bool is_tima_enabled = (timer_control_tac & 0b00000100) != 0;
+    if (timer_tima_base >= UNWRAPPED_TIMA_OVERFLOW_VALUE)
+        return;
 
-    const uint8_t clock_select = timer_control_tac & 0b00000011;
-    const uint8_t clock_select_to_selected_system_counter_bit[4] = {9, 3, 5, 7};
-    const uint8_t selected_system_counter_bit = clock_select_to_selected_system_counter_bit[clock_select];
-    const bool is_selected_system_counter_bit_set = is_tima_enabled && (system_counter & (1 << selected_system_counter_bit)) != 0;
+    if (!is_tima_enabled())
+    {
+        event_scheduler.cancel_event(ScheduledEventType::TimerCounterReload);
+        return;
+    }
+
+    const uint32_t system_counter_bit_period = get_selected_system_counter_bit_period();
+    const uint64_t system_counter = get_unwrapped_system_counter(timer_tima_base_machine_cycle);
+    const uint64_t system_counter_at_overflow = (system_counter / system_counter_bit_period + UNWRAPPED_TIMA_OVERFLOW_VALUE - timer_tima_base) * system_counter_bit_period;
+    const uint64_t overflow_machine_cycle = timer_tima_base_machine_cycle + (system_counter_at_overflow - system_counter) / SYSTEM_COUNTER_INCREMENT_PER_MACHINE_CYCLE;
+    event_scheduler.schedule_event_at_machine_cycle(ScheduledEventType::TimerCounterReload, overflow_machine_cycle + 1);
+}
+
+bool InternalTimer::is_tima_overflow_handled() const
+{
+    return tima_reload_machine_cycle == event_scheduler.get_current_machine_cycle();
+}
+
+bool InternalTimer::is_selected_system_counter_bit_set() const
+{
+    return is_tima_enabled() &&
+           (get_unwrapped_system_counter(event_scheduler.get_current_machine_cycle()) & (get_selected_system_counter_bit_period() >> 1)) != 0;
+}
 
-    const bool did_overflow_occur = !is_selected_system_counter_bit_set &&
-                                    is_previously_selected_system_counter_bit_set &&
-                                    (++timer_tima == 0);
+bool InternalTimer::is_tima_enabled() const
+{
+    return (timer_control_tac & 0b00000100) != 0;
+}
 
-    is_previously_selected_system_counter_bit_set = is_selected_system_counter_bit_set;
-    return did_overflow_occur;
+uint32_t InternalTimer::get_selected_system_counter_bit_period() const
+{
+    const uint8_t clock_select = timer_control_tac & 0b00000011;
+    const uint8_t clock_select_to_selected_system_counter_bit[4] = {9, 3, 5, 7};
+    return 1 << (clock_select_to_selected_system_counter_bit[clock_select] + 1);
 }
 
 } // namespace GameBoyEmulator
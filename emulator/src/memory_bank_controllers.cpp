@@ -1,4 +1,4 @@
-#include <bit>
+#include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -10,10 +10,11 @@
 namespace GameBoyEmulator
 {
 
-MemoryBankControllerBase::MemoryBankControllerBase(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram)
+MemoryBankControllerBase::MemoryBankControllerBase(std::span<const uint8_t> rom, std::span<uint8_t> ram)
     : cartridge_rom{rom},
       cartridge_ram{ram}
 {
+    map_rom_banks(0, 1);
 }
 
 uint8_t	MemoryBankControllerBase::read_byte(uint16_t address)
@@ -33,46 +34,68 @@ void MemoryBankControllerBase::write_byte(uint16_t address, uint8_t value)
               << "Attempted to write to read only address 0x" << std::setw(4) << address << " in a ROM-only cartridge. No operation will occur.\n";
 }
 
-MBC1::MBC1(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram)
+void MemoryBankControllerBase::track_save_data_writes(std::atomic<uint32_t>& save_data_dirty_mask)
+{
+    dirty_save_data_mask = &save_data_dirty_mask;
+}
+
+void MemoryBankControllerBase::map_real_time_clock_save_data(std::span<uint8_t>)
+{
+}
+
+void MemoryBankControllerBase::prepare_for_machine_cycle_counter_reset()
+{
+}
+
+void MemoryBankControllerBase::write_ram_bank_byte(uint16_t address, uint8_t value)
+{
+    writable_ram_bank_memory[address & (RAM_BANK_SIZE - 1)] = value;
+    mark_save_data_dirty(1u << ((writable_ram_bank_memory - cartridge_ram.data()) >> RAM_BANK_SIZE_POWER_OF_TWO));
+}
+
+void MemoryBankControllerBase::mark_save_data_dirty(uint32_t save_data_mask)
+{
+    if (dirty_save_data_mask != nullptr)
+    {
+        dirty_save_data_mask->fetch_or(save_data_mask, std::memory_order_release);
+    }
+}
+
+void MemoryBankControllerBase::map_rom_banks(uint16_t selected_rom_bank_x0_number, uint16_t selected_rom_bank_0x_number)
+{
+    rom_bank_x0_number = selected_rom_bank_x0_number;
+    rom_bank_0x_number = selected_rom_bank_0x_number;
+    rom_bank_x0_memory = cartridge_rom.data() + (static_cast<uint32_t>(rom_bank_x0_number) << ROM_BANK_SIZE_POWER_OF_TWO);
+    rom_bank_0x_memory = cartridge_rom.data() + (static_cast<uint32_t>(rom_bank_0x_number) << ROM_BANK_SIZE_POWER_OF_TWO);
+}
+
+// MBC1M multi-game compilations wire the upper two bank bits one line lower, so only four bits of the lower bank number reach the ROM
+MBC1::MBC1(std::span<const uint8_t> rom, std::span<uint8_t> ram, bool is_mbc1m_multi_game_compilation)
     : MemoryBankControllerBase{rom, ram}
 {
     number_of_rom_banks = rom.size() >> ROM_BANK_SIZE_POWER_OF_TWO;
     number_of_ram_banks = ram.size() >> RAM_BANK_SIZE_POWER_OF_TWO;
+    upper_two_bits_of_rom_bank_number_shift = is_mbc1m_multi_game_compilation ? 4 : 5;
+    remap_bank_memory();
 }
 
 uint8_t MBC1::read_byte(uint16_t address)
 {
     if (address < 0x4000)
     {
-        const uint8_t selected_rom_bank_number = (banking_mode == 1)
-            ? (ram_bank_number_or_upper_two_bits_of_rom_bank_number << 5) & (number_of_rom_banks - 1)
-            : 0;
-        const uint32_t selected_rom_bank_starting_address = selected_rom_bank_number << std::countr_zero(ROM_BANK_SIZE);
-        const uint32_t address_to_read = selected_rom_bank_starting_address | address;
-        return cartridge_rom[address_to_read];
+        return rom_bank_x0_memory[address];
     }
     else if (address < 0x8000)
     {
-        const uint8_t selected_rom_bank_number = (ram_bank_number_or_upper_two_bits_of_rom_bank_number << 5 | lower_five_bits_of_rom_bank_number) &
-                                                 (number_of_rom_banks - 1);
-        const uint32_t selected_rom_bank_starting_address = selected_rom_bank_number << std::countr_zero(ROM_BANK_SIZE);
-        const uint16_t selected_address_within_rom_bank = address & (ROM_BANK_SIZE - 1);
-        const uint32_t address_to_read = selected_rom_bank_starting_address | selected_address_within_rom_bank;
-        return cartridge_rom[address_to_read];
+        return rom_bank_0x_memory[address & (ROM_BANK_SIZE - 1)];
     }
     else if (address >= 0xA000 && address < 0xC000)
     {
-        if (!is_ram_enabled)
+        if (readable_ram_bank_memory == nullptr)
         {
             return 0xFF;
         }
-        const uint8_t selected_ram_bank_number = (banking_mode == 1)
-            ? ram_bank_number_or_upper_two_bits_of_rom_bank_number & (number_of_ram_banks - 1)
-            : 0;
-        const uint32_t selected_rom_bank_starting_address = selected_ram_bank_number << std::countr_zero(RAM_BANK_SIZE);
-        const uint16_t selected_address_within_rom_bank = address & (RAM_BANK_SIZE - 1);
-        const uint32_t address_to_read = selected_rom_bank_starting_address | selected_address_within_rom_bank;
-        return cartridge_ram[address_to_read];
+        return readable_ram_bank_memory[address & (RAM_BANK_SIZE - 1)];
     }
     throw std::runtime_error("Attemped to read from out of bounds address " + std::to_string(address) + " in the cartridge's ROM or RAM. Exiting.");
 }
@@ -82,52 +105,71 @@ void MBC1::write_byte(uint16_t address, uint8_t value)
     if (address < 0x2000)
     {
         is_ram_enabled = ((value & 0x0F) == 0x0A);
+        remap_bank_memory();
     }
     else if (address < 0x4000)
     {
         lower_five_bits_of_rom_bank_number = std::max(value & 0b11111, MINIMUM_ALLOWABLE_ROM_BANK_NUMBER);
+        remap_bank_memory();
     }
     else if (address < 0x6000)
     {
         ram_bank_number_or_upper_two_bits_of_rom_bank_number = (value & 0b11);
+        remap_bank_memory();
     }
     else if (address < 0x8000)
     {
         banking_mode = (value & 1);
+        remap_bank_memory();
     }
     else if (address >= 0xA000 && address < 0xC000)
     {
-        if (!is_ram_enabled)
+        if (writable_ram_bank_memory == nullptr)
         {
             return;
         }
-        const uint8_t selected_ram_bank_number = (banking_mode == 1)
-            ? ram_bank_number_or_upper_two_bits_of_rom_bank_number & (number_of_ram_banks - 1)
-            : 0;
-        const uint32_t address_to_write = (address & 0x1FFF) | (selected_ram_bank_number << 13);
-        cartridge_ram[address_to_write] = value;
+        write_ram_bank_byte(address, value);
     }
     else
         throw std::runtime_error("Attemped to write to an out of bounds address in the cartridge's ROM or RAM. Exiting.");
 }
 
-MBC2::MBC2(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram)
+void MBC1::remap_bank_memory()
+{
+    const uint8_t upper_two_bits_of_rom_bank_number = ram_bank_number_or_upper_two_bits_of_rom_bank_number << upper_two_bits_of_rom_bank_number_shift;
+    const uint8_t lower_bits_of_rom_bank_number = lower_five_bits_of_rom_bank_number & ((1 << upper_two_bits_of_rom_bank_number_shift) - 1);
+    const uint8_t selected_rom_bank_x0_number = (banking_mode == 1)
+        ? upper_two_bits_of_rom_bank_number & (number_of_rom_banks - 1)
+        : 0;
+    const uint8_t selected_rom_bank_0x_number = (upper_two_bits_of_rom_bank_number | lower_bits_of_rom_bank_number) & (number_of_rom_banks - 1);
+    map_rom_banks(selected_rom_bank_x0_number, selected_rom_bank_0x_number);
+
+    if (!is_ram_enabled || cartridge_ram.empty())
+    {
+        readable_ram_bank_memory = writable_ram_bank_memory = nullptr;
+        return;
+    }
+    const uint8_t selected_ram_bank_number = (banking_mode == 1)
+        ? ram_bank_number_or_upper_two_bits_of_rom_bank_number & (number_of_ram_banks - 1)
+        : 0;
+    readable_ram_bank_memory = writable_ram_bank_memory = cartridge_ram.data() + (selected_ram_bank_number << RAM_BANK_SIZE_POWER_OF_TWO);
+}
+
+MBC2::MBC2(std::span<const uint8_t> rom, std::span<uint8_t> ram)
     : MemoryBankControllerBase{rom, ram}
 {
+    remap_bank_memory();
 }
 
 uint8_t MBC2::read_byte(uint16_t address)
 {
     if (address < 0x4000)
     {
-        return cartridge_rom[address];
+        return rom_bank_x0_memory[address];
     }
     else if (address < 0x8000)
     {
-        const uint32_t selected_rom_bank_starting_address = selected_rom_bank_number << std::countr_zero(ROM_BANK_SIZE);
-        const uint16_t selected_address_within_rom_bank = address & (ROM_BANK_SIZE - 1);
-        const uint32_t address_to_read = (selected_rom_bank_starting_address | selected_address_within_rom_bank) & (cartridge_rom.size() - 1);
-        return cartridge_rom[address_to_read];
+        return rom_bank_0x_memory[address & (ROM_BANK_SIZE - 1)];
     }
     else if (address >= 0xA000 && address < 0xC000)
     {
@@ -157,6 +199,7 @@ void MBC2::write_byte(uint16_t address, uint8_t value)
             selected_rom_bank_number = MBC2::MINIMUM_ALLOWABLE_ROM_BANK_NUMBER;
             is_ram_enabled = ((value & 0x0F) == 0x0A);
         }
+        remap_bank_memory();
     }
     else if (address < 0x8000)
     {
@@ -171,64 +214,58 @@ void MBC2::write_byte(uint16_t address, uint8_t value)
         const uint16_t address_to_write = address & (MBC2::BUILT_IN_RAM_SIZE - 1);
         const uint8_t value_with_undefined_upper_nibble = value | 0xF0;
         cartridge_ram[address_to_write] = value_with_undefined_upper_nibble;
+        mark_save_data_dirty(1);
     }
     else
         throw std::runtime_error("Attemped to write to out of bounds address " + std::to_string(address) + " in the cartridge's ROM or RAM. Exiting.");
 }
 
-MBC3::MBC3(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram)
-    : MemoryBankControllerBase{rom, ram}
+// The built-in RAM is mirrored every 512 bytes and only stores the lower nibble, so it is never exposed as a bank for direct access
+void MBC2::remap_bank_memory()
+{
+    const uint32_t selected_rom_bank_starting_address = (selected_rom_bank_number << ROM_BANK_SIZE_POWER_OF_TWO) & (cartridge_rom.size() - 1);
+    map_rom_banks(0, selected_rom_bank_starting_address >> ROM_BANK_SIZE_POWER_OF_TWO);
+}
+
+MBC3::MBC3(std::span<const uint8_t> rom, std::span<uint8_t> ram, const EventScheduler& event_scheduler, RealTimeClockTimeSource time_source)
+    : MemoryBankControllerBase{rom, ram},
+      event_scheduler{event_scheduler},
+      real_time_clock_time_source{time_source}
 {
     number_of_rom_banks = rom.size() >> ROM_BANK_SIZE_POWER_OF_TWO;
     number_of_ram_banks = ram.size() >> RAM_BANK_SIZE_POWER_OF_TWO;
+    real_time_clock.time_base = get_real_time_clock_time();
+    remap_bank_memory();
+}
+
+// Emulated time that passed since the last clock register access would otherwise be lost when the cartridge is unloaded
+MBC3::~MBC3()
+{
+    update_real_time_clock();
+    save_real_time_clock();
 }
 
 uint8_t MBC3::read_byte(uint16_t address)
 {
     if (address < 0x4000)
     {
-        return cartridge_rom[address];
+        return rom_bank_x0_memory[address];
     }
     else if (address < 0x8000)
     {
-        const uint32_t selected_rom_bank_starting_address = selected_rom_bank_number << std::countr_zero(ROM_BANK_SIZE);
-        const uint16_t address_within_rom_bank = address & (ROM_BANK_SIZE - 1);
-        const uint32_t address_to_read = selected_rom_bank_starting_address | address_within_rom_bank;
-        return cartridge_rom[address_to_read];
+        return rom_bank_0x_memory[address & (ROM_BANK_SIZE - 1)];
     }
     else if (address >= 0xA000 && address < 0xC000)
     {
         if (selected_ram_bank_number_or_real_time_clock_register_select < 0x08)
         {
-            const uint32_t selected_ram_bank_starting_address = selected_ram_bank_number_or_real_time_clock_register_select << std::countr_zero(RAM_BANK_SIZE);
-            const uint16_t selected_address_within_ram_bank = address & (RAM_BANK_SIZE - 1);
-            const uint32_t address_to_read = (selected_ram_bank_starting_address | selected_address_within_ram_bank) & static_cast<uint32_t>(cartridge_ram.size() - 1);
-            return cartridge_ram[address_to_read];
+            return (readable_ram_bank_memory != nullptr) ? readable_ram_bank_memory[address & (RAM_BANK_SIZE - 1)] : 0xFF;
         }
-        else
+        else if (selected_ram_bank_number_or_real_time_clock_register_select <= 0x0C)
         {
-            switch (selected_ram_bank_number_or_real_time_clock_register_select)
-            {
-                case 0x08:
-                    return real_time_clock.seconds_counter;
-                case 0x09:
-                    return real_time_clock.minutes_counter;
-                case 0x0A:
-                    return real_time_clock.hours_counter;
-                case 0x0B:
-                    return real_time_clock.days_counter = real_time_clock.days_counter & 0x00FF;
-                case 0x0C:
-                {
-                    uint8_t result = 0;
-                    set_bit(result, 0, is_bit_set(real_time_clock.days_counter, 8));
-                    set_bit(result, 6, real_time_clock.is_halted);
-                    set_bit(result, 7, real_time_clock.is_day_counter_carry_set);
-                    return result;
-                }
-                default:
-                    return 0xFF;
-            }
+            return latched_real_time_clock_registers[selected_ram_bank_number_or_real_time_clock_register_select - 0x08];
         }
+        return 0xFF;
     }
     throw std::runtime_error("Attemped to read from out of bounds address " + std::to_string(address) + " in the cartridge's ROM or RAM. Exiting.");
 }
@@ -238,20 +275,24 @@ void MBC3::write_byte(uint16_t address, uint8_t value)
     if (address < 0x2000)
     {
         are_ram_and_real_time_clock_enabled = ((value & 0x0F) == 0x0A);
+        remap_bank_memory();
     }
     else if (address < 0x4000)
     {
         selected_rom_bank_number = std::max((value & 0b01111111) & (number_of_rom_banks - 1), MINIMUM_ALLOWABLE_ROM_BANK_NUMBER);
+        remap_bank_memory();
     }
     else if (address < 0x6000)
     {
         selected_ram_bank_number_or_real_time_clock_register_select = value;
+        remap_bank_memory();
     }
     else if (address < 0x8000)
     {
         if (value == 0x01 && real_time_clock.latch_clock_data == 0x00)
         {
-            real_time_clock.are_time_counters_latched = !real_time_clock.are_time_counters_latched;
+            update_real_time_clock();
+            latched_real_time_clock_registers = get_real_time_clock_registers();
         }
         real_time_clock.latch_clock_data = value;
     }
@@ -264,69 +305,271 @@ void MBC3::write_byte(uint16_t address, uint8_t value)
 
         if (selected_ram_bank_number_or_real_time_clock_register_select < 0x08)
         {
-            const uint32_t selected_ram_bank_starting_address = (selected_ram_bank_number_or_real_time_clock_register_select & (number_of_ram_banks - 1)) << std::countr_zero(RAM_BANK_SIZE);
-            const uint16_t selected_address_within_ram_bank = address & (RAM_BANK_SIZE - 1);
-            const uint32_t address_to_read = (selected_ram_bank_starting_address | selected_address_within_ram_bank) & static_cast<uint32_t>(cartridge_ram.size() - 1);
-            cartridge_ram[address_to_read] = value;
+            if (writable_ram_bank_memory != nullptr)
+            {
+                write_ram_bank_byte(address, value);
+            }
         }
-        else
+        else if (selected_ram_bank_number_or_real_time_clock_register_select <= 0x0C)
         {
+            update_real_time_clock();
             switch (selected_ram_bank_number_or_real_time_clock_register_select)
             {
                 case 0x08:
-                    real_time_clock.seconds_counter = value % 60;
+                    // Writing the seconds also restarts the sub-second divider
+                    real_time_clock.seconds_counter = value & SECONDS_AND_MINUTES_COUNTER_MASK;
+                    real_time_clock.time_base = get_real_time_clock_time();
                     break;
                 case 0x09:
-                    real_time_clock.minutes_counter = value % 60;
+                    real_time_clock.minutes_counter = value & SECONDS_AND_MINUTES_COUNTER_MASK;
                     break;
                 case 0x0A:
-                    real_time_clock.hours_counter = value % 24;
+                    real_time_clock.hours_counter = value & HOURS_COUNTER_MASK;
                     break;
                 case 0x0B:
                     real_time_clock.days_counter = (real_time_clock.days_counter & 0xFF00) | value;
                     break;
                 case 0x0C:
                     set_bit(real_time_clock.days_counter, 8, is_bit_set(value, 0));
-                    real_time_clock.is_halted = is_bit_set(6, value);
-                    real_time_clock.is_day_counter_carry_set = is_bit_set(7, value);
+                    real_time_clock.is_halted = is_bit_set(value, 6);
+                    real_time_clock.is_day_counter_carry_set = is_bit_set(value, 7);
                     break;
             }
+            latched_real_time_clock_registers[selected_ram_bank_number_or_real_time_clock_register_select - 0x08] =
+                get_real_time_clock_registers()[selected_ram_bank_number_or_real_time_clock_register_select - 0x08];
+            save_real_time_clock();
         }
     }
     else
         throw std::runtime_error("Attemped to write to an out of bounds address in the cartridge's ROM or RAM. Exiting.");
 }
 
-MBC5::MBC5(std::vector<uint8_t>& rom, std::vector<uint8_t>& ram)
+int64_t MBC3::get_real_time_clock_time() const
+{
+    if (real_time_clock_time_source == RealTimeClockTimeSource::EmulatedMachineCycles)
+    {
+        return static_cast<int64_t>(event_scheduler.get_current_machine_cycle());
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int64_t MBC3::get_real_time_clock_ticks_per_second() const
+{
+    return (real_time_clock_time_source == RealTimeClockTimeSource::EmulatedMachineCycles) ? MACHINE_CYCLES_PER_SECOND : HOST_SYSTEM_CLOCK_TICKS_PER_SECOND;
+}
+
+// Moves the time base forward by whole seconds only, so the fraction of a second already elapsed carries over to the next update
+void MBC3::update_real_time_clock()
+{
+    const int64_t current_time = get_real_time_clock_time();
+    if (real_time_clock.is_halted || current_time < real_time_clock.time_base)
+    {
+        real_time_clock.time_base = current_time;
+        return;
+    }
+    const int64_t ticks_per_second = get_real_time_clock_ticks_per_second();
+    const int64_t elapsed_seconds = (current_time - real_time_clock.time_base) / ticks_per_second;
+    real_time_clock.time_base += elapsed_seconds * ticks_per_second;
+    advance_real_time_clock_counters(static_cast<uint64_t>(elapsed_seconds));
+}
+
+// Counters written out of range keep counting up to the limit of their bits and wrap to zero there without carrying,
+// so whole seconds are only added at once after every counter is back in range, which takes at most eight hours
+void MBC3::advance_real_time_clock_counters(uint64_t elapsed_seconds)
+{
+    while (elapsed_seconds > 0 &&
+           (real_time_clock.seconds_counter >= 60 || real_time_clock.minutes_counter >= 60 || real_time_clock.hours_counter >= 24))
+    {
+        advance_real_time_clock_counters_by_one_second();
+        elapsed_seconds--;
+    }
+    if (elapsed_seconds == 0)
+    {
+        return;
+    }
+    uint64_t total = elapsed_seconds + real_time_clock.seconds_counter + (60 * real_time_clock.minutes_counter) + (3600 * real_time_clock.hours_counter);
+    real_time_clock.seconds_counter = total % 60;
+    total /= 60;
+    real_time_clock.minutes_counter = total % 60;
+    total /= 60;
+    real_time_clock.hours_counter = total % 24;
+    total /= 24;
+
+    // The carry flag stays set until the game clears it
+    uint64_t days = real_time_clock.days_counter + total;
+    if (days >= NUMBER_OF_DAYS_BEFORE_DAY_COUNTER_CARRY)
+    {
+        real_time_clock.is_day_counter_carry_set = true;
+        days %= NUMBER_OF_DAYS_BEFORE_DAY_COUNTER_CARRY;
+    }
+    real_time_clock.days_counter = static_cast<uint16_t>(days);
+}
+
+void MBC3::advance_real_time_clock_counters_by_one_second()
+{
+    real_time_clock.seconds_counter = (real_time_clock.seconds_counter + 1) & SECONDS_AND_MINUTES_COUNTER_MASK;
+    if (real_time_clock.seconds_counter != 60)
+    {
+        return;
+    }
+    real_time_clock.seconds_counter = 0;
+    real_time_clock.minutes_counter = (real_time_clock.minutes_counter + 1) & SECONDS_AND_MINUTES_COUNTER_MASK;
+    if (real_time_clock.minutes_counter != 60)
+    {
+        return;
+    }
+    real_time_clock.minutes_counter = 0;
+    real_time_clock.hours_counter = (real_time_clock.hours_counter + 1) & HOURS_COUNTER_MASK;
+    if (real_time_clock.hours_counter != 24)
+    {
+        return;
+    }
+    real_time_clock.hours_counter = 0;
+    if (++real_time_clock.days_counter == NUMBER_OF_DAYS_BEFORE_DAY_COUNTER_CARRY)
+    {
+        real_time_clock.is_day_counter_carry_set = true;
+        real_time_clock.days_counter = 0;
+    }
+}
+
+std::array<uint8_t, 5> MBC3::get_real_time_clock_registers() const
+{
+    uint8_t day_high = 0;
+    set_bit(day_high, 0, is_bit_set(real_time_clock.days_counter, 8));
+    set_bit(day_high, 6, real_time_clock.is_halted);
+    set_bit(day_high, 7, real_time_clock.is_day_counter_carry_set);
+    return
+    {
+        real_time_clock.seconds_counter,
+        real_time_clock.minutes_counter,
+        real_time_clock.hours_counter,
+        static_cast<uint8_t>(real_time_clock.days_counter),
+        day_high
+    };
+}
+
+// Emulated time restarts from zero on reset, the counters keep running like a battery-backed clock across a power cycle.
+// The time base goes negative by the fraction of a second already elapsed, so the next second still ends on time
+void MBC3::prepare_for_machine_cycle_counter_reset()
+{
+    update_real_time_clock();
+    if (real_time_clock_time_source == RealTimeClockTimeSource::EmulatedMachineCycles)
+    {
+        real_time_clock.time_base -= get_real_time_clock_time();
+    }
+}
+
+static uint64_t read_little_endian_value(const uint8_t* bytes, uint8_t byte_count)
+{
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < byte_count; i++)
+    {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+static void write_little_endian_value(uint8_t* bytes, uint8_t byte_count, uint64_t value)
+{
+    for (uint8_t i = 0; i < byte_count; i++)
+    {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static int64_t get_unix_timestamp()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// With host time the clock catches up on the time the emulator was closed, emulated time resumes where the last session stopped
+void MBC3::map_real_time_clock_save_data(std::span<uint8_t> save_data)
+{
+    if (save_data.size() < REAL_TIME_CLOCK_SAVE_DATA_SIZE)
+    {
+        return;
+    }
+    real_time_clock_save_data = save_data;
+
+    const uint8_t day_high = static_cast<uint8_t>(read_little_endian_value(&save_data[16], 4));
+    real_time_clock.seconds_counter = static_cast<uint8_t>(read_little_endian_value(&save_data[0], 4)) & SECONDS_AND_MINUTES_COUNTER_MASK;
+    real_time_clock.minutes_counter = static_cast<uint8_t>(read_little_endian_value(&save_data[4], 4)) & SECONDS_AND_MINUTES_COUNTER_MASK;
+    real_time_clock.hours_counter = static_cast<uint8_t>(read_little_endian_value(&save_data[8], 4)) & HOURS_COUNTER_MASK;
+    real_time_clock.days_counter = static_cast<uint8_t>(read_little_endian_value(&save_data[12], 4)) | ((day_high & 1) << 8);
+    real_time_clock.is_halted = is_bit_set(day_high, 6);
+    real_time_clock.is_day_counter_carry_set = is_bit_set(day_high, 7);
+    for (uint8_t i = 0; i < latched_real_time_clock_registers.size(); i++)
+    {
+        latched_real_time_clock_registers[i] = static_cast<uint8_t>(read_little_endian_value(&save_data[20 + 4 * i], 4));
+    }
+
+    const int64_t saved_unix_timestamp = static_cast<int64_t>(read_little_endian_value(&save_data[40], 8));
+    const int64_t unix_timestamp = get_unix_timestamp();
+    if (real_time_clock_time_source == RealTimeClockTimeSource::HostSystemClock && !real_time_clock.is_halted && unix_timestamp > saved_unix_timestamp)
+    {
+        advance_real_time_clock_counters(static_cast<uint64_t>(unix_timestamp - saved_unix_timestamp));
+    }
+    real_time_clock.time_base = get_real_time_clock_time();
+}
+
+// The trailer pairs the counters with the host time they were current at, which is all a later session needs to carry on from them
+void MBC3::save_real_time_clock()
+{
+    if (real_time_clock_save_data.empty())
+    {
+        return;
+    }
+    const std::array<uint8_t, 5> real_time_clock_registers = get_real_time_clock_registers();
+    for (uint8_t i = 0; i < real_time_clock_registers.size(); i++)
+    {
+        write_little_endian_value(&real_time_clock_save_data[4 * i], 4, real_time_clock_registers[i]);
+        write_little_endian_value(&real_time_clock_save_data[20 + 4 * i], 4, latched_real_time_clock_registers[i]);
+    }
+    write_little_endian_value(&real_time_clock_save_data[40], 8, static_cast<uint64_t>(get_unix_timestamp()));
+    mark_save_data_dirty(REAL_TIME_CLOCK_SAVE_DATA_DIRTY_MASK);
+}
+
+// RAM reads ignore the enable register, only writes check it
+void MBC3::remap_bank_memory()
+{
+    map_rom_banks(0, selected_rom_bank_number);
+
+    if (selected_ram_bank_number_or_real_time_clock_register_select >= 0x08 || cartridge_ram.empty())
+    {
+        readable_ram_bank_memory = writable_ram_bank_memory = nullptr;
+        return;
+    }
+    const uint32_t selected_ram_bank_starting_address = selected_ram_bank_number_or_real_time_clock_register_select << RAM_BANK_SIZE_POWER_OF_TWO;
+    uint8_t* selected_ram_bank_memory = cartridge_ram.data() + (selected_ram_bank_starting_address & static_cast<uint32_t>(cartridge_ram.size() - 1));
+    readable_ram_bank_memory = selected_ram_bank_memory;
+    writable_ram_bank_memory = are_ram_and_real_time_clock_enabled ? selected_ram_bank_memory : nullptr;
+}
+
+MBC5::MBC5(std::span<const uint8_t> rom, std::span<uint8_t> ram)
     : MemoryBankControllerBase{rom, ram}
 {
     number_of_rom_banks = rom.size() >> ROM_BANK_SIZE_POWER_OF_TWO;
     number_of_ram_banks = ram.size() >> RAM_BANK_SIZE_POWER_OF_TWO;
+    remap_bank_memory();
 }
 
 uint8_t MBC5::read_byte(uint16_t address)
 {
     if (address < 0x4000)
     {
-        return cartridge_rom[address];
+        return rom_bank_x0_memory[address];
     }
     else if (address < 0x8000)
     {
-        const uint32_t selected_rom_bank_starting_address = selected_rom_bank_number << std::countr_zero(ROM_BANK_SIZE);
-        const uint16_t address_within_rom_bank = address & (ROM_BANK_SIZE - 1);
-        const uint32_t address_to_read = selected_rom_bank_starting_address | address_within_rom_bank;
-        return cartridge_rom[address_to_read];
+        return rom_bank_0x_memory[address & (ROM_BANK_SIZE - 1)];
     }
     else if (address >= 0xA000 && address < 0xC000)
     {
-        if (!is_ram_enabled)
+        if (readable_ram_bank_memory == nullptr)
         {
             return 0xFF;
         }
-        const uint32_t selected_ram_bank_starting_address = selected_ram_bank_number << std::countr_zero(RAM_BANK_SIZE);
-        const uint16_t selected_address_within_ram_bank = address & (RAM_BANK_SIZE - 1);
-        const uint32_t address_to_read = (selected_ram_bank_starting_address | selected_address_within_ram_bank) & static_cast<uint32_t>(cartridge_ram.size() - 1);
-        return cartridge_ram[address_to_read];
+        return readable_ram_bank_memory[address & (RAM_BANK_SIZE - 1)];
     }
     throw std::runtime_error("Attemped to read from out of bounds address " + std::to_string(address) + " in the cartridge's ROM or RAM. Exiting.");
 }
@@ -336,20 +579,24 @@ void MBC5::write_byte(uint16_t address, uint8_t value)
     if (address < 0x2000)
     {
         is_ram_enabled = ((value & 0x0F) == 0x0A);
+        remap_bank_memory();
     }
     else if (address < 0x3000)
     {
         const uint8_t bits_0_to_7_of_rom_bank_number = value;
         selected_rom_bank_number = ((selected_rom_bank_number & 0xFF00) | bits_0_to_7_of_rom_bank_number) & (number_of_rom_banks - 1);
+        remap_bank_memory();
     }
     else if (address < 0x4000)
     {
         const uint16_t bit_8_of_rom_bank_number = (value & 1) << 8;
         selected_rom_bank_number = ((selected_rom_bank_number & 0x00FF) | bit_8_of_rom_bank_number) & (number_of_rom_banks - 1);
+        remap_bank_memory();
     }
     else if (address < 0x6000)
     {
         selected_ram_bank_number = value & (number_of_ram_banks - 1);
+        remap_bank_memory();
     }
     else if (address < 0x8000)
     {
@@ -357,17 +604,28 @@ void MBC5::write_byte(uint16_t address, uint8_t value)
     }
     else if (address >= 0xA000 && address < 0xC000)
     {
-        if (!is_ram_enabled)
+        if (writable_ram_bank_memory == nullptr)
         {
             return;
         }
-        const uint32_t selected_ram_bank_starting_address = selected_ram_bank_number << std::countr_zero(RAM_BANK_SIZE);
-        const uint16_t selected_address_within_ram_bank = address & (RAM_BANK_SIZE - 1);
-        const uint32_t address_to_write = selected_ram_bank_starting_address | selected_address_within_ram_bank;
-        cartridge_ram[address_to_write] = value;
+        write_ram_bank_byte(address, value);
     }
     else
         throw std::runtime_error("Attemped to write to out of bounds address " + std::to_string(address) + " in the cartridge's ROM or RAM. Exiting.");
 }
 
+void MBC5::remap_bank_memory()
+{
+    map_rom_banks(0, selected_rom_bank_number);
+
+    if (!is_ram_enabled || cartridge_ram.empty())
+    {
+        readable_ram_bank_memory = writable_ram_bank_memory = nullptr;
+        return;
+    }
+    const uint32_t selected_ram_bank_starting_address = selected_ram_bank_number << RAM_BANK_SIZE_POWER_OF_TWO;
+    readable_ram_bank_memory = writable_ram_bank_memory =
+        cartridge_ram.data() + (selected_ram_bank_starting_address & static_cast<uint32_t>(cartridge_ram.size() - 1));
+}
+
 } // namespace GameBoyEmulator
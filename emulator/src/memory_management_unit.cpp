@@ -12,39 +12,79 @@
 namespace GameBoyEmulator
 {
 
+// Serial and sound registers are only kept as storage until those peripherals are emulated, but their unused and write-only bits already read back as 1
+static constexpr std::array<std::pair<uint16_t, uint8_t>, 16> SERIAL_AND_SOUND_REGISTER_READ_MASKS
+{
+    {
+        {0xFF02, 0x7E},
+        {0xFF10, 0x80}, {0xFF11, 0x3F}, {0xFF13, 0xFF}, {0xFF14, 0xBF},
+        {0xFF16, 0x3F}, {0xFF18, 0xFF}, {0xFF19, 0xBF},
+        {0xFF1A, 0x7F}, {0xFF1B, 0xFF}, {0xFF1C, 0x9F}, {0xFF1D, 0xFF}, {0xFF1E, 0xBF},
+        {0xFF20, 0xFF}, {0xFF23, 0xBF}, {0xFF26, 0x70}
+    }
+};
+
+static constexpr std::array<std::pair<uint16_t, uint16_t>, 7> UNUSED_INPUT_OUTPUT_REGISTER_RANGES
+{
+    {
+        {0xFF03, 0x01},
+        {0xFF08, 0x07},
+        {0xFF15, 0x01},
+        {0xFF1F, 0x01},
+        {0xFF27, 0x09},
+        {0xFF4C, 0x04},
+        {0xFF51, 0x2F}
+    }
+};
+
+static constexpr std::array<std::pair<uint16_t, uint16_t>, 6> MEMORY_BUSES
+{
+    {
+        {ROM_BANK_X0_START, ROM_BANK_SIZE},
+        {ROM_BANK_0X_START, ROM_BANK_SIZE},
+        {VIDEO_RAM_START, VIDEO_RAM_SIZE},
+        {EXTERNAL_RAM_START, EXTERNAL_RAM_SIZE},
+        {WORK_RAM_START, WORK_RAM_SIZE},
+        {ECHO_RAM_START, ECHO_RAM_SIZE},
+    }
+};
+
 MemoryManagementUnit::MemoryManagementUnit(
     GameCartridgeSlot& game_cartridge_slot_reference,
+    InterruptRegisters& interrupt_registers_reference,
     InternalTimer& internal_timer_reference,
-    PixelProcessingUnit& pixel_processing_unit_reference)
+    PixelProcessingUnit& pixel_processing_unit_reference,
+    EventScheduler& event_scheduler_reference)
     : game_cartridge_slot{game_cartridge_slot_reference},
+      interrupt_registers{interrupt_registers_reference},
       internal_timer{internal_timer_reference},
-      pixel_processing_unit{pixel_processing_unit_reference}
+      pixel_processing_unit{pixel_processing_unit_reference},
+      event_scheduler{event_scheduler_reference}
 {
     boot_rom = std::make_unique<uint8_t[]>(BOOTROM_SIZE);
     work_ram = std::make_unique<uint8_t[]>(WORK_RAM_SIZE);
-    unmapped_input_output_registers = std::make_unique<uint8_t[]>(INPUT_OUTPUT_REGISTERS_SIZE);
     high_ram = std::make_unique<uint8_t[]>(HIGH_RAM_SIZE);
 
     std::fill_n(boot_rom.get(), BOOTROM_SIZE, 0);
     std::fill_n(work_ram.get(), WORK_RAM_SIZE, 0);
-    std::fill_n(unmapped_input_output_registers.get(), INPUT_OUTPUT_REGISTERS_SIZE, 0);
     std::fill_n(high_ram.get(), HIGH_RAM_SIZE, 0);
+    register_input_output_registers();
+    remap_memory_pages();
 }
 
 void MemoryManagementUnit::reset_state()
 {
     std::fill_n(work_ram.get(), WORK_RAM_SIZE, 0);
-    std::fill_n(unmapped_input_output_registers.get(), INPUT_OUTPUT_REGISTERS_SIZE, 0);
+    input_output_register_map.reset_state();
     std::fill_n(high_ram.get(), HIGH_RAM_SIZE, 0);
 
     joypad_p1_joyp = 0b11111111;
-    interrupt_flag_if = 0b11100000;
+    interrupt_registers.reset_state();
     boot_rom_status = 0x00;
-    interrupt_enable_ie = 0b00000000;
 
-    oam_dma_startup_state = ObjectAttributeMemoryDirectMemoryAccessStartupState::NotStarting;
     oam_dma_source_address_base = 0x0000;
     oam_dma_machine_cycles_elapsed = 0;
+    remap_memory_pages();
 }
 
 void MemoryManagementUnit::set_post_boot_state()
@@ -53,7 +93,7 @@ void MemoryManagementUnit::set_post_boot_state()
     joypad_p1_joyp = 0b11001111;
     write_byte(0xFF01, 0x00, false);
     write_byte(0xFF02, 0x7E, false);
-    interrupt_flag_if = 0b11100001;
+    interrupt_registers.set_post_boot_state();
     write_byte(0xFF10, 0x80, false);
     write_byte(0xFF11, 0xBF, false);
     write_byte(0xFF12, 0xF3, false);
@@ -75,11 +115,10 @@ void MemoryManagementUnit::set_post_boot_state()
     write_byte(0xFF24, 0x77, false);
     write_byte(0xFF25, 0xF3, false);
     write_byte(0xFF26, 0xF1, false);
-    interrupt_enable_ie = 0b00000000;
 
-    oam_dma_startup_state = ObjectAttributeMemoryDirectMemoryAccessStartupState::NotStarting;
     oam_dma_source_address_base = 0x0000;
     oam_dma_machine_cycles_elapsed = 0;
+    remap_memory_pages();
 }
 
 bool MemoryManagementUnit::try_load_file_to_read_only_memory(
@@ -87,18 +126,18 @@ bool MemoryManagementUnit::try_load_file_to_read_only_memory(
     FileType file_type,
     std::string& error_message)
 {
-    std::ifstream file(file_path, std::ios::binary | std::ios::ate);
-    if (!file)
-    {
-        return set_error_message_and_fail(
-            std::string("File not found at ") + file_path.string(),
-            error_message);
-    }
-    std::streamsize file_length_in_bytes = file.tellg();
-    file.seekg(0, std::ios::beg);
-
     if (file_type == FileType::BootROM)
     {
+        std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return set_error_message_and_fail(
+                std::string("File not found at ") + file_path.string(),
+                error_message);
+        }
+        std::streamsize file_length_in_bytes = file.tellg();
+        file.seekg(0, std::ios::beg);
+
         if (file_length_in_bytes != BOOTROM_SIZE)
         {
             return set_error_message_and_fail(
@@ -116,12 +155,14 @@ bool MemoryManagementUnit::try_load_file_to_read_only_memory(
     }
     else
     {
-        if (!game_cartridge_slot.try_load_file(file_path, file, file_length_in_bytes, error_message))
+        if (!game_cartridge_slot.try_load_file(file_path, error_message))
         {
             return false;
         }
         is_game_rom_loaded_in_memory_atomic.store(true, std::memory_order_release);
     }
+    dynamic_recompiler.clear();
+    remap_memory_pages();
     return true;
 }
 
@@ -131,10 +172,17 @@ void MemoryManagementUnit::unload_boot_rom_thread_safe()
     is_boot_rom_loaded_in_memory_atomic.store(false, std::memory_order_release);
 }
 
+// The cartridge pages point into the game ROM image, so they go through the slot's handlers before it releases the image
 void MemoryManagementUnit::unload_game_rom_thread_safe()
 {
-    game_cartridge_slot.reset_state();
     is_game_rom_loaded_in_memory_atomic.store(false, std::memory_order_release);
+    map_read_memory_pages(ROM_BANK_X0_START, ROM_BANK_SIZE, nullptr);
+    map_read_memory_pages(ROM_BANK_0X_START, ROM_BANK_SIZE, nullptr);
+    map_read_memory_pages(EXTERNAL_RAM_START, EXTERNAL_RAM_SIZE, nullptr);
+    map_write_memory_pages(EXTERNAL_RAM_START, EXTERNAL_RAM_SIZE, nullptr);
+    dynamic_recompiler.clear();
+    game_cartridge_slot.reset_state();
+    remap_memory_pages();
 }
 
 bool MemoryManagementUnit::is_game_rom_loaded_thread_safe() const
@@ -152,7 +200,84 @@ bool MemoryManagementUnit::is_boot_rom_mapped() const
     return (boot_rom_status == 0);
 }
 
-uint8_t MemoryManagementUnit::read_byte(uint16_t address, bool is_access_unrestricted) const
+void MemoryManagementUnit::register_input_output_registers()
+{
+    interrupt_registers.register_input_output_registers(input_output_register_map);
+    internal_timer.register_input_output_registers(input_output_register_map);
+    pixel_processing_unit.register_input_output_registers(input_output_register_map);
+
+    input_output_register_map.register_member_functions<
+        MemoryManagementUnit, &MemoryManagementUnit::read_joypad_p1_joyp, &MemoryManagementUnit::write_joypad_p1_joyp>(0xFF00, *this);
+    input_output_register_map.register_member_functions<
+        MemoryManagementUnit, &MemoryManagementUnit::read_oam_dma_source_dma, &MemoryManagementUnit::write_oam_dma_source_dma>(0xFF46, *this);
+    // The boot ROM status can only be written, reads always return 0xFF
+    input_output_register_map.register_member_functions<
+        MemoryManagementUnit, &MemoryManagementUnit::read_boot_rom_status, &MemoryManagementUnit::write_boot_rom_status>(0xFF50, *this, 0xFF);
+
+    for (const auto &[address, read_mask] : SERIAL_AND_SOUND_REGISTER_READ_MASKS)
+    {
+        input_output_register_map.set_read_mask(address, read_mask);
+    }
+    for (const auto &[range_start, range_size] : UNUSED_INPUT_OUTPUT_REGISTER_RANGES)
+    {
+        for (uint16_t address = range_start; address < range_start + range_size; address++)
+        {
+            input_output_register_map.set_read_mask(address, 0xFF);
+        }
+    }
+}
+
+uint8_t MemoryManagementUnit::read_joypad_p1_joyp() const
+{
+    const bool is_select_buttons_enabled = !is_bit_set(joypad_p1_joyp, 5);
+    const bool is_select_directional_pad_enabled = !is_bit_set(joypad_p1_joyp, 4);
+
+    if (is_select_directional_pad_enabled)
+    {
+        const uint8_t most_recent_direction_pad_states = 
+            most_recent_currently_pressed_vertical_direction_atomic.load(std::memory_order_acquire) &
+            most_recent_currently_pressed_horizontal_direction_atomic.load(std::memory_order_acquire);
+        if (is_select_buttons_enabled)
+        {
+            return (joypad_p1_joyp & 0xF0) | ((button_pressed_states_atomic.load(std::memory_order_acquire) | most_recent_direction_pad_states) & 0x0F);
+        }
+        return (joypad_p1_joyp & 0xF0) | (most_recent_direction_pad_states & 0x0F);
+    }
+    else if (is_select_buttons_enabled)
+    {
+        return (joypad_p1_joyp & 0xF0) | (button_pressed_states_atomic.load(std::memory_order_acquire) & 0x0F);
+    }
+    return joypad_p1_joyp;
+}
+
+void MemoryManagementUnit::write_joypad_p1_joyp(uint8_t value)
+{
+    joypad_p1_joyp = value | 0b11001111;
+}
+
+uint8_t MemoryManagementUnit::read_oam_dma_source_dma() const
+{
+    return pixel_processing_unit.object_attribute_memory_direct_memory_access_dma;
+}
+
+void MemoryManagementUnit::write_oam_dma_source_dma(uint8_t value)
+{
+    pixel_processing_unit.object_attribute_memory_direct_memory_access_dma = value;
+    event_scheduler.schedule_event(ScheduledEventType::ObjectAttributeMemoryDirectMemoryAccessStartup, OAM_DMA_STARTUP_MACHINE_CYCLE_DELAY);
+}
+
+uint8_t MemoryManagementUnit::read_boot_rom_status() const
+{
+    return boot_rom_status;
+}
+
+void MemoryManagementUnit::write_boot_rom_status(uint8_t value)
+{
+    boot_rom_status = value;
+    remap_cartridge_memory_pages();
+}
+
+uint8_t MemoryManagementUnit::read_byte_from_handlers(uint16_t address, bool is_access_unrestricted) const
 {
     const bool does_dma_bus_conflict_occur = !is_access_unrestricted &&
                                              pixel_processing_unit.is_oam_dma_in_progress &&
@@ -199,70 +324,7 @@ uint8_t MemoryManagementUnit::read_byte(uint16_t address, bool is_access_unrestr
     }
     else if (address < INPUT_OUTPUT_REGISTERS_START + INPUT_OUTPUT_REGISTERS_SIZE)
     {
-        switch (address)
-        {
-            case 0xFF00:
-            {
-                const bool is_select_buttons_enabled = !is_bit_set(joypad_p1_joyp, 5);
-                const bool is_select_directional_pad_enabled = !is_bit_set(joypad_p1_joyp, 4);
-
-                if (is_select_directional_pad_enabled)
-                {
-                    const uint8_t most_recent_direction_pad_states = 
-                        most_recent_currently_pressed_vertical_direction_atomic.load(std::memory_order_acquire) &
-                        most_recent_currently_pressed_horizontal_direction_atomic.load(std::memory_order_acquire);
-                    if (is_select_buttons_enabled)
-                    {
-                        return (joypad_p1_joyp & 0xF0) | ((button_pressed_states_atomic.load(std::memory_order_acquire) | most_recent_direction_pad_states) & 0x0F);
-                    }
-                    return (joypad_p1_joyp & 0xF0) | (most_recent_direction_pad_states & 0x0F);
-                }
-                else if (is_select_buttons_enabled)
-                {
-                    return (joypad_p1_joyp & 0xF0) | (button_pressed_states_atomic.load(std::memory_order_acquire) & 0x0F);
-                }
-                return joypad_p1_joyp;
-            }
-            case 0xFF04:
-                return internal_timer.read_div();
-            case 0xFF05:
-                return internal_timer.read_tima();
-            case 0xFF06:
-                return internal_timer.read_tma();
-            case 0xFF07:
-                return internal_timer.read_tac();
-            case 0xFF0F:
-                return interrupt_flag_if | 0b11100000;
-            case 0xFF40:
-                return pixel_processing_unit.read_lcd_control_lcdc();
-            case 0xFF41:
-                return pixel_processing_unit.read_lcd_status_stat();
-            case 0xFF42:
-                return pixel_processing_unit.viewport_y_position_scy;
-            case 0xFF43:
-                return pixel_processing_unit.viewport_x_position_scx;
-            case 0xFF44:
-                return pixel_processing_unit.read_lcd_y_coordinate_ly();
-            case 0xFF45:
-                return pixel_processing_unit.lcd_y_coordinate_compare_lyc;
-            case 0xFF46:
-                return pixel_processing_unit.object_attribute_memory_direct_memory_access_dma;
-            case 0xFF47:
-                return pixel_processing_unit.background_palette_bgp;
-            case 0xFF48:
-                return pixel_processing_unit.object_palette_0_obp0;
-            case 0xFF49:
-                return pixel_processing_unit.object_palette_1_obp1;
-            case 0xFF4A:
-                return pixel_processing_unit.window_y_position_wy;
-            case 0xFF4B:
-                return pixel_processing_unit.window_x_position_plus_7_wx;
-            case 0xFF50:
-                return boot_rom_status;
-            default:
-                const uint16_t local_address = address - INPUT_OUTPUT_REGISTERS_START;
-                return unmapped_input_output_registers[local_address];
-        }
+        return input_output_register_map.read_byte(address);
     }
     else if (address < HIGH_RAM_START + HIGH_RAM_SIZE)
     {
@@ -270,14 +332,15 @@ uint8_t MemoryManagementUnit::read_byte(uint16_t address, bool is_access_unrestr
         return high_ram[local_address];
     }
     else
-        return interrupt_enable_ie;
+        return interrupt_registers.read_interrupt_enable_ie();
 }
 
-void MemoryManagementUnit::write_byte(uint16_t address, uint8_t value, bool is_access_unrestricted)
+void MemoryManagementUnit::write_byte_to_handlers(uint16_t address, uint8_t value, bool is_access_unrestricted)
 {
     if (address < ROM_BANK_0X_START + ROM_BANK_SIZE)
     {
         game_cartridge_slot.write_byte(address, value);
+        remap_cartridge_memory_pages();
     }
     else if (address < VIDEO_RAM_START + VIDEO_RAM_SIZE)
     {
@@ -308,72 +371,7 @@ void MemoryManagementUnit::write_byte(uint16_t address, uint8_t value, bool is_a
     }
     else if (address < INPUT_OUTPUT_REGISTERS_START + INPUT_OUTPUT_REGISTERS_SIZE)
     {
-        switch (address)
-        {
-            case 0xFF00:
-                joypad_p1_joyp = value | 0b11001111;
-                return;
-            case 0xFF04:
-                internal_timer.write_div(value);
-                return;
-            case 0xFF05:
-                internal_timer.write_tima(value);
-                return;
-            case 0xFF06:
-                internal_timer.write_tma(value);
-                return;
-            case 0xFF07:
-                internal_timer.write_tac(value);
-                return;
-            case 0xFF0F:
-                interrupt_flag_if = value | 0b11100000;
-                return;
-            case 0xFF40:
-                pixel_processing_unit.write_lcd_control_lcdc(value);
-                return;
-            case 0xFF41:
-                pixel_processing_unit.write_lcd_status_stat(value);
-                return;
-            case 0xFF42:
-                pixel_processing_unit.viewport_y_position_scy = value;
-                return;
-            case 0xFF43:
-                pixel_processing_unit.viewport_x_position_scx = value;
-                return;
-            case 0xFF44:
-                std::cout << std::hex << std::setfill('0') 
-                          << "Attempted to write to read only address 0x" << std::setw(4) << address << ". No write will occur.\n";
-                return;
-            case 0xFF45:
-                pixel_processing_unit.lcd_y_coordinate_compare_lyc = value;
-                return;
-            case 0xFF46:
-                pixel_processing_unit.object_attribute_memory_direct_memory_access_dma = value;
-                oam_dma_startup_state = ObjectAttributeMemoryDirectMemoryAccessStartupState::RegisterWrittenTo;
-                return;
-            case 0xFF47:
-                pixel_processing_unit.background_palette_bgp = value;
-                return;
-            case 0xFF48:
-                pixel_processing_unit.object_palette_0_obp0 = value;
-                return;
-            case 0xFF49:
-                pixel_processing_unit.object_palette_1_obp1 = value;
-                return;
-            case 0xFF4A:
-                pixel_processing_unit.window_y_position_wy = value;
-                return;
-            case 0xFF4B:
-                pixel_processing_unit.window_x_position_plus_7_wx = value;
-                return;
-            case 0xFF50:
-                boot_rom_status = value;
-                return;
-            default:
-                const uint16_t local_address = address - INPUT_OUTPUT_REGISTERS_START;
-                unmapped_input_output_registers[local_address] = value;
-                return;
-        }
+        input_output_register_map.write_byte(address, value);
     }
     else if (address < HIGH_RAM_START + HIGH_RAM_SIZE)
     {
@@ -381,65 +379,51 @@ void MemoryManagementUnit::write_byte(uint16_t address, uint8_t value, bool is_a
         high_ram[local_address] = value;
     }
     else
-        interrupt_enable_ie = value;
+        interrupt_registers.write_interrupt_enable_ie(value);
 }
 
-void MemoryManagementUnit::step_single_machine_cycle()
+// Only ROM is translated, the boot ROM is left to the interpreter while it is mapped
+const TranslatedBlock* MemoryManagementUnit::get_translated_block(uint16_t address)
 {
-    if (pixel_processing_unit.is_oam_dma_in_progress)
-    {
-        const uint16_t source_address = oam_dma_source_address_base + oam_dma_machine_cycles_elapsed;
-        const uint8_t byte_to_copy = read_byte(source_address, true);
-
-        const uint16_t destination_address = OBJECT_ATTRIBUTE_MEMORY_START + oam_dma_machine_cycles_elapsed;
-        write_byte(destination_address, byte_to_copy, true);
+    const bool is_translatable_address = address < ROM_BANK_0X_START + ROM_BANK_SIZE && !(is_boot_rom_mapped() && address < BOOTROM_SIZE);
+    if (!is_translatable_address)
+        return nullptr;
 
-        if (++oam_dma_machine_cycles_elapsed == OAM_DMA_MACHINE_CYCLE_DURATION)
-        {
-            pixel_processing_unit.is_oam_dma_in_progress = false;
-        }
-    }
-
-    if (oam_dma_startup_state == ObjectAttributeMemoryDirectMemoryAccessStartupState::RegisterWrittenTo)
-    {
-        oam_dma_startup_state = ObjectAttributeMemoryDirectMemoryAccessStartupState::Starting;
-    }
-    else if (oam_dma_startup_state == ObjectAttributeMemoryDirectMemoryAccessStartupState::Starting)
-    {
-        oam_dma_source_address_base = ((pixel_processing_unit.object_attribute_memory_direct_memory_access_dma >= 0xFE)
-            ? pixel_processing_unit.object_attribute_memory_direct_memory_access_dma - 0x20
-            : pixel_processing_unit.object_attribute_memory_direct_memory_access_dma) << 8;
-
-        oam_dma_machine_cycles_elapsed = 0;
-        pixel_processing_unit.is_oam_dma_in_progress = true;
-        oam_dma_startup_state = ObjectAttributeMemoryDirectMemoryAccessStartupState::NotStarting;
-    }
+    return dynamic_recompiler.get_translated_block(address, read_memory_pages.data());
 }
 
-void MemoryManagementUnit::request_interrupt(uint8_t interrupt_flag_mask)
+void MemoryManagementUnit::start_oam_dma()
 {
-    update_flag(interrupt_flag_if, interrupt_flag_mask, true);
-}
+    oam_dma_source_address_base = ((pixel_processing_unit.object_attribute_memory_direct_memory_access_dma >= 0xFE)
+        ? pixel_processing_unit.object_attribute_memory_direct_memory_access_dma - 0x20
+        : pixel_processing_unit.object_attribute_memory_direct_memory_access_dma) << 8;
 
-void MemoryManagementUnit::clear_interrupt_flag_bit(uint8_t interrupt_flag_mask)
-{
-    update_flag(interrupt_flag_if, interrupt_flag_mask, false);
+    oam_dma_machine_cycles_elapsed = 0;
+    pixel_processing_unit.fall_back_to_pixel_fifo_for_scanline();
+    pixel_processing_unit.catch_up_object_attribute_memory_scan();
+    pixel_processing_unit.is_oam_dma_in_progress = true;
+    remap_memory_pages();
+    event_scheduler.schedule_event(ScheduledEventType::ObjectAttributeMemoryDirectMemoryAccessTransfer, 1);
 }
 
-uint8_t MemoryManagementUnit::get_pending_interrupt_mask() const
+void MemoryManagementUnit::transfer_oam_dma_byte()
 {
-    for (uint8_t i = 0; i < NUMBER_OF_INTERRUPT_TYPES; i++)
-    {
-        const uint8_t interrupt_flag_mask = 1 << i;
-        const bool is_interrupt_type_requested = is_flag_set(interrupt_flag_if, interrupt_flag_mask);
-        const bool is_interrupt_type_enabled = is_flag_set(interrupt_enable_ie, interrupt_flag_mask);
+    const uint16_t source_address = oam_dma_source_address_base + oam_dma_machine_cycles_elapsed;
+    const uint8_t byte_to_copy = read_byte(source_address, true);
 
-        if (is_interrupt_type_requested && is_interrupt_type_enabled)
-        {
-            return interrupt_flag_mask;
-        }
+    const uint16_t destination_address = OBJECT_ATTRIBUTE_MEMORY_START + oam_dma_machine_cycles_elapsed;
+    write_byte(destination_address, byte_to_copy, true);
+
+    if (++oam_dma_machine_cycles_elapsed == OAM_DMA_MACHINE_CYCLE_DURATION)
+    {
+        pixel_processing_unit.catch_up_object_attribute_memory_scan();
+        pixel_processing_unit.is_oam_dma_in_progress = false;
+        remap_memory_pages();
+    }
+    else
+    {
+        event_scheduler.schedule_event(ScheduledEventType::ObjectAttributeMemoryDirectMemoryAccessTransfer, 1);
     }
-    return 0x00;
 }
 
 void MemoryManagementUnit::update_button_pressed_state_thread_safe(uint8_t button_flag_mask, bool is_button_pressed)
@@ -507,20 +491,65 @@ void MemoryManagementUnit::update_dpad_direction_pressed_state_thread_safe(uint8
     }
 }
 
-bool MemoryManagementUnit::are_addresses_on_same_bus(uint16_t first_address, uint16_t second_address) const
+void MemoryManagementUnit::remap_memory_pages()
+{
+    map_read_memory_pages(WORK_RAM_START, WORK_RAM_SIZE, work_ram.get());
+    map_read_memory_pages(ECHO_RAM_START, ECHO_RAM_SIZE, work_ram.get());
+    map_write_memory_pages(WORK_RAM_START, WORK_RAM_SIZE, work_ram.get());
+    map_write_memory_pages(ECHO_RAM_START, ECHO_RAM_SIZE, work_ram.get());
+    remap_cartridge_memory_pages();
+}
+
+// Called whenever a banking register or the boot ROM status is written, since either can change what the cartridge pages point to
+void MemoryManagementUnit::remap_cartridge_memory_pages()
+{
+    map_read_memory_pages(ROM_BANK_X0_START, ROM_BANK_SIZE, game_cartridge_slot.get_rom_bank_x0_memory());
+    map_read_memory_pages(ROM_BANK_0X_START, ROM_BANK_SIZE, game_cartridge_slot.get_rom_bank_0x_memory());
+    map_read_memory_pages(EXTERNAL_RAM_START, EXTERNAL_RAM_SIZE, game_cartridge_slot.get_readable_ram_bank_memory());
+    map_write_memory_pages(EXTERNAL_RAM_START, EXTERNAL_RAM_SIZE, game_cartridge_slot.get_writable_ram_bank_memory());
+    if (is_boot_rom_mapped())
+    {
+        read_memory_pages[0] = boot_rom.get();
+    }
+    unmap_oam_dma_source_bus_read_memory_pages();
+    dynamic_recompiler.map_rom_banks(
+        game_cartridge_slot.get_rom_bank_number(ROM_BANK_X0_START),
+        game_cartridge_slot.get_rom_bank_number(ROM_BANK_0X_START));
+}
+
+void MemoryManagementUnit::map_read_memory_pages(uint16_t start_address, uint16_t size, const uint8_t* memory)
 {
-    static constexpr std::array<std::pair<uint16_t, uint16_t>, 6> MEMORY_BUSES
+    for (uint16_t offset = 0; offset < size; offset += MEMORY_PAGE_SIZE)
     {
+        read_memory_pages[(start_address + offset) >> MEMORY_PAGE_SIZE_POWER_OF_TWO] = (memory != nullptr) ? memory + offset : nullptr;
+    }
+}
+
+void MemoryManagementUnit::map_write_memory_pages(uint16_t start_address, uint16_t size, uint8_t* memory)
+{
+    for (uint16_t offset = 0; offset < size; offset += MEMORY_PAGE_SIZE)
+    {
+        write_memory_pages[(start_address + offset) >> MEMORY_PAGE_SIZE_POWER_OF_TWO] = (memory != nullptr) ? memory + offset : nullptr;
+    }
+}
+
+// Reads from the bus an OAM DMA is using see the byte being transferred, so they go through the handlers until it ends
+void MemoryManagementUnit::unmap_oam_dma_source_bus_read_memory_pages()
+{
+    if (!pixel_processing_unit.is_oam_dma_in_progress)
+        return;
+
+    for (auto &[bus_start, bus_size] : MEMORY_BUSES)
+    {
+        if (oam_dma_source_address_base >= bus_start && oam_dma_source_address_base < bus_start + bus_size)
         {
-            {ROM_BANK_X0_START, ROM_BANK_SIZE},
-            {ROM_BANK_0X_START, ROM_BANK_SIZE},
-            {VIDEO_RAM_START, VIDEO_RAM_SIZE},
-            {EXTERNAL_RAM_START, EXTERNAL_RAM_SIZE},
-            {WORK_RAM_START, WORK_RAM_SIZE},
-            {ECHO_RAM_START, ECHO_RAM_SIZE},
+            map_read_memory_pages(bus_start, bus_size, nullptr);
         }
-    };
+    }
+}
 
+bool MemoryManagementUnit::are_addresses_on_same_bus(uint16_t first_address, uint16_t second_address) const
+{
     auto in_range = [](uint16_t address, uint16_t range_start, uint16_t range_size)
     {
         return address >= range_start && address < range_start + range_size;
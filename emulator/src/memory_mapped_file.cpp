@@ -0,0 +1,190 @@
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "console_output_utilities.h"
+#include "memory_mapped_file.h"
+
+namespace GameBoyEmulator
+{
+
+std::unique_ptr<MemoryMappedFile> MemoryMappedFile::try_map_read_only(const std::filesystem::path& file_path, std::string& error_message)
+{
+    std::unique_ptr<MemoryMappedFile> memory_mapped_file{new MemoryMappedFile{}};
+
+#ifdef _WIN32
+    const HANDLE file_handle = CreateFileW(
+        file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        set_error_message_and_fail(std::string("File not found at ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+    {
+        CloseHandle(file_handle);
+        set_error_message_and_fail(std::string("Could not map empty or unreadable file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    const HANDLE file_mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file_handle);
+    if (file_mapping_handle == nullptr)
+    {
+        set_error_message_and_fail(std::string("Could not map file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+
+    // The view keeps the file mapping alive after both handles are closed
+    void* mapped_memory = MapViewOfFile(file_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(file_mapping_handle);
+    if (mapped_memory == nullptr)
+    {
+        set_error_message_and_fail(std::string("Could not map file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    memory_mapped_file->mapped_memory = static_cast<uint8_t*>(mapped_memory);
+    memory_mapped_file->mapped_size = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int file_descriptor = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor == -1)
+    {
+        set_error_message_and_fail(std::string("File not found at ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    struct stat file_status{};
+    if (fstat(file_descriptor, &file_status) == -1 || file_status.st_size == 0)
+    {
+        close(file_descriptor);
+        set_error_message_and_fail(std::string("Could not map empty or unreadable file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+
+    // The mapping stays valid after the file descriptor is closed, but keeps following the file contents
+    void* mapped_memory = mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+    if (mapped_memory == MAP_FAILED)
+    {
+        set_error_message_and_fail(std::string("Could not map file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    memory_mapped_file->mapped_memory = static_cast<uint8_t*>(mapped_memory);
+    memory_mapped_file->mapped_size = static_cast<size_t>(file_status.st_size);
+#endif
+
+    return memory_mapped_file;
+}
+
+std::unique_ptr<MemoryMappedFile> MemoryMappedFile::try_map_read_write(
+    const std::filesystem::path& file_path,
+    size_t size,
+    size_t& previous_file_size,
+    std::string& error_message)
+{
+    std::unique_ptr<MemoryMappedFile> memory_mapped_file{new MemoryMappedFile{}};
+
+#ifdef _WIN32
+    const HANDLE file_handle = CreateFileW(
+        file_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        set_error_message_and_fail(std::string("Could not open or create file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file_handle, &file_size))
+    {
+        CloseHandle(file_handle);
+        set_error_message_and_fail(std::string("Could not read the size of file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    previous_file_size = static_cast<size_t>(file_size.QuadPart);
+
+    // Mapping more than the file holds extends it with zeros
+    const uint64_t mapping_size = std::max<uint64_t>(size, previous_file_size);
+    const HANDLE file_mapping_handle = CreateFileMappingW(
+        file_handle, nullptr, PAGE_READWRITE, static_cast<DWORD>(mapping_size >> 32), static_cast<DWORD>(mapping_size), nullptr);
+    CloseHandle(file_handle);
+    if (file_mapping_handle == nullptr)
+    {
+        set_error_message_and_fail(std::string("Could not map file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    void* mapped_memory = MapViewOfFile(file_mapping_handle, FILE_MAP_WRITE, 0, 0, size);
+    CloseHandle(file_mapping_handle);
+    if (mapped_memory == nullptr)
+    {
+        set_error_message_and_fail(std::string("Could not map file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+#else
+    const int file_descriptor = open(file_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file_descriptor == -1)
+    {
+        set_error_message_and_fail(std::string("Could not open or create file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    struct stat file_status{};
+    if (fstat(file_descriptor, &file_status) == -1)
+    {
+        close(file_descriptor);
+        set_error_message_and_fail(std::string("Could not read the size of file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    previous_file_size = static_cast<size_t>(file_status.st_size);
+
+    if (previous_file_size < size && ftruncate(file_descriptor, static_cast<off_t>(size)) == -1)
+    {
+        close(file_descriptor);
+        set_error_message_and_fail(std::string("Could not extend file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+    void* mapped_memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+    if (mapped_memory == MAP_FAILED)
+    {
+        set_error_message_and_fail(std::string("Could not map file ") + file_path.string(), error_message);
+        return nullptr;
+    }
+#endif
+
+    memory_mapped_file->mapped_memory = static_cast<uint8_t*>(mapped_memory);
+    memory_mapped_file->mapped_size = size;
+    return memory_mapped_file;
+}
+
+void MemoryMappedFile::flush(size_t offset, size_t length)
+{
+#ifdef _WIN32
+    FlushViewOfFile(mapped_memory + offset, length);
+#else
+    // msync needs a page aligned start address
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t page_aligned_offset = offset & ~(page_size - 1);
+    msync(mapped_memory + page_aligned_offset, length + (offset - page_aligned_offset), MS_SYNC);
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (mapped_memory == nullptr)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapped_memory);
+#else
+    munmap(mapped_memory, mapped_size);
+#endif
+}
+
+} // namespace GameBoyEmulator
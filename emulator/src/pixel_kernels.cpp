@@ -0,0 +1,345 @@
+#include "pixel_kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PIXEL_KERNELS_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace GameBoyEmulator
+{
+
+namespace
+{
+
+constexpr uint8_t PALETTE_PRIORITY_BIT_MASK = 0b10000000;
+constexpr uint8_t PALETTE_NUMBER_BIT_MASK = 0b00010000;
+
+// Whether each pixel shows the object layer follows from the LCDC bits alone, except when both layers are enabled
+enum class ObjectLayerSelection
+{
+    Never,
+    Always,
+    ByPriority
+};
+
+ObjectLayerSelection get_object_layer_selection(const ScanlineLayers& scanline_layers)
+{
+    if (!scanline_layers.are_objects_selected)
+        return ObjectLayerSelection::Never;
+    if (!scanline_layers.are_background_and_window_enabled)
+        return ObjectLayerSelection::Always;
+    return scanline_layers.is_object_display_enabled
+        ? ObjectLayerSelection::ByPriority
+        : ObjectLayerSelection::Never;
+}
+
+ScanlineLayers get_scanline_layers_from_pixel(const ScanlineLayers& scanline_layers, size_t pixel_index)
+{
+    ScanlineLayers offset_scanline_layers = scanline_layers;
+    offset_scanline_layers.background_colour_indices += pixel_index;
+    offset_scanline_layers.object_colour_indices += pixel_index;
+    offset_scanline_layers.object_flags += pixel_index;
+    return offset_scanline_layers;
+}
+
+uint8_t get_palette_shade(uint8_t palette, uint8_t colour_index)
+{
+    return (palette >> (colour_index << 1)) & 0b11;
+}
+
+void decode_tile_row_scalar(uint8_t tile_row_low, uint8_t tile_row_high, uint8_t* decoded_tile_row_and_flipped)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        const uint8_t bit_position = 7 - i;
+        const uint8_t colour_index = static_cast<uint8_t>((((tile_row_high >> bit_position) & 1) << 1) | ((tile_row_low >> bit_position) & 1));
+        decoded_tile_row_and_flipped[i] = colour_index;
+        decoded_tile_row_and_flipped[15 - i] = colour_index;
+    }
+}
+
+void compose_scanline_scalar(const ScanlineLayers& scanline_layers, uint8_t* shades, size_t pixel_count)
+{
+    const ObjectLayerSelection object_layer_selection = get_object_layer_selection(scanline_layers);
+    for (size_t i = 0; i < pixel_count; i++)
+    {
+        const uint8_t background_colour_index = scanline_layers.are_background_and_window_enabled
+            ? scanline_layers.background_colour_indices[i]
+            : 0b00;
+        const uint8_t object_colour_index = scanline_layers.object_colour_indices[i];
+        const uint8_t object_flags = scanline_layers.object_flags[i];
+
+        const bool is_object_pixel_shown = object_layer_selection == ObjectLayerSelection::Always ||
+                                           (object_layer_selection == ObjectLayerSelection::ByPriority &&
+                                            object_colour_index != 0 &&
+                                            !((object_flags & PALETTE_PRIORITY_BIT_MASK) && background_colour_index != 0));
+        if (is_object_pixel_shown)
+        {
+            const uint8_t object_palette = (object_flags & PALETTE_NUMBER_BIT_MASK)
+                ? scanline_layers.object_palette_1
+                : scanline_layers.object_palette_0;
+            shades[i] = get_palette_shade(object_palette, object_colour_index);
+        }
+        else
+            shades[i] = get_palette_shade(scanline_layers.background_palette, background_colour_index);
+    }
+}
+
+void convert_shades_to_abgr_scalar(const uint8_t* shades, const uint32_t* abgr_colour_palette, uint32_t* abgr_pixels, size_t pixel_count)
+{
+    for (size_t i = 0; i < pixel_count; i++)
+    {
+        abgr_pixels[i] = abgr_colour_palette[shades[i]];
+    }
+}
+
+#ifdef PIXEL_KERNELS_X86_64
+
+__m128i select_bytes_sse2(__m128i selection_mask, __m128i bytes_if_selected, __m128i bytes_otherwise)
+{
+    return _mm_or_si128(_mm_and_si128(selection_mask, bytes_if_selected), _mm_andnot_si128(selection_mask, bytes_otherwise));
+}
+
+// Both copies of the row come out of one pass, the second half of the bit masks running from the least significant bit
+void decode_tile_row_sse2(uint8_t tile_row_low, uint8_t tile_row_high, uint8_t* decoded_tile_row_and_flipped)
+{
+    const __m128i bit_masks = _mm_setr_epi8(
+        static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80));
+    const __m128i low_bits = _mm_cmpeq_epi8(_mm_and_si128(_mm_set1_epi8(static_cast<char>(tile_row_low)), bit_masks), bit_masks);
+    const __m128i high_bits = _mm_cmpeq_epi8(_mm_and_si128(_mm_set1_epi8(static_cast<char>(tile_row_high)), bit_masks), bit_masks);
+    const __m128i colour_indices = _mm_or_si128(
+        _mm_and_si128(low_bits, _mm_set1_epi8(0b01)),
+        _mm_and_si128(high_bits, _mm_set1_epi8(0b10)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(decoded_tile_row_and_flipped), colour_indices);
+}
+
+// Without a byte shuffle the 2-bit field is picked by comparing the colour index against each value. The 16-bit shifts
+// carry bits in from the neighbouring byte, which the mask then clears
+__m128i get_palette_shades_sse2(__m128i palettes, __m128i colour_indices)
+{
+    const __m128i two_bit_mask = _mm_set1_epi8(0b11);
+    __m128i shades = _mm_and_si128(palettes, two_bit_mask);
+    shades = select_bytes_sse2(_mm_cmpeq_epi8(colour_indices, _mm_set1_epi8(1)), _mm_and_si128(_mm_srli_epi16(palettes, 2), two_bit_mask), shades);
+    shades = select_bytes_sse2(_mm_cmpeq_epi8(colour_indices, _mm_set1_epi8(2)), _mm_and_si128(_mm_srli_epi16(palettes, 4), two_bit_mask), shades);
+    shades = select_bytes_sse2(_mm_cmpeq_epi8(colour_indices, _mm_set1_epi8(3)), _mm_and_si128(_mm_srli_epi16(palettes, 6), two_bit_mask), shades);
+    return shades;
+}
+
+void compose_scanline_sse2(const ScanlineLayers& scanline_layers, uint8_t* shades, size_t pixel_count)
+{
+    constexpr size_t PIXELS_PER_VECTOR = 16;
+    const ObjectLayerSelection object_layer_selection = get_object_layer_selection(scanline_layers);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i all_bits_set = _mm_cmpeq_epi8(zero, zero);
+    const __m128i priority_bit_mask = _mm_set1_epi8(static_cast<char>(PALETTE_PRIORITY_BIT_MASK));
+    const __m128i palette_number_bit_mask = _mm_set1_epi8(PALETTE_NUMBER_BIT_MASK);
+    const __m128i background_palettes = _mm_set1_epi8(static_cast<char>(scanline_layers.background_palette));
+    const __m128i object_palettes_0 = _mm_set1_epi8(static_cast<char>(scanline_layers.object_palette_0));
+    const __m128i object_palettes_1 = _mm_set1_epi8(static_cast<char>(scanline_layers.object_palette_1));
+
+    size_t i = 0;
+    for (; i + PIXELS_PER_VECTOR <= pixel_count; i += PIXELS_PER_VECTOR)
+    {
+        const __m128i background_colour_indices = scanline_layers.are_background_and_window_enabled
+            ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(scanline_layers.background_colour_indices + i))
+            : zero;
+        const __m128i object_colour_indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(scanline_layers.object_colour_indices + i));
+        const __m128i object_flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(scanline_layers.object_flags + i));
+
+        __m128i is_object_pixel_shown = zero;
+        if (object_layer_selection == ObjectLayerSelection::Always)
+            is_object_pixel_shown = all_bits_set;
+        else if (object_layer_selection == ObjectLayerSelection::ByPriority)
+        {
+            const __m128i is_behind_background = _mm_andnot_si128(
+                _mm_cmpeq_epi8(background_colour_indices, zero),
+                _mm_cmpeq_epi8(_mm_and_si128(object_flags, priority_bit_mask), priority_bit_mask));
+            is_object_pixel_shown = _mm_andnot_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(object_colour_indices, zero), is_behind_background),
+                all_bits_set);
+        }
+        const __m128i is_object_palette_1 = _mm_cmpeq_epi8(_mm_and_si128(object_flags, palette_number_bit_mask), palette_number_bit_mask);
+
+        const __m128i palettes = select_bytes_sse2(
+            is_object_pixel_shown,
+            select_bytes_sse2(is_object_palette_1, object_palettes_1, object_palettes_0),
+            background_palettes);
+        const __m128i colour_indices = select_bytes_sse2(is_object_pixel_shown, object_colour_indices, background_colour_indices);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(shades + i), get_palette_shades_sse2(palettes, colour_indices));
+    }
+    compose_scanline_scalar(get_scanline_layers_from_pixel(scanline_layers, i), shades + i, pixel_count - i);
+}
+
+AVX2_TARGET __m256i select_bytes_avx2(__m256i selection_mask, __m256i bytes_if_selected, __m256i bytes_otherwise)
+{
+    return _mm256_blendv_epi8(bytes_otherwise, bytes_if_selected, selection_mask);
+}
+
+// The three palettes are spread into a 12-entry table of shades, so one byte shuffle applies whichever palette each pixel uses
+AVX2_TARGET void compose_scanline_avx2(const ScanlineLayers& scanline_layers, uint8_t* shades, size_t pixel_count)
+{
+    constexpr size_t PIXELS_PER_VECTOR = 32;
+    const ObjectLayerSelection object_layer_selection = get_object_layer_selection(scanline_layers);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i all_bits_set = _mm256_cmpeq_epi8(zero, zero);
+    const __m256i priority_bit_mask = _mm256_set1_epi8(static_cast<char>(PALETTE_PRIORITY_BIT_MASK));
+
+    alignas(16) uint8_t shade_table[16]{};
+    const uint8_t palettes[3] = {scanline_layers.background_palette, scanline_layers.object_palette_0, scanline_layers.object_palette_1};
+    for (uint8_t table_index = 0; table_index < 12; table_index++)
+    {
+        shade_table[table_index] = get_palette_shade(palettes[table_index / 4], table_index % 4);
+    }
+    const __m256i shade_lookup_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(shade_table)));
+
+    size_t i = 0;
+    for (; i + PIXELS_PER_VECTOR <= pixel_count; i += PIXELS_PER_VECTOR)
+    {
+        const __m256i background_colour_indices = scanline_layers.are_background_and_window_enabled
+            ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scanline_layers.background_colour_indices + i))
+            : zero;
+        const __m256i object_colour_indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scanline_layers.object_colour_indices + i));
+        const __m256i object_flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scanline_layers.object_flags + i));
+
+        __m256i is_object_pixel_shown = zero;
+        if (object_layer_selection == ObjectLayerSelection::Always)
+            is_object_pixel_shown = all_bits_set;
+        else if (object_layer_selection == ObjectLayerSelection::ByPriority)
+        {
+            const __m256i is_behind_background = _mm256_andnot_si256(
+                _mm256_cmpeq_epi8(background_colour_indices, zero),
+                _mm256_cmpeq_epi8(_mm256_and_si256(object_flags, priority_bit_mask), priority_bit_mask));
+            is_object_pixel_shown = _mm256_andnot_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(object_colour_indices, zero), is_behind_background),
+                all_bits_set);
+        }
+
+        // Object palette 0 starts at entry 4 and palette 1 at entry 8, and bit 4 of the flags shifted down is 4 when set
+        const __m256i object_table_indices = _mm256_add_epi8(
+            _mm256_add_epi8(object_colour_indices, _mm256_set1_epi8(4)),
+            _mm256_and_si256(_mm256_srli_epi16(object_flags, 2), _mm256_set1_epi8(4)));
+        const __m256i table_indices = select_bytes_avx2(is_object_pixel_shown, object_table_indices, background_colour_indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(shades + i), _mm256_shuffle_epi8(shade_lookup_table, table_indices));
+    }
+    compose_scanline_sse2(get_scanline_layers_from_pixel(scanline_layers, i), shades + i, pixel_count - i);
+}
+
+AVX2_TARGET void convert_shades_to_abgr_avx2(const uint8_t* shades, const uint32_t* abgr_colour_palette, uint32_t* abgr_pixels, size_t pixel_count)
+{
+    constexpr size_t PIXELS_PER_VECTOR = 8;
+    const __m256i abgr_colours = _mm256_setr_epi32(
+        static_cast<int>(abgr_colour_palette[0]), static_cast<int>(abgr_colour_palette[1]),
+        static_cast<int>(abgr_colour_palette[2]), static_cast<int>(abgr_colour_palette[3]),
+        static_cast<int>(abgr_colour_palette[0]), static_cast<int>(abgr_colour_palette[1]),
+        static_cast<int>(abgr_colour_palette[2]), static_cast<int>(abgr_colour_palette[3]));
+
+    size_t i = 0;
+    for (; i + PIXELS_PER_VECTOR <= pixel_count; i += PIXELS_PER_VECTOR)
+    {
+        const __m256i shade_indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(shades + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(abgr_pixels + i), _mm256_permutevar8x32_epi32(abgr_colours, shade_indices));
+    }
+    convert_shades_to_abgr_scalar(shades + i, abgr_colour_palette, abgr_pixels + i, pixel_count - i);
+}
+
+bool is_avx2_supported()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int cpu_info[4]{};
+    __cpuid(cpu_info, 1);
+    const bool are_avx_registers_saved_by_os = (cpu_info[2] & (1 << 27)) && (cpu_info[2] & (1 << 28)) &&
+                                               (_xgetbv(0) & 0b110) == 0b110;
+    if (!are_avx_registers_saved_by_os)
+        return false;
+    __cpuidex(cpu_info, 7, 0);
+    return (cpu_info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+constexpr PixelKernels SCALAR_PIXEL_KERNELS
+{
+    PixelKernelInstructionSet::Scalar,
+    decode_tile_row_scalar,
+    compose_scanline_scalar,
+    convert_shades_to_abgr_scalar
+};
+
+#ifdef PIXEL_KERNELS_X86_64
+// SSE2 has no gather, and picking each colour by comparison measured slower than the scalar table lookup
+constexpr PixelKernels SSE2_PIXEL_KERNELS
+{
+    PixelKernelInstructionSet::SSE2,
+    decode_tile_row_sse2,
+    compose_scanline_sse2,
+    convert_shades_to_abgr_scalar
+};
+
+// A tile row is only 16 bytes with its flipped copy, so decoding stays on SSE2
+constexpr PixelKernels AVX2_PIXEL_KERNELS
+{
+    PixelKernelInstructionSet::AVX2,
+    decode_tile_row_sse2,
+    compose_scanline_avx2,
+    convert_shades_to_abgr_avx2
+};
+#endif
+
+} // namespace
+
+bool is_pixel_kernel_instruction_set_supported(PixelKernelInstructionSet instruction_set)
+{
+    switch (instruction_set)
+    {
+#ifdef PIXEL_KERNELS_X86_64
+        case PixelKernelInstructionSet::SSE2:
+            return true;
+        case PixelKernelInstructionSet::AVX2:
+            return is_avx2_supported();
+#endif
+        case PixelKernelInstructionSet::Scalar:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const PixelKernels& get_pixel_kernels(PixelKernelInstructionSet instruction_set)
+{
+    if (!is_pixel_kernel_instruction_set_supported(instruction_set))
+        return SCALAR_PIXEL_KERNELS;
+
+    switch (instruction_set)
+    {
+#ifdef PIXEL_KERNELS_X86_64
+        case PixelKernelInstructionSet::SSE2:
+            return SSE2_PIXEL_KERNELS;
+        case PixelKernelInstructionSet::AVX2:
+            return AVX2_PIXEL_KERNELS;
+#endif
+        default:
+            return SCALAR_PIXEL_KERNELS;
+    }
+}
+
+const PixelKernels& get_pixel_kernels()
+{
+    static const PixelKernels& best_supported_pixel_kernels =
+        is_pixel_kernel_instruction_set_supported(PixelKernelInstructionSet::AVX2) ? get_pixel_kernels(PixelKernelInstructionSet::AVX2) :
+        is_pixel_kernel_instruction_set_supported(PixelKernelInstructionSet::SSE2) ? get_pixel_kernels(PixelKernelInstructionSet::SSE2) :
+        get_pixel_kernels(PixelKernelInstructionSet::Scalar);
+    return best_supported_pixel_kernels;
+}
+
+} // namespace GameBoyEmulator
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <memory>
 
@@ -22,19 +23,25 @@ void BackgroundPixelSliceFetcher::reset_state()
 {
     PixelSliceFetcher::reset_state();
     is_enabled = true;
-    tile_row.fill(BackgroundPixel{});
     fetcher_mode = FetcherMode::BackgroundMode;
     fetcher_x = 0;
 }
 
-PixelProcessingUnit::PixelProcessingUnit(std::function<void(uint8_t)> request_interrupt)
-    : request_interrupt_callback{request_interrupt}
+PixelProcessingUnit::PixelProcessingUnit(InterruptRegisters& interrupt_registers_reference, EventScheduler& event_scheduler_reference)
+    : interrupt_registers{interrupt_registers_reference},
+      event_scheduler{event_scheduler_reference},
+      pixel_kernels{get_pixel_kernels()}
 {
     video_ram = std::make_unique<uint8_t[]>(VIDEO_RAM_SIZE);
     std::fill_n(video_ram.get(), VIDEO_RAM_SIZE, 0);
 
+    // Each tile row is kept as 8 colour indices, followed by the same row flipped horizontally
+    decoded_tile_rows = std::make_unique<uint8_t[]>(TILE_DATA_SIZE * PIXELS_PER_TILE_ROW);
+    std::fill_n(decoded_tile_rows.get(), TILE_DATA_SIZE * PIXELS_PER_TILE_ROW, 0);
+
     object_attribute_memory = std::make_unique<uint8_t[]>(OBJECT_ATTRIBUTE_MEMORY_SIZE);
     std::fill_n(object_attribute_memory.get(), OBJECT_ATTRIBUTE_MEMORY_SIZE, 0);
+    reset_object_attribute_memory_index();
 
     pixel_frame_buffers[0] = std::make_unique<uint8_t[]>(static_cast<uint16_t>(DISPLAY_WIDTH_PIXELS * DISPLAY_HEIGHT_PIXELS));
     pixel_frame_buffers[1] = std::make_unique<uint8_t[]>(static_cast<uint16_t>(DISPLAY_WIDTH_PIXELS * DISPLAY_HEIGHT_PIXELS));
@@ -45,7 +52,9 @@ PixelProcessingUnit::PixelProcessingUnit(std::function<void(uint8_t)> request_in
 void PixelProcessingUnit::reset_state()
 {
     std::fill_n(video_ram.get(), VIDEO_RAM_SIZE, 0);
+    std::fill_n(decoded_tile_rows.get(), TILE_DATA_SIZE * PIXELS_PER_TILE_ROW, 0);
     std::fill_n(object_attribute_memory.get(), OBJECT_ATTRIBUTE_MEMORY_SIZE, 0);
+    reset_object_attribute_memory_index();
 
     std::fill_n(pixel_frame_buffers[in_progress_frame_index].get(), static_cast<uint16_t>(DISPLAY_WIDTH_PIXELS * DISPLAY_HEIGHT_PIXELS), 0);
     publish_new_frame();
@@ -71,7 +80,6 @@ void PixelProcessingUnit::reset_state()
     current_mode = PixelProcessingUnitMode::HorizontalBlank;
     current_scanline_dot_number = 0;
     is_in_first_scanline_after_lcd_enable = false;
-    is_in_first_dot_of_current_step = true;
     is_window_enabled_for_scanline = false;
 
     stat_value_after_spurious_interrupt = 0;
@@ -79,7 +87,8 @@ void PixelProcessingUnit::reset_state()
     are_stat_interrupts_blocked = false;
     did_scan_line_end_during_this_machine_cycle = false;
 
-    scanline_selected_objects.clear();
+    scanline_selected_object_count = 0;
+    scanline_scanned_object_count = 0;
     current_object_index = 0;
 
     scanline_pixels_to_discard_from_dummy_fetch_count = 8;
@@ -90,6 +99,15 @@ void PixelProcessingUnit::reset_state()
 
     background_pixel_shift_register.clear();
     object_pixel_shift_register.clear();
+
+    is_scanline_rendered_ahead = false;
+    pixel_transfer_end_dot_number = 0;
+
+    consecutive_skipped_frame_count = 0;
+    is_frame_output_skipped = false;
+
+    synchronized_machine_cycle = event_scheduler.get_current_machine_cycle();
+    schedule_next_synchronization();
 }
 
 void PixelProcessingUnit::set_post_boot_state()
@@ -104,6 +122,56 @@ void PixelProcessingUnit::set_post_boot_state()
     lcd_status_stat = 0x85;
     object_attribute_memory_direct_memory_access_dma = 0xFF;
     background_palette_bgp = 0xFC;
+    schedule_next_synchronization();
+}
+
+// Only 1 in every interval frames is drawn, the others keep exact timing but leave the frame buffers untouched
+void PixelProcessingUnit::set_frame_skip_interval(uint8_t new_frame_skip_interval)
+{
+    frame_skip_interval = std::max<uint8_t>(new_frame_skip_interval, 1);
+}
+
+// With rendering ahead disabled every scanline goes through the pixel FIFO, which is the reference the render-ahead path must match
+void PixelProcessingUnit::set_scanline_render_ahead_enabled(bool is_enabled)
+{
+    is_scanline_render_ahead_enabled = is_enabled;
+}
+
+// Writing a register the pixel transfer reads makes a scanline rendered ahead fall back to the pixel FIFO first
+template <uint8_t PixelProcessingUnit::*rendering_register>
+void PixelProcessingUnit::register_rendering_register(InputOutputRegisterMap& input_output_register_map, uint16_t address)
+{
+    input_output_register_map.register_handlers(
+        address,
+        this,
+        [](void* context) { return static_cast<PixelProcessingUnit*>(context)->*rendering_register; },
+        [](void* context, uint8_t value)
+        {
+            PixelProcessingUnit& pixel_processing_unit = *static_cast<PixelProcessingUnit*>(context);
+            if (pixel_processing_unit.*rendering_register != value)
+            {
+                pixel_processing_unit.fall_back_to_pixel_fifo_for_scanline();
+                pixel_processing_unit.*rendering_register = value;
+            }
+        });
+}
+
+// OAM DMA is started by the memory management unit, so it registers 0xFF46 itself
+void PixelProcessingUnit::register_input_output_registers(InputOutputRegisterMap& input_output_register_map)
+{
+    input_output_register_map.register_member_functions<
+        PixelProcessingUnit, &PixelProcessingUnit::read_lcd_control_lcdc, &PixelProcessingUnit::write_lcd_control_lcdc>(0xFF40, *this);
+    input_output_register_map.register_member_functions<
+        PixelProcessingUnit, &PixelProcessingUnit::read_lcd_status_stat, &PixelProcessingUnit::write_lcd_status_stat>(0xFF41, *this);
+    register_rendering_register<&PixelProcessingUnit::viewport_y_position_scy>(input_output_register_map, 0xFF42);
+    register_rendering_register<&PixelProcessingUnit::viewport_x_position_scx>(input_output_register_map, 0xFF43);
+    input_output_register_map.register_read_only_member_function<PixelProcessingUnit, &PixelProcessingUnit::read_lcd_y_coordinate_ly>(0xFF44, *this);
+    input_output_register_map.register_storage(0xFF45, lcd_y_coordinate_compare_lyc);
+    register_rendering_register<&PixelProcessingUnit::background_palette_bgp>(input_output_register_map, 0xFF47);
+    register_rendering_register<&PixelProcessingUnit::object_palette_0_obp0>(input_output_register_map, 0xFF48);
+    register_rendering_register<&PixelProcessingUnit::object_palette_1_obp1>(input_output_register_map, 0xFF49);
+    input_output_register_map.register_storage(0xFF4A, window_y_position_wy);
+    register_rendering_register<&PixelProcessingUnit::window_x_position_plus_7_wx>(input_output_register_map, 0xFF4B);
 }
 
 uint8_t PixelProcessingUnit::get_published_frame_buffer_index_thread_safe() const
@@ -111,6 +179,11 @@ uint8_t PixelProcessingUnit::get_published_frame_buffer_index_thread_safe() cons
     return published_frame_index_atomic.load(std::memory_order_acquire);
 }
 
+uint64_t PixelProcessingUnit::get_published_frame_count() const
+{
+    return published_frame_count;
+}
+
 std::unique_ptr<uint8_t[]>& PixelProcessingUnit::get_pixel_frame_buffer(uint8_t index)
 {
     return pixel_frame_buffers[index];
@@ -123,6 +196,11 @@ uint8_t PixelProcessingUnit::read_lcd_control_lcdc() const
 
 void PixelProcessingUnit::write_lcd_control_lcdc(uint8_t value)
 {
+    if (value != lcd_control_lcdc)
+        fall_back_to_pixel_fifo_for_scanline();
+    if (is_bit_set(value, 2) != is_bit_set(lcd_control_lcdc, 2))
+        catch_up_object_attribute_memory_scan();
+
     const bool was_lcd_enable_bit_previously_set = is_bit_set(lcd_control_lcdc, 7);
     const bool will_lcd_enable_bit_be_set = is_bit_set(value, 7);
 
@@ -130,7 +208,6 @@ void PixelProcessingUnit::write_lcd_control_lcdc(uint8_t value)
     {
         is_in_frame_after_lcd_enable = true;
         is_in_first_scanline_after_lcd_enable = true;
-        is_in_first_dot_of_current_step = true;
         current_scanline_dot_number = 0;
     }
     else if (!will_lcd_enable_bit_be_set && was_lcd_enable_bit_previously_set)
@@ -194,7 +271,13 @@ void PixelProcessingUnit::write_byte_video_ram(uint16_t memory_address, uint8_t
             return;
     }
     const uint16_t local_address = memory_address - VIDEO_RAM_START;
+    if (video_ram[local_address] == value)
+        return;
+
+    fall_back_to_pixel_fifo_for_scanline();
     video_ram[local_address] = value;
+    if (local_address < TILE_DATA_SIZE)
+        decode_tile_row(local_address);
 }
 
 uint8_t PixelProcessingUnit::read_byte_object_attribute_memory(uint16_t memory_address, bool is_access_unrestricted) const
@@ -234,7 +317,114 @@ void PixelProcessingUnit::write_byte_object_attribute_memory(uint16_t memory_add
         }
     }
     const uint16_t local_address = memory_address - OBJECT_ATTRIBUTE_MEMORY_START;
+    const uint8_t previous_value = object_attribute_memory[local_address];
+    if (previous_value == value)
+        return;
+
+    fall_back_to_pixel_fifo_for_scanline();
+    catch_up_object_attribute_memory_scan();
     object_attribute_memory[local_address] = value;
+
+    const uint8_t object_index = static_cast<uint8_t>(local_address / BYTES_PER_OBJECT);
+    switch (local_address % BYTES_PER_OBJECT)
+    {
+        case 0:
+            update_object_scanline_masks(object_index, previous_value, false);
+            update_object_scanline_masks(object_index, value, true);
+            break;
+        case 1:
+            update_object_x_priority(object_index);
+            break;
+    }
+}
+
+// Replays every machine cycle the CPU has run ahead by, so the dots stepped are identical to stepping in lockstep
+void PixelProcessingUnit::catch_up_to_machine_cycle(uint64_t machine_cycle)
+{
+    while (synchronized_machine_cycle < machine_cycle)
+    {
+        step_single_machine_cycle();
+        synchronized_machine_cycle++;
+    }
+    schedule_next_synchronization();
+}
+
+// Register writes can raise the STAT interrupt line on the very next machine cycle
+void PixelProcessingUnit::schedule_synchronization_on_next_machine_cycle()
+{
+    event_scheduler.schedule_event(ScheduledEventType::PixelProcessingUnitSynchronization, 1);
+}
+
+// Nothing the pixel transfer reads has changed since the scanline was rendered ahead, so replaying the dots stepped so far
+// through the pixel FIFO reproduces its state exactly, and the rest of the scanline then sees the change at the right dot
+void PixelProcessingUnit::fall_back_to_pixel_fifo_for_scanline()
+{
+    if (!is_scanline_rendered_ahead)
+        return;
+
+    is_scanline_rendered_ahead = false;
+    const uint16_t dot_number_reached = current_scanline_dot_number;
+    reset_pixel_transfer_state();
+    current_object_index = 0;
+    for (uint16_t dot_number = OBJECT_ATTRIBUTE_MEMORY_SCAN_DURATION_DOTS + 1; dot_number <= dot_number_reached; dot_number++)
+    {
+        current_scanline_dot_number = dot_number;
+        step_pixel_transfer_single_dot();
+    }
+}
+
+void PixelProcessingUnit::schedule_next_synchronization()
+{
+    const uint32_t machine_cycles_until_next_state_change = get_machine_cycles_until_next_state_change();
+    if (machine_cycles_until_next_state_change == 0)
+        event_scheduler.cancel_event(ScheduledEventType::PixelProcessingUnitSynchronization);
+    else
+        event_scheduler.schedule_event_at_machine_cycle(
+            ScheduledEventType::PixelProcessingUnitSynchronization,
+            synchronized_machine_cycle + machine_cycles_until_next_state_change);
+}
+
+// Interrupts are only requested and frames only published on a mode or scanline change, or on the machine cycle right after one.
+// Returns a lower bound on the machine cycles until the machine cycle containing the next such change, or 0 while the LCD is off
+uint32_t PixelProcessingUnit::get_machine_cycles_until_next_state_change() const
+{
+    if (!is_bit_set(lcd_control_lcdc, 7))
+        return 0;
+
+    const bool did_state_change_during_previous_machine_cycle = previous_mode != current_mode ||
+                                                                should_previous_mode_update_early_for_stat_reads ||
+                                                                did_scan_line_end_during_this_machine_cycle ||
+                                                                did_spurious_stat_interrupt_occur;
+    if (did_state_change_during_previous_machine_cycle)
+        return 1;
+
+    int32_t dots_until_next_state_change = 0;
+    switch (current_mode)
+    {
+        case PixelProcessingUnitMode::ObjectAttributeMemoryScan:
+            dots_until_next_state_change = OBJECT_ATTRIBUTE_MEMORY_SCAN_DURATION_DOTS - current_scanline_dot_number;
+            break;
+        case PixelProcessingUnitMode::PixelTransfer:
+            // At most one pixel is shifted out per dot
+            dots_until_next_state_change = is_scanline_rendered_ahead
+                ? pixel_transfer_end_dot_number - current_scanline_dot_number
+                : DISPLAY_WIDTH_PIXELS + PIXELS_PER_TILE_ROW - internal_lcd_x_coordinate_plus_8_lx;
+            break;
+        case PixelProcessingUnitMode::HorizontalBlank:
+            if (!is_in_first_scanline_after_lcd_enable)
+                dots_until_next_state_change = SCANLINE_DURATION_DOTS - current_scanline_dot_number;
+            else if (current_scanline_dot_number < FIRST_HORIZONTAL_BLANK_AFTER_LCD_ENABLE_DURATION_DOTS)
+                dots_until_next_state_change = FIRST_HORIZONTAL_BLANK_AFTER_LCD_ENABLE_DURATION_DOTS - current_scanline_dot_number;
+            else
+                dots_until_next_state_change = FIRST_SCANLINE_AFTER_LCD_ENABLE_DURATION_DOTS - current_scanline_dot_number;
+            break;
+        case PixelProcessingUnitMode::VerticalBlank:
+            dots_until_next_state_change = (lcd_y_coordinate_ly == FINAL_SCANLINE_OF_FRAME && current_scanline_dot_number < FINAL_SCANLINE_EARLY_LY_RESET_DOT_NUMBER)
+                ? FINAL_SCANLINE_EARLY_LY_RESET_DOT_NUMBER - current_scanline_dot_number
+                : SCANLINE_DURATION_DOTS - current_scanline_dot_number;
+            break;
+    }
+    return static_cast<uint32_t>(std::max(1, (dots_until_next_state_change + DOTS_PER_MACHINE_CYCLE - 1) / DOTS_PER_MACHINE_CYCLE));
 }
 
 void PixelProcessingUnit::step_single_machine_cycle()
@@ -246,6 +436,7 @@ void PixelProcessingUnit::step_single_machine_cycle()
         return;
 
     should_previous_mode_update_early_for_stat_reads = false;
+    did_scan_line_end_during_this_machine_cycle = false;
 
     for (uint8_t i = 0; i < DOTS_PER_MACHINE_CYCLE; i++)
     {
@@ -287,47 +478,162 @@ void PixelProcessingUnit::step_single_machine_cycle()
 
 void PixelProcessingUnit::step_object_attribute_memory_scan_single_dot()
 {
-    if (is_in_first_dot_of_current_step)
+    if (current_scanline_dot_number == OBJECT_ATTRIBUTE_MEMORY_SCAN_DURATION_DOTS)
     {
-        is_in_first_dot_of_current_step = false;
-        return;
+        select_scanline_objects();
+        switch_to_mode(PixelProcessingUnitMode::PixelTransfer);
     }
+}
 
-    if (scanline_selected_objects.size() < MAX_OBJECTS_PER_LINE)
+// The scan reads one object every 2 dots, but nothing it reads can change unless OAM, the object size or the OAM DMA state
+// does, so objects are selected from the scanline masks when the scan ends and in the precomputed X priority order
+void PixelProcessingUnit::select_scanline_objects()
+{
+    if (scanline_scanned_object_count == 0)
     {
-        const uint16_t object_start_global_address = OBJECT_ATTRIBUTE_MEMORY_START + (2 * current_scanline_dot_number) - 4;
-        const bool is_access_unrestricted = true;
-        ObjectAttributes current_object
+        uint64_t candidate_object_mask = get_scanline_object_candidate_mask();
+        uint64_t selected_object_x_priority_rank_mask = 0;
+        for (uint8_t i = 0; i < MAX_OBJECTS_PER_LINE && candidate_object_mask != 0; i++)
+        {
+            selected_object_x_priority_rank_mask |= uint64_t{1} << object_x_priority_ranks[std::countr_zero(candidate_object_mask)];
+            candidate_object_mask &= candidate_object_mask - 1;
+        }
+        while (selected_object_x_priority_rank_mask != 0)
         {
-            object_start_global_address,
-            read_byte_object_attribute_memory(object_start_global_address, is_access_unrestricted),
-            read_byte_object_attribute_memory(object_start_global_address + 1, is_access_unrestricted),
-            read_byte_object_attribute_memory(object_start_global_address + 2, is_access_unrestricted),
-            read_byte_object_attribute_memory(object_start_global_address + 3, is_access_unrestricted),
-        };
-
-        const uint8_t object_height = is_bit_set(lcd_control_lcdc, 2) ? 16 : 8;
-        const int16_t object_lowest_lcd_y_coordinate = current_object.y_position - 16;
-        const bool does_object_intersect_with_scanline = lcd_y_coordinate_ly >= object_lowest_lcd_y_coordinate &&
-                                                         lcd_y_coordinate_ly < object_lowest_lcd_y_coordinate + object_height;
-        if (does_object_intersect_with_scanline)
-            scanline_selected_objects.push_back(current_object);
+            const uint8_t object_index = object_indices_by_x_priority[std::countr_zero(selected_object_x_priority_rank_mask)];
+            scanline_selected_objects[scanline_selected_object_count++] = get_object_attributes(object_index);
+            selected_object_x_priority_rank_mask &= selected_object_x_priority_rank_mask - 1;
+        }
+        return;
     }
-    is_in_first_dot_of_current_step = true;
 
-    if (current_scanline_dot_number == OBJECT_ATTRIBUTE_MEMORY_SCAN_DURATION_DOTS)
+    // Objects selected before a change during the scan keep the X position they were read with, so they are ordered here
+    catch_up_object_attribute_memory_scan();
+    for (uint8_t i = 1; i < scanline_selected_object_count; i++)
     {
-        std::stable_sort(scanline_selected_objects.begin(), scanline_selected_objects.end(), 
+        const auto insertion_position = std::upper_bound(scanline_selected_objects.begin(), scanline_selected_objects.begin() + i, scanline_selected_objects[i],
             [](const ObjectAttributes& a, const ObjectAttributes& b)
             {
-                return a.x_position < b.x_position; 
+                return a.x_position < b.x_position;
             });
-        switch_to_mode(PixelProcessingUnitMode::PixelTransfer);
+        std::rotate(insertion_position, scanline_selected_objects.begin() + i, scanline_selected_objects.begin() + i + 1);
+    }
+}
+
+// Selects from the objects the scan has read so far, before a change could alter what the scan would have read
+void PixelProcessingUnit::catch_up_object_attribute_memory_scan()
+{
+    if (!is_bit_set(lcd_control_lcdc, 7) || current_mode != PixelProcessingUnitMode::ObjectAttributeMemoryScan)
+        return;
+
+    const uint8_t scanned_object_count = static_cast<uint8_t>(current_scanline_dot_number / 2);
+    uint64_t candidate_object_mask = get_scanline_object_candidate_mask() &
+                                     ((uint64_t{1} << scanned_object_count) - 1) &
+                                     ~((uint64_t{1} << scanline_scanned_object_count) - 1);
+    while (candidate_object_mask != 0 && scanline_selected_object_count < MAX_OBJECTS_PER_LINE)
+    {
+        scanline_selected_objects[scanline_selected_object_count++] = get_object_attributes(static_cast<uint8_t>(std::countr_zero(candidate_object_mask)));
+        candidate_object_mask &= candidate_object_mask - 1;
+    }
+    scanline_scanned_object_count = scanned_object_count;
+}
+
+// OAM reads as 0xFF during OAM DMA, which puts every object below the last scanline
+uint64_t PixelProcessingUnit::get_scanline_object_candidate_mask() const
+{
+    if (is_oam_dma_in_progress)
+        return 0;
+
+    const bool is_object_double_height = is_bit_set(lcd_control_lcdc, 2);
+    return scanline_top_tile_object_masks[lcd_y_coordinate_ly] |
+           (is_object_double_height ? scanline_bottom_tile_object_masks[lcd_y_coordinate_ly] : 0);
+}
+
+ObjectAttributes PixelProcessingUnit::get_object_attributes(uint8_t object_index) const
+{
+    const uint16_t local_address = object_index * BYTES_PER_OBJECT;
+    return ObjectAttributes
+    {
+        static_cast<uint16_t>(OBJECT_ATTRIBUTE_MEMORY_START + local_address),
+        object_attribute_memory[local_address],
+        object_attribute_memory[local_address + 1],
+        object_attribute_memory[local_address + 2],
+        object_attribute_memory[local_address + 3]
+    };
+}
+
+// Every object starts at Y 0, above the first scanline, and at X 0, so OAM order is the X priority order
+void PixelProcessingUnit::reset_object_attribute_memory_index()
+{
+    scanline_top_tile_object_masks.fill(0);
+    scanline_bottom_tile_object_masks.fill(0);
+    for (uint8_t object_index = 0; object_index < NUMBER_OF_OBJECTS; object_index++)
+    {
+        object_indices_by_x_priority[object_index] = object_index;
+        object_x_priority_ranks[object_index] = object_index;
     }
 }
 
+void PixelProcessingUnit::update_object_scanline_masks(uint8_t object_index, uint8_t y_position, bool does_object_cover_scanlines)
+{
+    constexpr uint8_t DOUBLE_HEIGHT_OBJECT_ROWS = 2 * PIXELS_PER_TILE_ROW;
+    const uint64_t object_bit = uint64_t{1} << object_index;
+
+    for (uint8_t object_row = 0; object_row < DOUBLE_HEIGHT_OBJECT_ROWS; object_row++)
+    {
+        const int16_t scanline = y_position - DOUBLE_HEIGHT_OBJECT_ROWS + object_row;
+        if (scanline < 0 || scanline >= DISPLAY_HEIGHT_PIXELS)
+            continue;
+
+        uint64_t& scanline_object_mask = (object_row < PIXELS_PER_TILE_ROW)
+            ? scanline_top_tile_object_masks[scanline]
+            : scanline_bottom_tile_object_masks[scanline];
+        scanline_object_mask = does_object_cover_scanlines
+            ? scanline_object_mask | object_bit
+            : scanline_object_mask & ~object_bit;
+    }
+}
+
+// Moves the object to its new place in X priority order, where equal X positions keep OAM order
+void PixelProcessingUnit::update_object_x_priority(uint8_t object_index)
+{
+    const auto has_priority_over = [this](uint8_t a, uint8_t b)
+    {
+        const uint8_t a_x_position = object_attribute_memory[a * BYTES_PER_OBJECT + 1];
+        const uint8_t b_x_position = object_attribute_memory[b * BYTES_PER_OBJECT + 1];
+        return a_x_position < b_x_position || (a_x_position == b_x_position && a < b);
+    };
+
+    uint8_t rank = object_x_priority_ranks[object_index];
+    while (rank > 0 && has_priority_over(object_index, object_indices_by_x_priority[rank - 1]))
+    {
+        object_indices_by_x_priority[rank] = object_indices_by_x_priority[rank - 1];
+        object_x_priority_ranks[object_indices_by_x_priority[rank]] = rank;
+        rank--;
+    }
+    while (rank < NUMBER_OF_OBJECTS - 1 && has_priority_over(object_indices_by_x_priority[rank + 1], object_index))
+    {
+        object_indices_by_x_priority[rank] = object_indices_by_x_priority[rank + 1];
+        object_x_priority_ranks[object_indices_by_x_priority[rank]] = rank;
+        rank++;
+    }
+    object_indices_by_x_priority[rank] = object_index;
+    object_x_priority_ranks[object_index] = rank;
+}
+
 void PixelProcessingUnit::step_pixel_transfer_single_dot()
 {
+    if (is_scanline_rendered_ahead)
+    {
+        if (current_scanline_dot_number == pixel_transfer_end_dot_number)
+        {
+            is_scanline_rendered_ahead = false;
+            internal_lcd_x_coordinate_plus_8_lx = DISPLAY_WIDTH_PIXELS + PIXELS_PER_TILE_ROW;
+            switch_to_mode(PixelProcessingUnitMode::HorizontalBlank);
+        }
+        return;
+    }
+
     const uint8_t dot_number_for_dummy_push = (is_in_first_scanline_after_lcd_enable
         ? FIRST_HORIZONTAL_BLANK_AFTER_LCD_ENABLE_DURATION_DOTS
         : OBJECT_ATTRIBUTE_MEMORY_SCAN_DURATION_DOTS) + 5;
@@ -338,8 +644,7 @@ void PixelProcessingUnit::step_pixel_transfer_single_dot()
     }
     else if (current_scanline_dot_number == dot_number_for_dummy_push)
     {
-        const auto& tile_row_to_discard = background_fetcher.tile_row;
-        background_pixel_shift_register.load_new_tile_row(tile_row_to_discard);
+        background_pixel_shift_register.load_new_tile_row(background_fetcher.tile_row_low, background_fetcher.tile_row_high);
     }
 
     if (background_fetcher.is_enabled &&
@@ -363,7 +668,7 @@ void PixelProcessingUnit::step_pixel_transfer_single_dot()
     const bool should_draw_or_discard_pixels = !object_fetcher.is_enabled && !background_pixel_shift_register.is_empty();
     if (should_draw_or_discard_pixels)
     {
-        const BackgroundPixel next_background_pixel = background_pixel_shift_register.shift_out();
+        const uint8_t next_background_pixel_colour_index = background_pixel_shift_register.shift_out();
         const ObjectPixel next_object_pixel = object_pixel_shift_register.shift_out();
 
         if (scanline_pixels_to_discard_from_scrolling_count == -1)
@@ -384,31 +689,11 @@ void PixelProcessingUnit::step_pixel_transfer_single_dot()
             return;
         }
 
-        const bool are_background_and_window_enabled = is_bit_set(lcd_control_lcdc, 0);
-        uint8_t pixel_with_palette_applied = 0x00;
-
-        if (scanline_selected_objects.size() == 0 ||
-            (are_background_and_window_enabled &&
-             (!is_object_display_enabled() ||
-              (next_object_pixel.is_priority_bit_set && next_background_pixel.colour_index != 0) ||
-              next_object_pixel.colour_index == 0)))
-        {
-            const uint8_t colour_index = are_background_and_window_enabled
-                ? next_background_pixel.colour_index
-                : 0b00;
-            const uint8_t palette_colour_position = colour_index << 1;
-            pixel_with_palette_applied = (background_palette_bgp & (0b11 << palette_colour_position)) >> palette_colour_position;
-        }
-        else
+        if (!is_frame_output_skipped)
         {
-            const uint8_t palette_colour_position = next_object_pixel.colour_index << 1;
-            const uint8_t palette = next_object_pixel.is_palette_bit_set
-                ? object_palette_1_obp1
-                : object_palette_0_obp0;
-            pixel_with_palette_applied = (palette & (0b11 << palette_colour_position)) >> palette_colour_position;
+            const uint16_t pixel_address = static_cast<uint16_t>(DISPLAY_WIDTH_PIXELS * lcd_y_coordinate_ly) + (internal_lcd_x_coordinate_plus_8_lx - 8);
+            pixel_frame_buffers[in_progress_frame_index][pixel_address] = get_pixel_with_palette_applied(next_background_pixel_colour_index, next_object_pixel);
         }
-        const uint16_t pixel_address = static_cast<uint16_t>(DISPLAY_WIDTH_PIXELS * lcd_y_coordinate_ly) + (internal_lcd_x_coordinate_plus_8_lx - 8);
-        pixel_frame_buffers[in_progress_frame_index][pixel_address] = pixel_with_palette_applied;
 
         background_fetcher.fetcher_x++;
         if (++internal_lcd_x_coordinate_plus_8_lx == 168)
@@ -418,6 +703,154 @@ void PixelProcessingUnit::step_pixel_transfer_single_dot()
     }
 }
 
+// Draws the whole scanline when pixel transfer starts and works out the dot it ends on, which holds as long as nothing the
+// pixel transfer reads changes before that dot. Objects fetched after the window starts are left to the pixel FIFO
+bool PixelProcessingUnit::try_render_scanline_ahead()
+{
+    if (is_in_first_scanline_after_lcd_enable || is_oam_dma_in_progress)
+        return false;
+
+    constexpr uint8_t LCD_X_COORDINATE_PLUS_8_AT_END = DISPLAY_WIDTH_PIXELS + PIXELS_PER_TILE_ROW;
+    constexpr uint8_t OBJECT_FETCH_DURATION_DOTS = 6;
+    constexpr uint8_t BACKGROUND_FETCH_PUSH_READY_DOT = 5;
+
+    const uint8_t scroll_discard_count = viewport_x_position_scx % 8;
+    const bool will_window_start = is_window_enabled_for_scanline && was_wy_condition_triggered_this_frame &&
+                                   window_x_position_plus_7_wx + 1 < LCD_X_COORDINATE_PLUS_8_AT_END;
+    const bool will_objects_be_fetched = is_object_display_enabled();
+
+    if (will_window_start && will_objects_be_fetched &&
+        std::any_of(scanline_selected_objects.begin(), scanline_selected_objects.begin() + scanline_selected_object_count,
+            [this](const ObjectAttributes& object)
+            {
+                return object.x_position > window_x_position_plus_7_wx && object.x_position < LCD_X_COORDINATE_PLUS_8_AT_END;
+            }))
+    {
+        return false;
+    }
+
+    // The dummy push comes 5 dots in, then one pixel is shifted out per dot for the scrolled, dummy and visible pixels
+    uint16_t end_dot_number = OBJECT_ATTRIBUTE_MEMORY_SCAN_DURATION_DOTS + 5 + scroll_discard_count + LCD_X_COORDINATE_PLUS_8_AT_END - 1;
+    if (will_window_start)
+        end_dot_number += OBJECT_FETCH_DURATION_DOTS;
+
+    // Object pixels are indexed by how many pixels were shifted out before them, scrolled and dummy pixels included
+    std::array<uint8_t, LCD_X_COORDINATE_PLUS_8_AT_END + 2 * PIXELS_PER_TILE_ROW> object_colour_indices{};
+    std::array<uint8_t, LCD_X_COORDINATE_PLUS_8_AT_END + 2 * PIXELS_PER_TILE_ROW> object_flags{};
+    if (will_objects_be_fetched)
+    {
+        int16_t previous_object_tile_slice = -1;
+        for (current_object_index = 0; current_object_index < scanline_selected_object_count; current_object_index++)
+        {
+            const uint16_t object_x_position = get_current_object().x_position;
+            if (object_x_position >= LCD_X_COORDINATE_PLUS_8_AT_END)
+                break;
+
+            // The first object in a tile slice waits for the background fetcher to finish its tile, later ones find it waiting to push
+            const uint8_t shifted_pixel_count = (object_x_position == 0) ? 0 : object_x_position + scroll_discard_count;
+            const int16_t object_tile_slice = shifted_pixel_count / PIXELS_PER_TILE_ROW;
+            end_dot_number += OBJECT_FETCH_DURATION_DOTS;
+            if (object_tile_slice != previous_object_tile_slice)
+                end_dot_number += std::max(0, BACKGROUND_FETCH_PUSH_READY_DOT - shifted_pixel_count % PIXELS_PER_TILE_ROW);
+            previous_object_tile_slice = object_tile_slice;
+
+            if (is_frame_output_skipped)
+                continue;
+
+            fetch_current_object_tile_index_and_flags();
+            const uint8_t current_object_flags = get_current_object().flags;
+            const uint8_t* const decoded_tile_row = get_decoded_tile_row(
+                get_object_tile_row_local_address(get_current_object()),
+                is_bit_set(current_object_flags, 5));
+            for (uint8_t i = 0; i < PIXELS_PER_TILE_ROW; i++)
+            {
+                if (object_colour_indices[shifted_pixel_count + i] == 0)
+                {
+                    object_colour_indices[shifted_pixel_count + i] = decoded_tile_row[i];
+                    object_flags[shifted_pixel_count + i] = current_object_flags;
+                }
+            }
+        }
+        current_object_index = 0;
+    }
+
+    if (will_window_start)
+        background_fetcher.fetcher_mode = FetcherMode::WindowMode;
+    pixel_transfer_end_dot_number = end_dot_number;
+    if (is_frame_output_skipped)
+        return true;
+
+    const int16_t window_start_x = will_window_start ? window_x_position_plus_7_wx - 7 : DISPLAY_WIDTH_PIXELS;
+    const uint8_t background_y = lcd_y_coordinate_ly + viewport_y_position_scy;
+    std::array<uint8_t, DISPLAY_WIDTH_PIXELS> background_colour_indices;
+
+    // Copies up to the end of each tile, or up to where the window starts
+    for (uint8_t x = 0; x < DISPLAY_WIDTH_PIXELS;)
+    {
+        const bool is_window_pixel = x >= window_start_x;
+        const uint8_t source_x = is_window_pixel
+            ? static_cast<uint8_t>(x - window_start_x)
+            : static_cast<uint8_t>(viewport_x_position_scx + x);
+        const uint8_t tile_pixel_x = source_x % PIXELS_PER_TILE_ROW;
+
+        int16_t pixels_to_copy = std::min<int16_t>(PIXELS_PER_TILE_ROW - tile_pixel_x, DISPLAY_WIDTH_PIXELS - x);
+        if (!is_window_pixel)
+            pixels_to_copy = std::min<int16_t>(pixels_to_copy, window_start_x - x);
+
+        const uint8_t tile_id = is_window_pixel
+            ? get_tile_id(is_bit_set(lcd_control_lcdc, 6), source_x / PIXELS_PER_TILE_ROW, internal_window_line_counter_wlc / PIXELS_PER_TILE_ROW)
+            : get_tile_id(is_bit_set(lcd_control_lcdc, 3), source_x / PIXELS_PER_TILE_ROW, background_y / PIXELS_PER_TILE_ROW);
+        const uint16_t tile_row_local_address = get_background_tile_row_local_address(tile_id, is_window_pixel
+            ? internal_window_line_counter_wlc
+            : background_y);
+        std::copy_n(get_decoded_tile_row(tile_row_local_address, false) + tile_pixel_x, pixels_to_copy, &background_colour_indices[x]);
+        x += static_cast<uint8_t>(pixels_to_copy);
+    }
+
+    const uint8_t first_visible_object_pixel_index = PIXELS_PER_TILE_ROW + scroll_discard_count;
+    const ScanlineLayers scanline_layers
+    {
+        background_colour_indices.data(),
+        &object_colour_indices[first_visible_object_pixel_index],
+        &object_flags[first_visible_object_pixel_index],
+        background_palette_bgp,
+        object_palette_0_obp0,
+        object_palette_1_obp1,
+        is_bit_set(lcd_control_lcdc, 0),
+        is_object_display_enabled(),
+        scanline_selected_object_count != 0
+    };
+    pixel_kernels.compose_scanline(
+        scanline_layers,
+        pixel_frame_buffers[in_progress_frame_index].get() + DISPLAY_WIDTH_PIXELS * lcd_y_coordinate_ly,
+        DISPLAY_WIDTH_PIXELS);
+    return true;
+}
+
+uint8_t PixelProcessingUnit::get_pixel_with_palette_applied(uint8_t background_pixel_colour_index, const ObjectPixel& object_pixel) const
+{
+    const bool are_background_and_window_enabled = is_bit_set(lcd_control_lcdc, 0);
+
+    if (scanline_selected_object_count == 0 ||
+        (are_background_and_window_enabled &&
+         (!is_object_display_enabled() ||
+          (object_pixel.is_priority_bit_set && background_pixel_colour_index != 0) ||
+          object_pixel.colour_index == 0)))
+    {
+        const uint8_t colour_index = are_background_and_window_enabled
+            ? background_pixel_colour_index
+            : 0b00;
+        const uint8_t palette_colour_position = colour_index << 1;
+        return (background_palette_bgp & (0b11 << palette_colour_position)) >> palette_colour_position;
+    }
+
+    const uint8_t palette_colour_position = object_pixel.colour_index << 1;
+    const uint8_t palette = object_pixel.is_palette_bit_set
+        ? object_palette_1_obp1
+        : object_palette_0_obp0;
+    return (palette & (0b11 << palette_colour_position)) >> palette_colour_position;
+}
+
 void PixelProcessingUnit::step_horizontal_blank_single_dot()
 {
     if (current_scanline_dot_number < SCANLINE_DURATION_DOTS &&
@@ -482,7 +915,6 @@ void PixelProcessingUnit::trigger_stat_interrupts()
     if (did_scan_line_end_during_this_machine_cycle)
     {
         set_bit(lcd_status_stat, 2, false);
-        did_scan_line_end_during_this_machine_cycle = false;
     }
     else
     {
@@ -515,7 +947,7 @@ void PixelProcessingUnit::trigger_stat_interrupts()
         if (!are_stat_interrupts_blocked)
         {
             are_stat_interrupts_blocked = true;
-            request_interrupt_callback(INTERRUPT_FLAG_STAT_MASK);
+            interrupt_registers.request_interrupt(INTERRUPT_FLAG_STAT_MASK);
         }
     }
     else
@@ -527,7 +959,8 @@ void PixelProcessingUnit::switch_to_mode(PixelProcessingUnitMode new_mode)
     switch (new_mode)
     {
         case PixelProcessingUnitMode::ObjectAttributeMemoryScan:
-            scanline_selected_objects.clear();
+            scanline_selected_object_count = 0;
+            scanline_scanned_object_count = 0;
             current_object_index = 0;
             break;
         case PixelProcessingUnitMode::PixelTransfer:
@@ -537,14 +970,8 @@ void PixelProcessingUnit::switch_to_mode(PixelProcessingUnitMode new_mode)
             }
             is_window_enabled_for_scanline = is_bit_set(lcd_control_lcdc, 5);
 
-            scanline_pixels_to_discard_from_dummy_fetch_count = 8;
-            scanline_pixels_to_discard_from_scrolling_count = -1;
-
-            internal_lcd_x_coordinate_plus_8_lx = 0;
-            background_fetcher.reset_state();
-            object_fetcher.reset_state();
-            background_pixel_shift_register.clear();
-            object_pixel_shift_register.clear();
+            reset_pixel_transfer_state();
+            is_scanline_rendered_ahead = is_scanline_render_ahead_enabled && try_render_scanline_ahead();
             break;
         case PixelProcessingUnitMode::HorizontalBlank:
             break;
@@ -554,13 +981,25 @@ void PixelProcessingUnit::switch_to_mode(PixelProcessingUnitMode new_mode)
                 is_in_frame_after_lcd_enable = false;
                 std::fill_n(pixel_frame_buffers[in_progress_frame_index].get(), static_cast<uint16_t>(DISPLAY_WIDTH_PIXELS * DISPLAY_HEIGHT_PIXELS), 0);
             }
-            publish_new_frame();
-            request_interrupt_callback(INTERRUPT_FLAG_VERTICAL_BLANK_MASK);
+            finish_frame();
+            interrupt_registers.request_interrupt(INTERRUPT_FLAG_VERTICAL_BLANK_MASK);
             break;
     }
     current_mode = new_mode;
 }
 
+void PixelProcessingUnit::reset_pixel_transfer_state()
+{
+    scanline_pixels_to_discard_from_dummy_fetch_count = 8;
+    scanline_pixels_to_discard_from_scrolling_count = -1;
+
+    internal_lcd_x_coordinate_plus_8_lx = 0;
+    background_fetcher.reset_state();
+    object_fetcher.reset_state();
+    background_pixel_shift_register.clear();
+    object_pixel_shift_register.clear();
+}
+
 void PixelProcessingUnit::step_fetchers_single_dot()
 {
     if (background_fetcher.is_enabled)
@@ -590,7 +1029,7 @@ void PixelProcessingUnit::step_background_fetcher_single_dot()
 {
     if (background_fetcher.current_step == PixelSliceFetcherStep::PushPixels && background_pixel_shift_register.is_empty())
     {
-        background_pixel_shift_register.load_new_tile_row(background_fetcher.tile_row);
+        background_pixel_shift_register.load_new_tile_row(background_fetcher.tile_row_low, background_fetcher.tile_row_high);
         background_fetcher.current_step = PixelSliceFetcherStep::GetTileId;
     }
 
@@ -616,11 +1055,6 @@ void PixelProcessingUnit::step_background_fetcher_single_dot()
             if (!background_fetcher.is_in_first_dot_of_current_step)
             {
                 background_fetcher.tile_row_high = get_background_fetcher_tile_row_byte(1);
-
-                for (int i = 0; i < PIXELS_PER_TILE_ROW; i++)
-                {
-                    background_fetcher.tile_row[i] = BackgroundPixel{get_pixel_colour_id(background_fetcher, PIXELS_PER_TILE_ROW - 1 - i)};
-                }
                 background_fetcher.current_step = PixelSliceFetcherStep::PushPixels;
             }
             background_fetcher.is_in_first_dot_of_current_step = !background_fetcher.is_in_first_dot_of_current_step;
@@ -630,41 +1064,63 @@ void PixelProcessingUnit::step_background_fetcher_single_dot()
 
 uint8_t PixelProcessingUnit::get_background_fetcher_tile_id() const
 {
-    uint16_t tile_id_address = static_cast<uint16_t>(0b10011 << 11);
-    uint16_t tile_map_area_bit = 0x0000;
-
-    switch (background_fetcher.fetcher_mode)
+    if (background_fetcher.fetcher_mode == FetcherMode::WindowMode)
     {
-        case FetcherMode::BackgroundMode:
-            tile_map_area_bit = is_bit_set(lcd_control_lcdc, 3) ? (1 << 10) : 0;
-            tile_id_address |= (static_cast<uint8_t>(lcd_y_coordinate_ly + viewport_y_position_scy) >> 3) << 5;
-            tile_id_address |= static_cast<uint8_t>(internal_lcd_x_coordinate_plus_8_lx + viewport_x_position_scx) >> 3;
-            break;
-        case FetcherMode::WindowMode:
-            tile_map_area_bit = is_bit_set(lcd_control_lcdc, 6) ? (1 << 10) : 0;
-            tile_id_address |= (internal_window_line_counter_wlc >> 3) << 5;
-            tile_id_address |= (background_fetcher.fetcher_x >> 3);
-            break;
+        return get_tile_id(is_bit_set(lcd_control_lcdc, 6), background_fetcher.fetcher_x >> 3, internal_window_line_counter_wlc >> 3);
     }
-    tile_id_address |= tile_map_area_bit;
+    return get_tile_id(
+        is_bit_set(lcd_control_lcdc, 3),
+        static_cast<uint8_t>(internal_lcd_x_coordinate_plus_8_lx + viewport_x_position_scx) >> 3,
+        static_cast<uint8_t>(lcd_y_coordinate_ly + viewport_y_position_scy) >> 3);
+}
+
+uint8_t PixelProcessingUnit::get_background_fetcher_tile_row_byte(uint8_t offset) const
+{
+    const uint8_t tile_row = (background_fetcher.fetcher_mode == FetcherMode::BackgroundMode)
+        ? static_cast<uint8_t>(lcd_y_coordinate_ly + viewport_y_position_scy)
+        : internal_window_line_counter_wlc;
+    return video_ram[get_background_tile_row_local_address(background_fetcher.tile_index, tile_row) + offset];
+}
+
+void PixelProcessingUnit::decode_tile_row(uint16_t tile_row_local_address)
+{
+    const uint16_t tile_row_low_local_address = tile_row_local_address & ~1;
+    pixel_kernels.decode_tile_row(
+        video_ram[tile_row_low_local_address],
+        video_ram[tile_row_low_local_address + 1],
+        &decoded_tile_rows[tile_row_low_local_address * PIXELS_PER_TILE_ROW]);
+}
+
+const uint8_t* PixelProcessingUnit::get_decoded_tile_row(uint16_t tile_row_local_address, bool is_flipped_horizontally) const
+{
+    const uint16_t tile_row_low_local_address = tile_row_local_address & ~1;
+    return &decoded_tile_rows[tile_row_low_local_address * PIXELS_PER_TILE_ROW + (is_flipped_horizontally ? PIXELS_PER_TILE_ROW : 0)];
+}
+
+uint8_t PixelProcessingUnit::get_tile_id(bool is_tile_map_area_bit_set, uint8_t tile_map_x, uint8_t tile_map_y) const
+{
+    uint16_t tile_id_address = static_cast<uint16_t>(0b10011 << 11);
+    if (is_tile_map_area_bit_set)
+        tile_id_address |= (1 << 10);
+    tile_id_address |= (tile_map_y & 0b11111) << 5;
+    tile_id_address |= tile_map_x & 0b11111;
+
     const uint16_t local_address = tile_id_address - VIDEO_RAM_START;
     return video_ram[local_address];
 }
 
-uint8_t PixelProcessingUnit::get_background_fetcher_tile_row_byte(uint8_t offset) const
+// Only the low 3 bits of the tile row are used, and the second bit-plane byte follows at the next address
+uint16_t PixelProcessingUnit::get_background_tile_row_local_address(uint8_t tile_index, uint8_t tile_row) const
 {
-    uint16_t tile_row_address = static_cast<uint16_t>((1 << 15)) | (background_fetcher.tile_index << 4) | offset;
+    uint16_t tile_row_address = static_cast<uint16_t>((1 << 15)) | (tile_index << 4);
 
-    if (!is_bit_set(lcd_control_lcdc, 4) && !is_bit_set(background_fetcher.tile_index, 7))
+    if (!is_bit_set(lcd_control_lcdc, 4) && !is_bit_set(tile_index, 7))
     {
         tile_row_address |= (1 << 12);
     }
-    tile_row_address |= ((background_fetcher.fetcher_mode == FetcherMode::BackgroundMode
-        ? (lcd_y_coordinate_ly + viewport_y_position_scy)
-        : internal_window_line_counter_wlc) << 1) & 0b1110;
+    tile_row_address |= (tile_row << 1) & 0b1110;
 
-    const uint16_t local_address = tile_row_address - VIDEO_RAM_START;
-    return video_ram[local_address];
+    return tile_row_address - VIDEO_RAM_START;
 }
 
 void PixelProcessingUnit::step_object_fetcher_single_dot()
@@ -674,19 +1130,7 @@ void PixelProcessingUnit::step_object_fetcher_single_dot()
         case PixelSliceFetcherStep::GetTileId:
             if (!object_fetcher.is_in_first_dot_of_current_step)
             {
-                const bool is_access_unrestricted = true;
-                get_current_object().tile_index = read_byte_object_attribute_memory(get_current_object().object_start_global_address + 2, is_access_unrestricted);
-                get_current_object().flags = read_byte_object_attribute_memory(get_current_object().object_start_global_address + 3, is_access_unrestricted);
-
-                const bool is_object_double_height = is_bit_set(lcd_control_lcdc, 2);
-                if (is_object_double_height)
-                {
-                    const bool is_flipped_vertically = is_bit_set(get_current_object().flags, 6);
-
-                    set_bit(get_current_object().tile_index, 0, 
-                            lcd_y_coordinate_ly < get_current_object().y_position - 8 == is_flipped_vertically);
-                }
-                object_fetcher.tile_index = get_current_object().tile_index;
+                fetch_current_object_tile_index_and_flags();
                 object_fetcher.current_step = PixelSliceFetcherStep::GetTileRowLow;
             }
             object_fetcher.is_in_first_dot_of_current_step = !object_fetcher.is_in_first_dot_of_current_step;
@@ -711,15 +1155,7 @@ void PixelProcessingUnit::step_object_fetcher_single_dot()
 
     if (object_fetcher.current_step == PixelSliceFetcherStep::PushPixels)
     {
-        for (uint8_t i = 0; i < PIXELS_PER_TILE_ROW; i++)
-        {
-            if (object_pixel_shift_register[i].colour_index == 0b00)
-            {
-                object_pixel_shift_register[i].colour_index = get_pixel_colour_id(object_fetcher, PIXELS_PER_TILE_ROW - 1 - i);
-                object_pixel_shift_register[i].is_priority_bit_set = is_bit_set(get_current_object().flags, 7);
-                object_pixel_shift_register[i].is_palette_bit_set = is_bit_set(get_current_object().flags, 4);
-            }
-        }
+        object_pixel_shift_register.merge_tile_row(object_fetcher.tile_row_low, object_fetcher.tile_row_high, get_current_object().flags);
         current_object_index++;
 
         if (!(is_object_display_enabled() && is_next_object_hit()))
@@ -731,28 +1167,63 @@ void PixelProcessingUnit::step_object_fetcher_single_dot()
     }
 }
 
-uint8_t PixelProcessingUnit::get_object_fetcher_tile_row_byte(uint8_t offset)
+void PixelProcessingUnit::fetch_current_object_tile_index_and_flags()
 {
-    const bool is_flipped_vertically = is_bit_set(get_current_object().flags, 6);
-    const uint8_t tile_row_address_bits_1_to_3 = lcd_y_coordinate_ly - get_current_object().y_position;
+    const bool is_access_unrestricted = true;
+    get_current_object().tile_index = read_byte_object_attribute_memory(get_current_object().object_start_global_address + 2, is_access_unrestricted);
+    get_current_object().flags = read_byte_object_attribute_memory(get_current_object().object_start_global_address + 3, is_access_unrestricted);
 
-    uint16_t tile_row_address = static_cast<uint16_t>((1 << 15) | (object_fetcher.tile_index << 4) | offset);
-    tile_row_address |= ((is_flipped_vertically
-        ? ~tile_row_address_bits_1_to_3
-        : tile_row_address_bits_1_to_3) << 1) & 0b1110;
+    const bool is_object_double_height = is_bit_set(lcd_control_lcdc, 2);
+    if (is_object_double_height)
+    {
+        const bool is_flipped_vertically = is_bit_set(get_current_object().flags, 6);
 
-    const uint16_t local_address = tile_row_address - VIDEO_RAM_START;
-    const uint8_t tile_row_byte = video_ram[local_address];
+        set_bit(get_current_object().tile_index, 0, 
+                lcd_y_coordinate_ly < get_current_object().y_position - 8 == is_flipped_vertically);
+    }
+    object_fetcher.tile_index = get_current_object().tile_index;
+}
+
+uint8_t PixelProcessingUnit::get_object_fetcher_tile_row_byte(uint8_t offset)
+{
+    const uint8_t tile_row_byte = video_ram[get_object_tile_row_local_address(get_current_object()) + offset];
 
     return is_bit_set(get_current_object().flags, 5)
         ? get_byte_horizontally_flipped(tile_row_byte)
         : tile_row_byte;
 }
 
+uint16_t PixelProcessingUnit::get_object_tile_row_local_address(const ObjectAttributes& object) const
+{
+    const bool is_flipped_vertically = is_bit_set(object.flags, 6);
+    const uint8_t tile_row_address_bits_1_to_3 = lcd_y_coordinate_ly - object.y_position;
+
+    uint16_t tile_row_address = static_cast<uint16_t>((1 << 15) | (object.tile_index << 4));
+    tile_row_address |= ((is_flipped_vertically
+        ? ~tile_row_address_bits_1_to_3
+        : tile_row_address_bits_1_to_3) << 1) & 0b1110;
+
+    return tile_row_address - VIDEO_RAM_START;
+}
+
 void PixelProcessingUnit::publish_new_frame()
 {
     published_frame_index_atomic.store(in_progress_frame_index, std::memory_order_release);
     in_progress_frame_index = 1 - in_progress_frame_index;
+    published_frame_count++;
+}
+
+// A skipped frame still counts as published so runs stopping at each frame keep the same pace, but the frame buffers are not
+// swapped and the last drawn frame stays published
+void PixelProcessingUnit::finish_frame()
+{
+    if (is_frame_output_skipped)
+        published_frame_count++;
+    else
+        publish_new_frame();
+
+    is_frame_output_skipped = consecutive_skipped_frame_count + 1 < frame_skip_interval;
+    consecutive_skipped_frame_count = is_frame_output_skipped ? consecutive_skipped_frame_count + 1 : 0;
 }
 
 bool PixelProcessingUnit::is_object_display_enabled() const
@@ -762,7 +1233,7 @@ bool PixelProcessingUnit::is_object_display_enabled() const
 
 bool PixelProcessingUnit::is_next_object_hit() const
 {
-    return current_object_index < scanline_selected_objects.size() &&
+    return current_object_index < scanline_selected_object_count &&
            scanline_selected_objects[current_object_index].x_position == internal_lcd_x_coordinate_plus_8_lx;
 }
 
@@ -771,11 +1242,4 @@ ObjectAttributes& PixelProcessingUnit::get_current_object()
     return scanline_selected_objects[current_object_index];
 }
 
-uint8_t PixelProcessingUnit::get_pixel_colour_id(PixelSliceFetcher pixel_slice_fetcher, uint8_t bit_position) const
-{
-    const uint8_t low_bit = (pixel_slice_fetcher.tile_row_low >> bit_position) & 1;
-    const uint8_t high_bit = (pixel_slice_fetcher.tile_row_high >> bit_position) & 1;
-    return (high_bit << 1) | low_bit;
-}
-
 } // namespace GameBoyEmulator
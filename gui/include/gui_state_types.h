@@ -4,15 +4,26 @@
 #include <atomic>
 #include <backends/imgui_impl_sdl3.h>
 #include <cstdint>
+#include <memory>
 #include <SDL3/SDL.h>
+#include <string>
+#include <vector>
 
 #include "emulator.h"
+#include "game_rom_library.h"
 
+// Renders 1 in N frames while fast-forwarding, or lets the emulator thread pick N from how far it falls behind
+constexpr uint8_t AUTOMATIC_FRAME_SKIP_INTERVAL = 0;
+constexpr uint8_t MAX_AUTOMATIC_FRAME_SKIP_INTERVAL = 4;
+
+// The emulator thread sets is_emulation_thread_paused_atomic once it has seen the pause request and is no longer running the emulator
 struct EmulationController
 {
     std::atomic<bool> is_emulation_paused_atomic{};
+    std::atomic<bool> is_emulation_thread_paused_atomic{true};
     std::atomic<bool> is_fast_forward_enabled_atomic{};
     std::atomic<double> target_fast_forward_multiplier_atomic{1.5};
+    std::atomic<uint8_t> fast_forward_frame_skip_interval_atomic{AUTOMATIC_FRAME_SKIP_INTERVAL};
 };
 
 struct FileLoadingStatus
@@ -27,6 +38,14 @@ struct FullscreenDisplayStatus
     float seconds_remaining_until_main_menu_bar_and_cursor_hidden{};
 };
 
+struct GameRomLibraryBrowserState
+{
+    char search_text[128]{};
+    std::string filtered_search_text{};
+    std::shared_ptr<const std::vector<GameBoyEmulator::GameRomLibraryEntry>> filtered_entries{};
+    std::vector<size_t> filtered_entry_indices{};
+};
+
 struct GraphicsController
 {
     GraphicsController(
@@ -65,6 +84,8 @@ struct MenuProperties
 {
     ImVec4 selected_custom_colour_palette_colours[4]{};
     bool is_custom_palette_editor_open{};
+    bool is_game_rom_library_browser_open{};
     int selected_colour_palette_combobox_index{};
     int selected_fast_emulation_speed_index{};
+    int selected_fast_forward_frame_skip_index{};
 };
@@ -28,6 +28,16 @@ constexpr const char* FAST_FORWARD_SPEED_LABELS[] =
     "4.00x"
 };
 
+// Indexed by frame skip interval, with 0 for automatic
+constexpr const char* FAST_FORWARD_FRAME_SKIP_LABELS[] =
+{
+    "Automatic",
+    "Off",
+    "Draw 1 in 2 Frames",
+    "Draw 1 in 3 Frames",
+    "Draw 1 in 4 Frames"
+};
+
 void render_main_menu_bar(
     const uint8_t currently_published_frame_buffer_index,
     GameBoyEmulator::Emulator& game_boy_emulator,
@@ -46,6 +56,16 @@ void render_custom_colour_palette_editor(
     MenuProperties& menu_properties,
     GraphicsController& graphics_controller);
 
+void render_game_rom_library_browser(
+    GameBoyEmulator::Emulator& game_boy_emulator,
+    GameBoyEmulator::GameRomLibrary& game_rom_library,
+    EmulationController& emulation_controller,
+    FileLoadingStatus& file_loading_status,
+    GameRomLibraryBrowserState& game_rom_library_browser_state,
+    MenuProperties& menu_properties,
+    SDL_Window* sdl_window,
+    std::string& error_message);
+
 void render_error_message_popup(
     FileLoadingStatus& file_loading_status,
     std::atomic<bool>& is_emulation_paused_atomic,
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <atomic>
+#include <filesystem>
 #include <SDL3/SDL.h>
 
 #include "emulator.h"
+#include "game_rom_library.h"
 #include "gui_state_types.h"
 
 constexpr float MAIN_MENU_BAR_AND_CURSOR_HIDE_DELAY_SECONDS = 2.5f;
@@ -14,6 +16,8 @@ bool should_main_menu_bar_and_cursor_be_visible(
     FullscreenDisplayStatus& fullscreen_display_status,
     SDL_Window* sdl_window);
 
+void pause_emulation_and_wait_for_emulation_thread(EmulationController& emulation_controller);
+
 bool try_load_file_to_memory_with_dialog(
     GameBoyEmulator::FileType file_type,
     GameBoyEmulator::Emulator& game_boy_emulator,
@@ -22,6 +26,20 @@ bool try_load_file_to_memory_with_dialog(
     SDL_Window* sdl_window,
     std::string& error_message);
 
+bool try_load_file_to_memory_from_path(
+    const std::filesystem::path& file_path,
+    GameBoyEmulator::FileType file_type,
+    GameBoyEmulator::Emulator& game_boy_emulator,
+    EmulationController& emulation_controller,
+    FileLoadingStatus& file_loading_status,
+    SDL_Window* sdl_window,
+    std::string& error_message);
+
+bool try_add_game_rom_library_directory_with_dialog(
+    GameBoyEmulator::GameRomLibrary& game_rom_library,
+    SDL_Window* sdl_window,
+    std::string& error_message);
+
 void toggle_emulation_paused_state(
     std::atomic<bool>& is_emulation_paused_atomic,
     float& seconds_remaining_until_main_menu_bar_and_cursor_hidden);
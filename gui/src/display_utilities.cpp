@@ -1,6 +1,7 @@
 #include <backends/imgui_impl_sdl3.h>
 
 #include "display_utilities.h"
+#include "pixel_kernels.h"
 
 SDL_FRect get_sized_emulation_rectangle(
     SDL_Renderer* sdl_renderer,
@@ -53,10 +54,11 @@ void update_colour_palette(
     {
         auto const& pixel_frame_buffer = game_boy_emulator.get_pixel_frame_buffer(currently_published_frame_buffer_index);
 
-        for (int i = 0; i < DISPLAY_WIDTH_PIXELS * DISPLAY_HEIGHT_PIXELS; i++)
-        {
-            graphics_controller.abgr_pixel_buffer[i] = graphics_controller.active_colour_palette[pixel_frame_buffer[i]];
-        }
+        GameBoyEmulator::get_pixel_kernels().convert_shades_to_abgr(
+            pixel_frame_buffer.get(),
+            graphics_controller.active_colour_palette,
+            graphics_controller.abgr_pixel_buffer.get(),
+            DISPLAY_WIDTH_PIXELS * DISPLAY_HEIGHT_PIXELS);
         SDL_UpdateTexture(
             graphics_controller.sdl_texture,
             nullptr,
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <backends/imgui_impl_sdl3.h>
+#include <cctype>
+#include <string_view>
 
 #include "display_utilities.h"
 #include "imgui_rendering.h"
@@ -36,6 +39,11 @@ void render_main_menu_bar(
                     error_message);
             }
             ImGui::Spacing();
+            if (ImGui::MenuItem("ROM Library"))
+            {
+                menu_properties.is_game_rom_library_browser_open = true;
+            }
+            ImGui::Spacing();
             if (ImGui::MenuItem("Load Boot ROM (Optional)"))
             {
                 try_load_file_to_memory_with_dialog(
@@ -53,6 +61,7 @@ void render_main_menu_bar(
                 false,
                 game_boy_emulator.is_game_rom_loaded_in_memory_thread_safe()))
             {
+                pause_emulation_and_wait_for_emulation_thread(emulation_controller);
                 set_emulation_screen_blank(graphics_controller);
                 SDL_SetWindowTitle(sdl_window, std::string("Emulate Game Boy").c_str());
                 game_boy_emulator.unload_game_rom_from_memory_thread_safe();
@@ -139,6 +148,17 @@ void render_main_menu_bar(
                 const double emulation_speed_multiplier = menu_properties.selected_fast_emulation_speed_index * 0.25 + 1.5;
                 emulation_controller.target_fast_forward_multiplier_atomic.store(emulation_speed_multiplier, std::memory_order_release);
             }
+            ImGui::SeparatorText("Fast-Forward Frame Skip");
+            if (ImGui::Combo(
+                "##Fast-Forward Frame Skip",
+                &menu_properties.selected_fast_forward_frame_skip_index,
+                FAST_FORWARD_FRAME_SKIP_LABELS,
+                IM_ARRAYSIZE(FAST_FORWARD_FRAME_SKIP_LABELS)))
+            {
+                emulation_controller.fast_forward_frame_skip_interval_atomic.store(
+                    static_cast<uint8_t>(menu_properties.selected_fast_forward_frame_skip_index),
+                    std::memory_order_release);
+            }
             imgui_spaced_separator();
             if (ImGui::MenuItem(
                 is_fast_forward_enabled ? "Disable Fast-Forward" : "Enable Fast-Forward",
@@ -237,6 +257,175 @@ void render_custom_colour_palette_editor(
     }
 }
 
+static std::string get_lowercase_string(std::string_view text)
+{
+    std::string lowercase_text(text);
+    std::transform(lowercase_text.begin(), lowercase_text.end(), lowercase_text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lowercase_text;
+}
+
+// Filtering only reruns when the search text changes or a scan publishes new entries
+static void update_game_rom_library_filter(
+    const std::shared_ptr<const std::vector<GameBoyEmulator::GameRomLibraryEntry>>& game_rom_library_entries,
+    GameRomLibraryBrowserState& game_rom_library_browser_state)
+{
+    if (game_rom_library_browser_state.filtered_entries == game_rom_library_entries &&
+        game_rom_library_browser_state.filtered_search_text == game_rom_library_browser_state.search_text)
+    {
+        return;
+    }
+    game_rom_library_browser_state.filtered_entries = game_rom_library_entries;
+    game_rom_library_browser_state.filtered_search_text = game_rom_library_browser_state.search_text;
+    game_rom_library_browser_state.filtered_entry_indices.clear();
+
+    const std::string lowercase_search_text = get_lowercase_string(game_rom_library_browser_state.filtered_search_text);
+    for (size_t i = 0; i < game_rom_library_entries->size(); i++)
+    {
+        const GameBoyEmulator::GameRomLibraryEntry& entry = (*game_rom_library_entries)[i];
+        if (get_lowercase_string(entry.title).find(lowercase_search_text) != std::string::npos ||
+            get_lowercase_string(entry.file_path.filename().string()).find(lowercase_search_text) != std::string::npos)
+        {
+            game_rom_library_browser_state.filtered_entry_indices.push_back(i);
+        }
+    }
+}
+
+void render_game_rom_library_browser(
+    GameBoyEmulator::Emulator& game_boy_emulator,
+    GameBoyEmulator::GameRomLibrary& game_rom_library,
+    EmulationController& emulation_controller,
+    FileLoadingStatus& file_loading_status,
+    GameRomLibraryBrowserState& game_rom_library_browser_state,
+    MenuProperties& menu_properties,
+    SDL_Window* sdl_window,
+    std::string& error_message)
+{
+    if (!menu_properties.is_game_rom_library_browser_open)
+    {
+        return;
+    }
+    ImGui::SetNextWindowSize(ImVec2(640.0f, 400.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("ROM Library", &menu_properties.is_game_rom_library_browser_open))
+    {
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::Button("Add Folder"))
+    {
+        if (try_add_game_rom_library_directory_with_dialog(game_rom_library, sdl_window, error_message))
+        {
+            game_rom_library.start_scan();
+        }
+        else if (error_message != "")
+        {
+            file_loading_status.is_emulation_paused_before_rom_loading = emulation_controller.is_emulation_paused_atomic.load(std::memory_order_acquire);
+            file_loading_status.did_rom_loading_error_occur = true;
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Rescan"))
+    {
+        game_rom_library.start_scan();
+    }
+    if (game_rom_library.is_scan_in_progress())
+    {
+        ImGui::SameLine();
+        ImGui::TextDisabled("Scanning %u of %u changed files...", game_rom_library.get_scanned_file_count(), game_rom_library.get_file_count_to_scan());
+    }
+
+    if (ImGui::CollapsingHeader("Folders"))
+    {
+        for (const std::filesystem::path& directory_path : game_rom_library.get_directories())
+        {
+            ImGui::PushID(directory_path.string().c_str());
+            if (ImGui::SmallButton("Remove"))
+            {
+                game_rom_library.remove_directory(directory_path);
+                game_rom_library.start_scan();
+            }
+            ImGui::SameLine();
+            ImGui::TextUnformatted(directory_path.string().c_str());
+            ImGui::PopID();
+        }
+    }
+
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    ImGui::InputTextWithHint("##Search", "Search by title or file name", game_rom_library_browser_state.search_text, sizeof(game_rom_library_browser_state.search_text));
+    update_game_rom_library_filter(game_rom_library.get_entries(), game_rom_library_browser_state);
+
+    const ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersInnerV;
+    if (ImGui::BeginTable("##ROM Library Entries", 4, table_flags))
+    {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Title");
+        ImGui::TableSetupColumn("File");
+        ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Status");
+        ImGui::TableHeadersRow();
+
+        // Only the visible rows are submitted, so libraries with thousands of ROMs stay cheap to draw
+        const std::vector<GameBoyEmulator::GameRomLibraryEntry>& entries = *game_rom_library_browser_state.filtered_entries;
+        ImGuiListClipper list_clipper;
+        list_clipper.Begin(static_cast<int>(game_rom_library_browser_state.filtered_entry_indices.size()));
+        while (list_clipper.Step())
+        {
+            for (int row = list_clipper.DisplayStart; row < list_clipper.DisplayEnd; row++)
+            {
+                const GameBoyEmulator::GameRomLibraryEntry& entry = entries[game_rom_library_browser_state.filtered_entry_indices[row]];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::PushID(row);
+                if (!entry.is_loadable)
+                {
+                    ImGui::BeginDisabled();
+                }
+                if (ImGui::Selectable(entry.title.empty() ? "(Untitled)" : entry.title.c_str(), false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick) &&
+                    ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
+                {
+                    try_load_file_to_memory_from_path(
+                        entry.file_path,
+                        GameBoyEmulator::FileType::GameROM,
+                        game_boy_emulator,
+                        emulation_controller,
+                        file_loading_status,
+                        sdl_window,
+                        error_message);
+                }
+                if (!entry.is_loadable)
+                {
+                    ImGui::EndDisabled();
+                }
+                if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+                {
+                    ImGui::SetTooltip("%s", entry.file_path.string().c_str());
+                }
+                ImGui::PopID();
+
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(entry.file_path.filename().string().c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("0x%02X", entry.cartridge_type);
+                ImGui::TableNextColumn();
+                if (!entry.is_loadable)
+                {
+                    ImGui::TextDisabled("%s", entry.load_error_message.c_str());
+                }
+                else if (!entry.is_header_checksum_valid || !entry.is_global_checksum_valid)
+                {
+                    ImGui::TextUnformatted(!entry.is_header_checksum_valid ? "Header checksum mismatch" : "Global checksum mismatch");
+                }
+                else
+                {
+                    ImGui::TextUnformatted("OK");
+                }
+            }
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+
 void render_error_message_popup(
     FileLoadingStatus& file_loading_status,
     std::atomic<bool>& is_emulation_paused_atomic,
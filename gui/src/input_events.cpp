@@ -38,6 +38,45 @@ bool should_main_menu_bar_and_cursor_be_visible(
     return (fullscreen_display_status.seconds_remaining_until_main_menu_bar_and_cursor_hidden > 0.0f);
 }
 
+// Loading and unloading replace memory the emulator thread reads from, so it has to be waited for until it stops between frames
+void pause_emulation_and_wait_for_emulation_thread(EmulationController& emulation_controller)
+{
+    emulation_controller.is_emulation_paused_atomic.store(true, std::memory_order_seq_cst);
+    while (!emulation_controller.is_emulation_thread_paused_atomic.load(std::memory_order_seq_cst))
+    {
+        SDL_Delay(0);
+    }
+}
+
+static bool finish_loading_file_to_memory(
+    bool is_operation_successful,
+    GameBoyEmulator::FileType file_type,
+    GameBoyEmulator::Emulator& game_boy_emulator,
+    EmulationController& emulation_controller,
+    FileLoadingStatus& file_loading_status,
+    SDL_Window* sdl_window,
+    const std::string& error_message)
+{
+    if (is_operation_successful)
+    {
+        if (file_type == GameBoyEmulator::FileType::GameROM)
+        {
+            SDL_SetWindowTitle(
+                sdl_window,
+                std::string("Emulate Game Boy - " + game_boy_emulator.get_loaded_game_rom_title_thread_safe()).c_str());
+        }
+        emulation_controller.is_emulation_paused_atomic.store(false, std::memory_order_release);
+    }
+    else
+    {
+        file_loading_status.did_rom_loading_error_occur = (error_message != "");
+        emulation_controller.is_emulation_paused_atomic.store(
+            file_loading_status.is_emulation_paused_before_rom_loading,
+            std::memory_order_release);
+    }
+    return is_operation_successful;
+}
+
 bool try_load_file_to_memory_with_dialog(
     GameBoyEmulator::FileType file_type,
     GameBoyEmulator::Emulator& game_boy_emulator,
@@ -47,7 +86,7 @@ bool try_load_file_to_memory_with_dialog(
     std::string& error_message)
 {
     file_loading_status.is_emulation_paused_before_rom_loading = emulation_controller.is_emulation_paused_atomic.load(std::memory_order_acquire);
-    emulation_controller.is_emulation_paused_atomic.store(true, std::memory_order_release);
+    pause_emulation_and_wait_for_emulation_thread(emulation_controller);
 
     nfdopendialogu8args_t open_dialog_arguments{};
     nfdu8filteritem_t filters[] =
@@ -81,24 +120,69 @@ bool try_load_file_to_memory_with_dialog(
         error_message = NFD_GetError();
     }
 
-    if (is_operation_successful)
+    return finish_loading_file_to_memory(
+        is_operation_successful,
+        file_type,
+        game_boy_emulator,
+        emulation_controller,
+        file_loading_status,
+        sdl_window,
+        error_message);
+}
+
+bool try_load_file_to_memory_from_path(
+    const std::filesystem::path& file_path,
+    GameBoyEmulator::FileType file_type,
+    GameBoyEmulator::Emulator& game_boy_emulator,
+    EmulationController& emulation_controller,
+    FileLoadingStatus& file_loading_status,
+    SDL_Window* sdl_window,
+    std::string& error_message)
+{
+    file_loading_status.is_emulation_paused_before_rom_loading = emulation_controller.is_emulation_paused_atomic.load(std::memory_order_acquire);
+    pause_emulation_and_wait_for_emulation_thread(emulation_controller);
+
+    bool is_operation_successful = false;
+    if (game_boy_emulator.try_load_file_to_memory(file_path, file_type, error_message))
     {
         if (file_type == GameBoyEmulator::FileType::GameROM)
         {
-            SDL_SetWindowTitle(
-                sdl_window,
-                std::string("Emulate Game Boy - " + game_boy_emulator.get_loaded_game_rom_title_thread_safe()).c_str());
+            game_boy_emulator.reset_state();
         }
-        emulation_controller.is_emulation_paused_atomic.store(false, std::memory_order_release);
+        is_operation_successful = true;
     }
-    else
+    return finish_loading_file_to_memory(
+        is_operation_successful,
+        file_type,
+        game_boy_emulator,
+        emulation_controller,
+        file_loading_status,
+        sdl_window,
+        error_message);
+}
+
+bool try_add_game_rom_library_directory_with_dialog(
+    GameBoyEmulator::GameRomLibrary& game_rom_library,
+    SDL_Window* sdl_window,
+    std::string& error_message)
+{
+    nfdpickfolderu8args_t pick_folder_arguments{};
+    nfdchar_t* directory_path = nullptr;
+    NFD_GetNativeWindowFromSDLWindow(sdl_window, &pick_folder_arguments.parentWindow);
+
+    nfdresult_t result = NFD_PickFolderU8_With(&directory_path, &pick_folder_arguments);
+    if (result == NFD_OKAY)
     {
-        file_loading_status.did_rom_loading_error_occur = (error_message != "");
-        emulation_controller.is_emulation_paused_atomic.store(
-            file_loading_status.is_emulation_paused_before_rom_loading,
-            std::memory_order_release);
+        game_rom_library.add_directory(std::filesystem::path(std::u8string(reinterpret_cast<const char8_t*>(directory_path))));
+        NFD_FreePathU8(directory_path);
+        return true;
     }
-    return is_operation_successful;
+    else if (result == NFD_ERROR)
+    {
+        std::cerr << "NFD error: " << NFD_GetError() << "\n";
+        error_message = NFD_GetError();
+    }
+    return false;
 }
 
 void toggle_emulation_paused_state(
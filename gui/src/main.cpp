@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <atomic>
 #include <bit>
 #include <exception>
@@ -18,8 +19,10 @@
 
 #include "display_utilities.h"
 #include "emulator.h"
+#include "game_rom_library.h"
 #include "imgui_rendering.h"
 #include "input_events.h"
+#include "pixel_kernels.h"
 #include "raii_wrappers.h"
 #include "gui_state_types.h"
 
@@ -36,48 +39,87 @@ static void run_emulator_core(
         const uint64_t counter_ticks_per_second = SDL_GetPerformanceFrequency();
         const uint64_t counter_ticks_per_frame_rounded = static_cast<uint64_t>(FRAME_DURATION_SECONDS * counter_ticks_per_second + 0.5);
 
+        // Bounds each batch to a frame's worth of machine cycles so pausing and stopping stay responsive while the LCD is off
+        constexpr uint64_t MACHINE_CYCLES_PER_FRAME =
+            (GameBoyEmulator::FINAL_SCANLINE_OF_FRAME + 1) * GameBoyEmulator::SCANLINE_DURATION_DOTS / GameBoyEmulator::DOTS_PER_MACHINE_CYCLE;
+
         uint64_t next_frame_counter_tick = SDL_GetPerformanceCounter();
-        uint8_t previously_published_frame_buffer_index = game_boy_emulator.get_published_frame_buffer_index_thread_safe();
+        uint8_t automatic_frame_skip_interval = 1;
 
         while (!stop_token.stop_requested())
         {
             if (!game_boy_emulator.is_game_rom_loaded_in_memory_thread_safe() ||
                 emulation_controller.is_emulation_paused_atomic.load(std::memory_order_acquire))
             {
+                emulation_controller.is_emulation_thread_paused_atomic.store(true, std::memory_order_seq_cst);
                 SDL_Delay(0);
                 continue;
             }
-            game_boy_emulator.step_central_processing_unit_single_instruction();
-
-            const uint8_t currently_published_frame_buffer_index = game_boy_emulator.get_published_frame_buffer_index_thread_safe();
 
-            if (currently_published_frame_buffer_index != previously_published_frame_buffer_index)
+            // Announcing that the thread runs before checking the pause request again means a thread pausing emulation
+            // either sees it running and waits, or its request is seen here before the emulator runs
+            emulation_controller.is_emulation_thread_paused_atomic.store(false, std::memory_order_seq_cst);
+            if (emulation_controller.is_emulation_paused_atomic.load(std::memory_order_seq_cst))
             {
-                previously_published_frame_buffer_index = currently_published_frame_buffer_index;
+                continue;
+            }
 
-                double target_emulation_speed = emulation_controller.is_fast_forward_enabled_atomic.load(std::memory_order_acquire)
-                    ? emulation_controller.target_fast_forward_multiplier_atomic.load(std::memory_order_acquire)
-                    : 1.0;
-                next_frame_counter_tick += counter_ticks_per_frame_rounded / target_emulation_speed;
-                const uint64_t current_counter_tick = SDL_GetPerformanceCounter();
+            const bool is_fast_forward_enabled = emulation_controller.is_fast_forward_enabled_atomic.load(std::memory_order_acquire);
+            const uint8_t fast_forward_frame_skip_interval = emulation_controller.fast_forward_frame_skip_interval_atomic.load(std::memory_order_acquire);
+            const bool is_automatic_frame_skip_enabled = is_fast_forward_enabled && fast_forward_frame_skip_interval == AUTOMATIC_FRAME_SKIP_INTERVAL;
+            if (!is_fast_forward_enabled)
+                game_boy_emulator.set_frame_skip_interval(1);
+            else
+                game_boy_emulator.set_frame_skip_interval(is_automatic_frame_skip_enabled ? automatic_frame_skip_interval : fast_forward_frame_skip_interval);
 
-                if (next_frame_counter_tick > current_counter_tick)
-                {
-                    const uint64_t delay_in_nanoseconds = (next_frame_counter_tick - current_counter_tick) * 1'000'000'000ull / counter_ticks_per_second;
-                    SDL_DelayPrecise(delay_in_nanoseconds);
-                }
-                else
-                    next_frame_counter_tick = current_counter_tick;
+            game_boy_emulator.run_until_frame(MACHINE_CYCLES_PER_FRAME);
+
+            double target_emulation_speed = is_fast_forward_enabled
+                ? emulation_controller.target_fast_forward_multiplier_atomic.load(std::memory_order_acquire)
+                : 1.0;
+            const uint64_t counter_ticks_per_target_frame = static_cast<uint64_t>(counter_ticks_per_frame_rounded / target_emulation_speed);
+            next_frame_counter_tick += counter_ticks_per_target_frame;
+            const uint64_t current_counter_tick = SDL_GetPerformanceCounter();
+
+            // Automatic frame skip draws fewer frames while the emulator falls behind, and more again once over half of each frame is spare
+            if (next_frame_counter_tick > current_counter_tick)
+            {
+                if (is_automatic_frame_skip_enabled && next_frame_counter_tick - current_counter_tick > counter_ticks_per_target_frame / 2)
+                    automatic_frame_skip_interval = std::max<uint8_t>(automatic_frame_skip_interval - 1, 1);
+
+                const uint64_t delay_in_nanoseconds = (next_frame_counter_tick - current_counter_tick) * 1'000'000'000ull / counter_ticks_per_second;
+                SDL_DelayPrecise(delay_in_nanoseconds);
+            }
+            else
+            {
+                if (is_automatic_frame_skip_enabled)
+                    automatic_frame_skip_interval = std::min<uint8_t>(automatic_frame_skip_interval + 1, MAX_AUTOMATIC_FRAME_SKIP_INTERVAL);
+                next_frame_counter_tick = current_counter_tick;
             }
         }
     }
     catch (...)
     {
         exception_pointer = std::current_exception();
+        emulation_controller.is_emulation_thread_paused_atomic.store(true, std::memory_order_seq_cst);
         did_exception_occur_atomic.store(true, std::memory_order_release);
     }
 }
 
+// Kept in the per-user application data directory, or the working directory if SDL cannot provide one
+static std::filesystem::path get_game_rom_library_cache_file_path()
+{
+    constexpr const char* GAME_ROM_LIBRARY_CACHE_FILE_NAME = "rom_library.cache";
+    char* preference_path = SDL_GetPrefPath("", "Emulate Game Boy");
+    if (preference_path == nullptr)
+    {
+        return GAME_ROM_LIBRARY_CACHE_FILE_NAME;
+    }
+    const std::filesystem::path cache_file_path = std::filesystem::path(std::u8string(reinterpret_cast<const char8_t*>(preference_path))) / GAME_ROM_LIBRARY_CACHE_FILE_NAME;
+    SDL_free(preference_path);
+    return cache_file_path;
+}
+
 int main()
 {
     try
@@ -116,6 +158,8 @@ int main()
         }
 
         GameBoyEmulator::Emulator game_boy_emulator{};
+        game_boy_emulator.set_battery_backed_save_files_enabled(true);
+        game_boy_emulator.set_real_time_clock_time_source(GameBoyEmulator::RealTimeClockTimeSource::HostSystemClock);
         EmulationController emulation_controller{};
         std::atomic<bool> did_emulator_core_exception_occur_atomic{};
         std::exception_ptr emulator_core_exception_pointer{};
@@ -128,6 +172,15 @@ int main()
             std::ref(emulator_core_exception_pointer),
         };
 
+        GameBoyEmulator::GameRomLibrary game_rom_library{get_game_rom_library_cache_file_path()};
+        std::string game_rom_library_error_message{};
+        if (!game_rom_library.try_load_cache(game_rom_library_error_message))
+        {
+            std::cerr << "Warning: " << game_rom_library_error_message << "\n";
+        }
+        game_rom_library.start_scan();
+        GameRomLibraryBrowserState game_rom_library_browser_state{};
+
         FileLoadingStatus file_loading_status{};
         FullscreenDisplayStatus fullscreen_display_status{};
         constexpr uint32_t initial_custom_colour_palette[4] =
@@ -174,10 +227,11 @@ int main()
             {
                 auto const& pixel_frame_buffer = game_boy_emulator.get_pixel_frame_buffer(currently_published_frame_buffer_index);
 
-                for (int i = 0; i < DISPLAY_WIDTH_PIXELS * DISPLAY_HEIGHT_PIXELS; i++)
-                {
-                    graphics_controller.abgr_pixel_buffer[i] = graphics_controller.active_colour_palette[pixel_frame_buffer[i]];
-                }
+                GameBoyEmulator::get_pixel_kernels().convert_shades_to_abgr(
+                    pixel_frame_buffer.get(),
+                    graphics_controller.active_colour_palette,
+                    graphics_controller.abgr_pixel_buffer.get(),
+                    DISPLAY_WIDTH_PIXELS * DISPLAY_HEIGHT_PIXELS);
                 SDL_UpdateTexture(sdl_texture.get(), nullptr, graphics_controller.abgr_pixel_buffer.get(), DISPLAY_WIDTH_PIXELS * sizeof(uint32_t));
                 previously_published_frame_buffer_index = currently_published_frame_buffer_index;
             }
@@ -224,6 +278,16 @@ int main()
                 menu_properties,
                 graphics_controller);
 
+            render_game_rom_library_browser(
+                game_boy_emulator,
+                game_rom_library,
+                emulation_controller,
+                file_loading_status,
+                game_rom_library_browser_state,
+                menu_properties,
+                sdl_window.get(),
+                error_message);
+
             render_error_message_popup(
                 file_loading_status,
                 emulation_controller.is_emulation_paused_atomic,
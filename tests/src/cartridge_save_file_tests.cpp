@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "cartridge_save_file.h"
+#include "event_scheduler.h"
+#include "memory_bank_controllers.h"
+#include "temporary_directory_test.h"
+
+static uint32_t read_little_endian_32_bit_value(std::span<const uint8_t> bytes, size_t offset)
+{
+    return bytes[offset] | (bytes[offset + 1] << 8) | (bytes[offset + 2] << 16) | (static_cast<uint32_t>(bytes[offset + 3]) << 24);
+}
+
+class CartridgeSaveFileTest : public TemporaryDirectoryTest
+{
+protected:
+    static constexpr uint32_t RAM_SIZE = 0x4000;
+
+    std::filesystem::path save_file_path{};
+    std::string error_message{};
+
+    void SetUp() override
+    {
+        TemporaryDirectoryTest::SetUp();
+        save_file_path = test_directory_path / "game.sav";
+    }
+};
+
+TEST_F(CartridgeSaveFileTest, NewSaveFileStartsWithTheInitialRamValue)
+{
+    std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0xFF, false, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    EXPECT_TRUE(std::ranges::all_of(save_file->get_ram(), [](uint8_t ram_byte) { return ram_byte == 0xFF; }));
+    EXPECT_TRUE(save_file->get_real_time_clock_save_data().empty());
+    save_file.reset();
+    EXPECT_EQ(std::filesystem::file_size(save_file_path), RAM_SIZE);
+}
+
+TEST_F(CartridgeSaveFileTest, RamRoundTripsThroughTheSaveFile)
+{
+    std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, false, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    for (uint32_t i = 0; i < RAM_SIZE; i++)
+    {
+        save_file->get_ram()[i] = static_cast<uint8_t>(i * 7);
+    }
+    save_file->get_dirty_save_data_mask().fetch_or(0b11);
+    save_file.reset();
+
+    const std::vector<uint8_t> save_file_bytes = read_file(save_file_path);
+    ASSERT_EQ(save_file_bytes.size(), RAM_SIZE);
+    for (uint32_t i = 0; i < RAM_SIZE; i++)
+    {
+        ASSERT_EQ(save_file_bytes[i], static_cast<uint8_t>(i * 7)) << "at offset " << i;
+    }
+
+    // Existing contents are kept rather than filled with the initial value when the file is opened again
+    save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0xFF, false, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    EXPECT_TRUE(std::ranges::equal(save_file->get_ram(), save_file_bytes));
+}
+
+TEST_F(CartridgeSaveFileTest, ShorterSaveFileIsExtendedWithTheInitialRamValue)
+{
+    {
+        std::ofstream short_save_file(save_file_path, std::ios::binary);
+        const std::vector<uint8_t> short_save_file_bytes(0x2000, 0x12);
+        short_save_file.write(reinterpret_cast<const char*>(short_save_file_bytes.data()), static_cast<std::streamsize>(short_save_file_bytes.size()));
+    }
+    std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0xFF, false, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    EXPECT_EQ(save_file->get_ram()[0x1FFF], 0x12);
+    EXPECT_EQ(save_file->get_ram()[0x2000], 0xFF);
+    EXPECT_EQ(save_file->get_ram()[RAM_SIZE - 1], 0xFF);
+}
+
+TEST_F(CartridgeSaveFileTest, RealTimeClockTrailerFollowsTheRam)
+{
+    std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, true, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    EXPECT_EQ(save_file->get_ram().size(), RAM_SIZE);
+    EXPECT_EQ(save_file->get_real_time_clock_save_data().size(), GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_SIZE);
+    EXPECT_EQ(save_file->get_real_time_clock_save_data().data(), save_file->get_ram().data() + RAM_SIZE);
+    save_file.reset();
+    EXPECT_EQ(std::filesystem::file_size(save_file_path), RAM_SIZE + GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_SIZE);
+}
+
+TEST_F(CartridgeSaveFileTest, SaveFileCanOnlyBeOpenedOnce)
+{
+    std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, false, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    EXPECT_EQ(GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, false, error_message), nullptr);
+
+    save_file.reset();
+    EXPECT_NE(GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, false, error_message), nullptr);
+}
+
+TEST_F(CartridgeSaveFileTest, DirtySaveDataIsFlushedInTheBackground)
+{
+    std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, true, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    save_file->get_dirty_save_data_mask().fetch_or(0b10 | GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_DIRTY_MASK);
+
+    const auto deadline = std::chrono::steady_clock::now() + 5 * GameBoyEmulator::CARTRIDGE_SAVE_FILE_FLUSH_INTERVAL;
+    while (save_file->get_dirty_save_data_mask().load() != 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(save_file->get_dirty_save_data_mask().load(), 0u);
+}
+
+TEST_F(CartridgeSaveFileTest, MemoryBankControllerWritesMarkSaveDataDirty)
+{
+    std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, true, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    const std::vector<uint8_t> rom(0x8000);
+    GameBoyEmulator::EventScheduler event_scheduler{};
+    GameBoyEmulator::MBC3 mbc3{rom, save_file->get_ram(), event_scheduler, GameBoyEmulator::RealTimeClockTimeSource::EmulatedMachineCycles};
+    mbc3.track_save_data_writes(save_file->get_dirty_save_data_mask());
+    mbc3.map_real_time_clock_save_data(save_file->get_real_time_clock_save_data());
+    save_file->get_dirty_save_data_mask().store(0);
+
+    mbc3.write_byte(0x0000, 0x0A);
+    mbc3.write_byte(0x4000, 0x01);
+    mbc3.write_byte(0xA123, 0x5A);
+    EXPECT_EQ(save_file->get_ram()[0x2123], 0x5A);
+    EXPECT_EQ(save_file->get_dirty_save_data_mask().load() & 0b11, 0b10u);
+
+    mbc3.write_byte(0x4000, 0x08);
+    mbc3.write_byte(0xA000, 42);
+    EXPECT_NE(save_file->get_dirty_save_data_mask().load() & GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_DIRTY_MASK, 0u);
+    EXPECT_EQ(read_little_endian_32_bit_value(save_file->get_real_time_clock_save_data(), 0), 42u);
+}
+
+// Counters, latched registers and a host timestamp as in the widely used 48-byte trailer layout
+TEST_F(CartridgeSaveFileTest, RealTimeClockRoundTripsThroughTheTrailer)
+{
+    const std::vector<uint8_t> rom(0x8000);
+    GameBoyEmulator::EventScheduler event_scheduler{};
+    {
+        std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, true, error_message);
+        ASSERT_NE(save_file, nullptr) << error_message;
+        GameBoyEmulator::MBC3 mbc3{rom, save_file->get_ram(), event_scheduler, GameBoyEmulator::RealTimeClockTimeSource::EmulatedMachineCycles};
+        mbc3.track_save_data_writes(save_file->get_dirty_save_data_mask());
+        mbc3.map_real_time_clock_save_data(save_file->get_real_time_clock_save_data());
+
+        mbc3.write_byte(0x0000, 0x0A);
+        const uint8_t clock_register_values[] = {12, 34, 5, 0x89, 0b01000001};
+        for (uint8_t i = 0; i < std::size(clock_register_values); i++)
+        {
+            mbc3.write_byte(0x4000, 0x08 + i);
+            mbc3.write_byte(0xA000, clock_register_values[i]);
+        }
+    }
+
+    const std::vector<uint8_t> save_file_bytes = read_file(save_file_path);
+    ASSERT_EQ(save_file_bytes.size(), RAM_SIZE + GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_SIZE);
+    const std::span<const uint8_t> trailer{save_file_bytes.data() + RAM_SIZE, GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_SIZE};
+    EXPECT_EQ(read_little_endian_32_bit_value(trailer, 0), 12u);
+    EXPECT_EQ(read_little_endian_32_bit_value(trailer, 4), 34u);
+    EXPECT_EQ(read_little_endian_32_bit_value(trailer, 8), 5u);
+    EXPECT_EQ(read_little_endian_32_bit_value(trailer, 12), 0x89u);
+    EXPECT_EQ(read_little_endian_32_bit_value(trailer, 16), 0b01000001u);
+    EXPECT_EQ(read_little_endian_32_bit_value(trailer, 20), 12u);
+    EXPECT_EQ(read_little_endian_32_bit_value(trailer, 36), 0b01000001u);
+    EXPECT_NE(read_little_endian_32_bit_value(trailer, 40), 0u);
+
+    std::unique_ptr<GameBoyEmulator::CartridgeSaveFile> save_file = GameBoyEmulator::CartridgeSaveFile::try_open(save_file_path, RAM_SIZE, 0x00, true, error_message);
+    ASSERT_NE(save_file, nullptr) << error_message;
+    GameBoyEmulator::MBC3 mbc3{rom, save_file->get_ram(), event_scheduler, GameBoyEmulator::RealTimeClockTimeSource::EmulatedMachineCycles};
+    mbc3.map_real_time_clock_save_data(save_file->get_real_time_clock_save_data());
+    mbc3.write_byte(0x6000, 0x00);
+    mbc3.write_byte(0x6000, 0x01);
+    const uint8_t expected_clock_register_values[] = {12, 34, 5, 0x89, 0b01000001};
+    for (uint8_t i = 0; i < std::size(expected_clock_register_values); i++)
+    {
+        mbc3.write_byte(0x4000, 0x08 + i);
+        EXPECT_EQ(mbc3.read_byte(0xA000), expected_clock_register_values[i]) << "clock register 0x" << std::hex << (0x08 + i);
+    }
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+#include "pixel_processing_unit.h"
+
+static constexpr uint64_t MACHINE_CYCLES_PER_FRAME =
+    (GameBoyEmulator::FINAL_SCANLINE_OF_FRAME + 1) * GameBoyEmulator::SCANLINE_DURATION_DOTS / GameBoyEmulator::DOTS_PER_MACHINE_CYCLE;
+
+// The longest instruction takes 6 machine cycles and an interrupt dispatch 5
+static constexpr uint64_t MAX_MACHINE_CYCLES_PAST_STOP = 11;
+
+static const std::filesystem::path TEST_DATA_DIRECTORY = std::filesystem::path(PROJECT_ROOT) / "tests" / "data";
+static const std::filesystem::path MOONEYE_TEST_SUITE_DIRECTORY = TEST_DATA_DIRECTORY / "mooneye-test-suite" / "mts-20240926-1737-443f6e1";
+
+// Passing mooneye tests load the Fibonacci sequence 3, 5, 8, 13, 21, 34 into B, C, D, E, H and L, then execute LD B,B
+static constexpr uint8_t MOONEYE_DEBUG_BREAKPOINT_OPCODE = 0x40;
+
+static GameBoyEmulator::RegisterPattern create_mooneye_success_register_pattern()
+{
+    GameBoyEmulator::RegisterPattern register_pattern{};
+    register_pattern.expected_register_values.BC = 0x0305;
+    register_pattern.expected_register_values.DE = 0x080D;
+    register_pattern.expected_register_values.HL = 0x1522;
+    register_pattern.compared_bits_masks.BC = 0xFFFF;
+    register_pattern.compared_bits_masks.DE = 0xFFFF;
+    register_pattern.compared_bits_masks.HL = 0xFFFF;
+    return register_pattern;
+}
+
+class EmulationStopConditionsTest : public testing::Test
+{
+protected:
+    GameBoyEmulator::Emulator game_boy_emulator;
+    std::string error_message{};
+
+    void load_game_rom(const std::filesystem::path& rom_path)
+    {
+        ASSERT_TRUE(std::filesystem::exists(rom_path)) << "ROM file not found: " << rom_path;
+        ASSERT_TRUE(game_boy_emulator.try_load_file_to_memory(rom_path, GameBoyEmulator::FileType::GameROM, error_message)) << error_message;
+        game_boy_emulator.reset_state();
+    }
+};
+
+TEST_F(EmulationStopConditionsTest, RunUntilFrameStopsOncePerPublishedFrame)
+{
+    load_game_rom(MOONEYE_TEST_SUITE_DIRECTORY / "acceptance" / "instr" / "daa.gb");
+
+    // The test runs with the LCD turned off and leaves it on to show its result once it finishes
+    GameBoyEmulator::EmulationStopConditions stop_conditions{};
+    stop_conditions.machine_cycle_budget = 40'000'000;
+    stop_conditions.breakpoint_opcode = MOONEYE_DEBUG_BREAKPOINT_OPCODE;
+    ASSERT_EQ(game_boy_emulator.run_until_event(stop_conditions).reason, GameBoyEmulator::EmulationStopReason::BreakpointOpcodeReached);
+
+    ASSERT_EQ(game_boy_emulator.run_until_frame(MACHINE_CYCLES_PER_FRAME * 2).reason, GameBoyEmulator::EmulationStopReason::FramePublished);
+    uint64_t previous_stop_machine_cycle = game_boy_emulator.get_elapsed_machine_cycles();
+    for (uint32_t frame = 0; frame < 30; frame++)
+    {
+        ASSERT_EQ(game_boy_emulator.run_until_frame(MACHINE_CYCLES_PER_FRAME * 2).reason, GameBoyEmulator::EmulationStopReason::FramePublished);
+        const uint64_t stop_machine_cycle = game_boy_emulator.get_elapsed_machine_cycles();
+        EXPECT_NEAR(static_cast<double>(stop_machine_cycle - previous_stop_machine_cycle), static_cast<double>(MACHINE_CYCLES_PER_FRAME), MAX_MACHINE_CYCLES_PAST_STOP);
+        previous_stop_machine_cycle = stop_machine_cycle;
+    }
+
+    // A budget too small to reach the next frame runs out first
+    ASSERT_EQ(game_boy_emulator.run_until_frame(1000).reason, GameBoyEmulator::EmulationStopReason::MachineCycleBudgetExhausted);
+    EXPECT_GE(game_boy_emulator.get_elapsed_machine_cycles(), previous_stop_machine_cycle + 1000);
+    EXPECT_LE(game_boy_emulator.get_elapsed_machine_cycles(), previous_stop_machine_cycle + 1000 + MAX_MACHINE_CYCLES_PAST_STOP);
+}
+
+TEST_F(EmulationStopConditionsTest, BreakpointOpcodeStopsBeforeItIsExecutedAndResumingMovesPastIt)
+{
+    load_game_rom(MOONEYE_TEST_SUITE_DIRECTORY / "acceptance" / "instr" / "daa.gb");
+
+    GameBoyEmulator::EmulationStopConditions stop_conditions{};
+    stop_conditions.machine_cycle_budget = 40'000'000;
+    stop_conditions.breakpoint_opcode = MOONEYE_DEBUG_BREAKPOINT_OPCODE;
+
+    ASSERT_EQ(game_boy_emulator.run_until_event(stop_conditions).reason, GameBoyEmulator::EmulationStopReason::BreakpointOpcodeReached);
+    const uint16_t breakpoint_address = game_boy_emulator.get_register_file().program_counter - 1;
+    EXPECT_EQ(game_boy_emulator.read_byte_from_memory(breakpoint_address), MOONEYE_DEBUG_BREAKPOINT_OPCODE);
+    EXPECT_TRUE(create_mooneye_success_register_pattern().does_match(game_boy_emulator.get_register_file()));
+
+    // Conditions are checked after each instruction, so resuming executes the breakpoint instead of stopping on it again, and the
+    // result screen that follows has no other breakpoint
+    const uint64_t breakpoint_machine_cycle = game_boy_emulator.get_elapsed_machine_cycles();
+    stop_conditions.machine_cycle_budget = 1000;
+    EXPECT_EQ(game_boy_emulator.run_until_event(stop_conditions).reason, GameBoyEmulator::EmulationStopReason::MachineCycleBudgetExhausted);
+    EXPECT_GE(game_boy_emulator.get_elapsed_machine_cycles(), breakpoint_machine_cycle + 1000);
+}
+
+TEST_F(EmulationStopConditionsTest, RegisterPatternReportsTheIndexOfTheMatchedPattern)
+{
+    load_game_rom(MOONEYE_TEST_SUITE_DIRECTORY / "acceptance" / "instr" / "daa.gb");
+
+    GameBoyEmulator::RegisterPattern unmatched_register_pattern{};
+    unmatched_register_pattern.expected_register_values.stack_pointer = 0x0000;
+    unmatched_register_pattern.compared_bits_masks.stack_pointer = 0xFFFF;
+
+    GameBoyEmulator::EmulationStopConditions stop_conditions{};
+    stop_conditions.machine_cycle_budget = 40'000'000;
+    stop_conditions.register_patterns = {unmatched_register_pattern, create_mooneye_success_register_pattern()};
+
+    const GameBoyEmulator::EmulationStopResult stop_result = game_boy_emulator.run_until_event(stop_conditions);
+    ASSERT_EQ(stop_result.reason, GameBoyEmulator::EmulationStopReason::RegisterPatternMatched);
+    EXPECT_EQ(stop_result.matched_register_pattern_index, 1u);
+    EXPECT_TRUE(create_mooneye_success_register_pattern().does_match(game_boy_emulator.get_register_file()));
+
+    // A pattern that compares no bits matches at every instruction boundary, so resuming stops after exactly one instruction
+    GameBoyEmulator::EmulationStopConditions every_instruction_stop_conditions{};
+    every_instruction_stop_conditions.machine_cycle_budget = 40'000'000;
+    every_instruction_stop_conditions.register_patterns = {GameBoyEmulator::RegisterPattern{}};
+    for (uint32_t instruction = 0; instruction < 100; instruction++)
+    {
+        const uint64_t previous_stop_machine_cycle = game_boy_emulator.get_elapsed_machine_cycles();
+        const GameBoyEmulator::EmulationStopResult resumed_stop_result = game_boy_emulator.run_until_event(every_instruction_stop_conditions);
+        ASSERT_EQ(resumed_stop_result.reason, GameBoyEmulator::EmulationStopReason::RegisterPatternMatched);
+        EXPECT_EQ(resumed_stop_result.matched_register_pattern_index, 0u);
+        EXPECT_GT(game_boy_emulator.get_elapsed_machine_cycles(), previous_stop_machine_cycle);
+        EXPECT_LE(game_boy_emulator.get_elapsed_machine_cycles(), previous_stop_machine_cycle + MAX_MACHINE_CYCLES_PAST_STOP);
+    }
+}
+
+// Blargg test ROMs print their results through the serial port, writing each character to SB before starting the transfer
+TEST_F(EmulationStopConditionsTest, WatchedWriteStopsAfterEachWriteAndResumes)
+{
+    load_game_rom(TEST_DATA_DIRECTORY / "blargg-tests" / "gb-test-roms" / "cpu_instrs" / "individual" / "06-ld r,r.gb");
+
+    GameBoyEmulator::EmulationStopConditions stop_conditions{};
+    stop_conditions.watched_write_address = 0xFF02;
+
+    std::string serial_output{};
+    while (serial_output.find("Passed") == std::string::npos && game_boy_emulator.get_elapsed_machine_cycles() < 10'000'000)
+    {
+        stop_conditions.machine_cycle_budget = 10'000'000 - game_boy_emulator.get_elapsed_machine_cycles();
+        if (game_boy_emulator.run_until_event(stop_conditions).reason != GameBoyEmulator::EmulationStopReason::WatchedAddressWritten)
+            break;
+
+        serial_output += static_cast<char>(game_boy_emulator.read_byte_from_memory(0xFF01));
+    }
+    EXPECT_EQ(serial_output, "06-ld r,r\n\n\nPassed");
+}
+
+// Stopping on the machine cycle budget must land on the same instruction boundary whether or not halts, idle loops and translated
+// blocks are run as single steps, so the reference steps each instruction until it reaches the limit
+class MachineCycleBudgetTest : public testing::TestWithParam<std::filesystem::path>
+{
+protected:
+    static constexpr uint32_t FRAME_COUNT = 30;
+
+    GameBoyEmulator::Emulator reference_emulator;
+    GameBoyEmulator::Emulator game_boy_emulator;
+    std::string error_message{};
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(std::filesystem::exists(GetParam())) << "ROM file not found: " << GetParam();
+        for (GameBoyEmulator::Emulator* emulator : {&reference_emulator, &game_boy_emulator})
+        {
+            ASSERT_TRUE(emulator->try_load_file_to_memory(GetParam(), GameBoyEmulator::FileType::GameROM, error_message)) << error_message;
+            emulator->reset_state();
+        }
+        reference_emulator.set_halt_fast_forward_enabled(false);
+        reference_emulator.set_idle_loop_skip_enabled(false);
+        reference_emulator.set_dynamic_recompilation_enabled(false);
+    }
+};
+
+TEST_P(MachineCycleBudgetTest, StopsOnTheSameInstructionBoundaryAsSteppingEachInstruction)
+{
+    std::mt19937 random_number_generator{0x1989};
+    std::uniform_int_distribution<uint64_t> machine_cycle_budget_distribution{0, 2000};
+
+    while (game_boy_emulator.get_elapsed_machine_cycles() < FRAME_COUNT * MACHINE_CYCLES_PER_FRAME)
+    {
+        const uint64_t machine_cycle_budget = machine_cycle_budget_distribution(random_number_generator);
+        const uint64_t machine_cycle_limit = game_boy_emulator.get_elapsed_machine_cycles() + machine_cycle_budget;
+
+        // With no budget left, at least one instruction still runs so that resuming always makes progress
+        ASSERT_EQ(game_boy_emulator.run_for_cycles(machine_cycle_budget).reason, GameBoyEmulator::EmulationStopReason::MachineCycleBudgetExhausted);
+        do
+        {
+            reference_emulator.step_central_processing_unit_single_instruction();
+        } while (reference_emulator.get_elapsed_machine_cycles() < machine_cycle_limit);
+
+        const uint64_t machine_cycle = game_boy_emulator.get_elapsed_machine_cycles();
+        ASSERT_EQ(machine_cycle, reference_emulator.get_elapsed_machine_cycles()) << "budget " << machine_cycle_budget;
+        ASSERT_LE(machine_cycle, machine_cycle_limit + MAX_MACHINE_CYCLES_PAST_STOP);
+
+        const GameBoyEmulator::RegisterFile<std::endian::native> reference_register_file = reference_emulator.get_register_file();
+        const GameBoyEmulator::RegisterFile<std::endian::native> register_file = game_boy_emulator.get_register_file();
+        ASSERT_EQ(register_file.AF, reference_register_file.AF) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.BC, reference_register_file.BC) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.DE, reference_register_file.DE) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.HL, reference_register_file.HL) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.stack_pointer, reference_register_file.stack_pointer) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.program_counter, reference_register_file.program_counter) << "machine cycle " << machine_cycle;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P
+(
+    MachineCycleBudgetTests,
+    MachineCycleBudgetTest,
+    testing::Values(
+        TEST_DATA_DIRECTORY / "blargg-tests" / "gb-test-roms" / "cpu_instrs" / "individual" / "02-interrupts.gb",
+        TEST_DATA_DIRECTORY / "gbmicrotest" / "bin" / "int_timer_halt.gb",
+        MOONEYE_TEST_SUITE_DIRECTORY / "acceptance" / "halt_ime1_timing2-GS.gb",
+        MOONEYE_TEST_SUITE_DIRECTORY / "acceptance" / "ppu" / "stat_lyc_onoff.gb"),
+    [](auto info)
+    {
+        std::string test_rom_file_name = info.param.stem().string();
+        std::replace(test_rom_file_name.begin(), test_rom_file_name.end(), '-', '_');
+        return test_rom_file_name;
+    }
+);
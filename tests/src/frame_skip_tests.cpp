@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+#include "pixel_processing_unit.h"
+
+static std::vector<std::filesystem::path> get_test_rom_paths()
+{
+    const std::filesystem::path mooneye_test_suite_directory =
+        std::filesystem::path(PROJECT_ROOT) / "tests" / "data" / "mooneye-test-suite" / "mts-20240926-1737-443f6e1";
+    std::vector<std::filesystem::path> test_rom_paths = {
+        std::filesystem::path(PROJECT_ROOT) / "tests" / "data" / "blargg-tests" / "gb-test-roms" / "cpu_instrs" / "cpu_instrs.gb",
+        mooneye_test_suite_directory / "manual-only" / "sprite_priority.gb"};
+
+    const std::filesystem::path ppu_test_directory = mooneye_test_suite_directory / "acceptance" / "ppu";
+    if (std::filesystem::exists(ppu_test_directory))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(ppu_test_directory))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".gb")
+                test_rom_paths.push_back(entry.path());
+        }
+    }
+    std::sort(test_rom_paths.begin(), test_rom_paths.end());
+    return test_rom_paths;
+}
+
+// Skipping the output of frames must leave timing, interrupts and every register exactly as they are when each frame is drawn
+class FrameSkipTest : public testing::TestWithParam<std::filesystem::path>
+{
+protected:
+    static constexpr uint32_t FRAME_COUNT = 300;
+    static constexpr uint64_t MAX_MACHINE_CYCLES_PER_RUN =
+        (GameBoyEmulator::FINAL_SCANLINE_OF_FRAME + 1) * GameBoyEmulator::SCANLINE_DURATION_DOTS / GameBoyEmulator::DOTS_PER_MACHINE_CYCLE;
+    static constexpr size_t FRAME_BUFFER_SIZE = GameBoyEmulator::DISPLAY_WIDTH_PIXELS * GameBoyEmulator::DISPLAY_HEIGHT_PIXELS;
+
+    GameBoyEmulator::Emulator reference_emulator;
+    GameBoyEmulator::Emulator frame_skipping_emulator;
+    std::string error_message{};
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(std::filesystem::exists(GetParam())) << "ROM file not found: " << GetParam();
+        for (GameBoyEmulator::Emulator* game_boy_emulator : {&reference_emulator, &frame_skipping_emulator})
+        {
+            ASSERT_TRUE(game_boy_emulator->try_load_file_to_memory(GetParam(), GameBoyEmulator::FileType::GameROM, error_message)) << error_message;
+            game_boy_emulator->reset_state();
+        }
+    }
+
+    void expect_same_state_and_published_frames(uint8_t frame_skip_interval)
+    {
+        frame_skipping_emulator.set_frame_skip_interval(frame_skip_interval);
+        uint8_t last_published_frame_buffer_index = frame_skipping_emulator.get_published_frame_buffer_index_thread_safe();
+
+        for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+        {
+            const GameBoyEmulator::EmulationStopResult reference_stop_result = reference_emulator.run_until_frame(MAX_MACHINE_CYCLES_PER_RUN);
+            const GameBoyEmulator::EmulationStopResult stop_result = frame_skipping_emulator.run_until_frame(MAX_MACHINE_CYCLES_PER_RUN);
+            ASSERT_EQ(stop_result.reason, reference_stop_result.reason) << "frame " << frame;
+            ASSERT_EQ(frame_skipping_emulator.get_elapsed_machine_cycles(), reference_emulator.get_elapsed_machine_cycles()) << "frame " << frame;
+
+            const GameBoyEmulator::RegisterFile<std::endian::native> reference_register_file = reference_emulator.get_register_file();
+            const GameBoyEmulator::RegisterFile<std::endian::native> register_file = frame_skipping_emulator.get_register_file();
+            ASSERT_EQ(register_file.AF, reference_register_file.AF) << "frame " << frame;
+            ASSERT_EQ(register_file.BC, reference_register_file.BC) << "frame " << frame;
+            ASSERT_EQ(register_file.DE, reference_register_file.DE) << "frame " << frame;
+            ASSERT_EQ(register_file.HL, reference_register_file.HL) << "frame " << frame;
+            ASSERT_EQ(register_file.stack_pointer, reference_register_file.stack_pointer) << "frame " << frame;
+            ASSERT_EQ(register_file.program_counter, reference_register_file.program_counter) << "frame " << frame;
+
+            // A frame drawn despite skipping has to match the frame drawn without it
+            const uint8_t published_frame_buffer_index = frame_skipping_emulator.get_published_frame_buffer_index_thread_safe();
+            if (published_frame_buffer_index != last_published_frame_buffer_index)
+            {
+                const uint8_t reference_published_frame_buffer_index = reference_emulator.get_published_frame_buffer_index_thread_safe();
+                ASSERT_EQ(std::memcmp(
+                    frame_skipping_emulator.get_pixel_frame_buffer(published_frame_buffer_index).get(),
+                    reference_emulator.get_pixel_frame_buffer(reference_published_frame_buffer_index).get(),
+                    FRAME_BUFFER_SIZE), 0) << "frame " << frame;
+                last_published_frame_buffer_index = published_frame_buffer_index;
+            }
+        }
+
+        for (uint32_t address = 0x8000; address <= 0xFFFF; address++)
+        {
+            // Cartridge RAM belongs to the cartridge rather than the frame, and input/output registers can have side effects on read
+            if ((address >= 0xA000 && address < 0xC000) || (address >= 0xFF00 && address < 0xFF80))
+                continue;
+            ASSERT_EQ(frame_skipping_emulator.read_byte_from_memory(static_cast<uint16_t>(address)), reference_emulator.read_byte_from_memory(static_cast<uint16_t>(address)))
+                << "address 0x" << std::hex << address;
+        }
+    }
+};
+
+TEST_P(FrameSkipTest, SkippingEveryOtherFrameKeepsTheSameState)
+{
+    expect_same_state_and_published_frames(2);
+}
+
+TEST_P(FrameSkipTest, SkippingThreeInFourFramesKeepsTheSameState)
+{
+    expect_same_state_and_published_frames(4);
+}
+
+INSTANTIATE_TEST_SUITE_P
+(
+    FrameSkipTests,
+    FrameSkipTest,
+    testing::ValuesIn(get_test_rom_paths()),
+    [](auto info)
+    {
+        std::string test_rom_file_name = info.param.stem().string();
+        std::replace(test_rom_file_name.begin(), test_rom_file_name.end(), '-', '_');
+        return test_rom_file_name;
+    }
+);
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "game_rom_image.h"
+#include "memory_bank_controllers.h"
+#include "temporary_directory_test.h"
+
+static std::vector<uint8_t> create_rom_only_game_rom(uint8_t fill_byte)
+{
+    std::vector<uint8_t> rom_bytes(0x8000, fill_byte);
+    std::copy(std::begin(GameBoyEmulator::EXPECTED_LOGO), std::end(GameBoyEmulator::EXPECTED_LOGO), rom_bytes.begin() + GameBoyEmulator::LOGO_START_POSITION);
+    rom_bytes[0x143] = 0x00;
+    rom_bytes[0x147] = 0x00;
+    rom_bytes[0x148] = 0x00;
+    rom_bytes[0x149] = 0x00;
+    return rom_bytes;
+}
+
+class GameRomImageRegistryTest : public TemporaryDirectoryTest
+{
+protected:
+    std::string error_message{};
+};
+
+TEST_F(GameRomImageRegistryTest, AcquiringTheSamePathTwiceReturnsTheSameImage)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    write_file(rom_path, create_rom_only_game_rom(0x00));
+
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> first_image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> second_image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    ASSERT_NE(first_image, nullptr) << error_message;
+    EXPECT_EQ(first_image, second_image);
+    EXPECT_EQ(first_image->get_bytes().size(), 0x8000u);
+    EXPECT_EQ(first_image->get_header().cartridge_type, 0x00);
+}
+
+TEST_F(GameRomImageRegistryTest, IdenticalContentUnderAnotherPathReturnsTheSameImage)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    const std::filesystem::path copied_rom_path = test_directory_path / "copy.gb";
+    write_file(rom_path, create_rom_only_game_rom(0x00));
+    write_file(copied_rom_path, create_rom_only_game_rom(0x00));
+
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> copied_image = GameBoyEmulator::GameRomImageRegistry::try_acquire(copied_rom_path, error_message);
+    ASSERT_NE(image, nullptr) << error_message;
+    EXPECT_EQ(image, copied_image);
+}
+
+TEST_F(GameRomImageRegistryTest, DifferentContentReturnsDifferentImages)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    const std::filesystem::path other_rom_path = test_directory_path / "other.gb";
+    write_file(rom_path, create_rom_only_game_rom(0x00));
+    write_file(other_rom_path, create_rom_only_game_rom(0x01));
+
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> other_image = GameBoyEmulator::GameRomImageRegistry::try_acquire(other_rom_path, error_message);
+    ASSERT_NE(image, nullptr) << error_message;
+    ASSERT_NE(other_image, nullptr) << error_message;
+    EXPECT_NE(image, other_image);
+    EXPECT_NE(image->get_content_hash(), other_image->get_content_hash());
+}
+
+TEST_F(GameRomImageRegistryTest, ChangedFileIsMappedAgain)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    write_file(rom_path, create_rom_only_game_rom(0x00));
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    ASSERT_NE(image, nullptr) << error_message;
+
+    // A new file under the same path, given a later write time so the change is seen even on coarse timestamps
+    const std::filesystem::path replacement_rom_path = test_directory_path / "replacement.gb";
+    write_file(replacement_rom_path, create_rom_only_game_rom(0x02));
+    std::filesystem::last_write_time(replacement_rom_path, std::filesystem::last_write_time(rom_path) + std::chrono::seconds(1));
+    std::filesystem::rename(replacement_rom_path, rom_path);
+
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> changed_image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    ASSERT_NE(changed_image, nullptr) << error_message;
+    EXPECT_NE(image, changed_image);
+    EXPECT_EQ(changed_image->get_bytes()[0], 0x02);
+    EXPECT_EQ(image->get_bytes()[0], 0x00);
+}
+
+TEST_F(GameRomImageRegistryTest, ResizedFileWithTheSameWriteTimeIsMappedAgain)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    write_file(rom_path, create_rom_only_game_rom(0x00));
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    ASSERT_NE(image, nullptr) << error_message;
+
+    std::vector<uint8_t> resized_rom_bytes = create_rom_only_game_rom(0x00);
+    resized_rom_bytes.resize(0x10000, 0x00);
+    resized_rom_bytes[0x147] = 0x01;
+    resized_rom_bytes[0x148] = 0x01;
+    const std::filesystem::path replacement_rom_path = test_directory_path / "replacement.gb";
+    write_file(replacement_rom_path, resized_rom_bytes);
+    std::filesystem::last_write_time(replacement_rom_path, std::filesystem::last_write_time(rom_path));
+    std::filesystem::rename(replacement_rom_path, rom_path);
+
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> resized_image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    ASSERT_NE(resized_image, nullptr) << error_message;
+    EXPECT_NE(image, resized_image);
+    EXPECT_EQ(resized_image->get_bytes().size(), 0x10000u);
+}
+
+TEST_F(GameRomImageRegistryTest, ReleasedImageIsNotReturnedAgain)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    write_file(rom_path, create_rom_only_game_rom(0x00));
+
+    std::weak_ptr<const GameBoyEmulator::GameRomImage> released_image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    EXPECT_TRUE(released_image.expired());
+
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    ASSERT_NE(image, nullptr) << error_message;
+    EXPECT_EQ(image->get_bytes().size(), 0x8000u);
+}
+
+TEST_F(GameRomImageRegistryTest, InvalidHeaderIsRejected)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    std::vector<uint8_t> rom_bytes = create_rom_only_game_rom(0x00);
+    rom_bytes[GameBoyEmulator::LOGO_START_POSITION] ^= 0xFF;
+    write_file(rom_path, rom_bytes);
+
+    EXPECT_EQ(GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message), nullptr);
+    EXPECT_FALSE(error_message.empty());
+}
+
+TEST_F(GameRomImageRegistryTest, MemoryBankController3WithTimerAndBatteryHeaderWithRamIsRejected)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    std::vector<uint8_t> rom_bytes = create_rom_only_game_rom(0x00);
+    rom_bytes[0x147] = GameBoyEmulator::MBC3_WITH_TIMER_AND_BATTERY_BYTE;
+    rom_bytes[0x149] = 0x02;
+    write_file(rom_path, rom_bytes);
+
+    EXPECT_EQ(GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message), nullptr);
+    EXPECT_FALSE(error_message.empty());
+}
+
+TEST_F(GameRomImageRegistryTest, MemoryBankController3WithTimerAndBatteryIsAcceptedWithoutRam)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    std::vector<uint8_t> rom_bytes = create_rom_only_game_rom(0x00);
+    rom_bytes[0x147] = GameBoyEmulator::MBC3_WITH_TIMER_AND_BATTERY_BYTE;
+    write_file(rom_path, rom_bytes);
+
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    ASSERT_NE(image, nullptr) << error_message;
+    EXPECT_EQ(image->get_header().cartridge_ram_size, 0u);
+}
+
+TEST_F(GameRomImageRegistryTest, MemoryBankController3WithTimerAndRamAndBatteryIsAcceptedWithRam)
+{
+    const std::filesystem::path rom_path = test_directory_path / "game.gb";
+    std::vector<uint8_t> rom_bytes = create_rom_only_game_rom(0x00);
+    rom_bytes[0x147] = GameBoyEmulator::MBC3_WITH_TIMER_AND_RAM_AND_BATTERY_BYTE;
+    rom_bytes[0x149] = 0x03;
+    write_file(rom_path, rom_bytes);
+
+    const std::shared_ptr<const GameBoyEmulator::GameRomImage> image = GameBoyEmulator::GameRomImageRegistry::try_acquire(rom_path, error_message);
+    ASSERT_NE(image, nullptr) << error_message;
+    EXPECT_EQ(image->get_header().cartridge_ram_size, 0x8000u);
+}
+
+TEST_F(GameRomImageRegistryTest, MissingFileIsRejected)
+{
+    EXPECT_EQ(GameBoyEmulator::GameRomImageRegistry::try_acquire(test_directory_path / "missing.gb", error_message), nullptr);
+    EXPECT_FALSE(error_message.empty());
+}
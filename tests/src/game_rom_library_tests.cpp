@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "emulator.h"
+#include "game_rom_image.h"
+#include "game_rom_library.h"
+#include "temporary_directory_test.h"
+
+static std::vector<uint8_t> create_game_rom(const std::string& title)
+{
+    std::vector<uint8_t> rom_bytes(0x8000);
+    std::copy(std::begin(GameBoyEmulator::EXPECTED_LOGO), std::end(GameBoyEmulator::EXPECTED_LOGO), rom_bytes.begin() + GameBoyEmulator::LOGO_START_POSITION);
+    std::copy(title.begin(), title.end(), rom_bytes.begin() + GameBoyEmulator::ROM_TITLE_START);
+    return rom_bytes;
+}
+
+static std::vector<std::string> get_entry_titles(const GameBoyEmulator::GameRomLibrary& game_rom_library)
+{
+    std::vector<std::string> entry_titles;
+    for (const GameBoyEmulator::GameRomLibraryEntry& entry : *game_rom_library.get_entries())
+    {
+        entry_titles.push_back(entry.title);
+    }
+    return entry_titles;
+}
+
+class GameRomLibraryTest : public TemporaryDirectoryTest
+{
+protected:
+    std::filesystem::path rom_directory_path{};
+    std::filesystem::path cache_file_path{};
+    std::string error_message{};
+
+    void SetUp() override
+    {
+        TemporaryDirectoryTest::SetUp();
+        rom_directory_path = test_directory_path / "roms";
+        std::filesystem::create_directories(rom_directory_path / "nested");
+        cache_file_path = test_directory_path / "rom_library.cache";
+    }
+
+    static void scan_and_wait(GameBoyEmulator::GameRomLibrary& game_rom_library)
+    {
+        game_rom_library.start_scan();
+        while (game_rom_library.is_scan_in_progress())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+TEST_F(GameRomLibraryTest, ScanFindsGameRomsInNestedDirectories)
+{
+    write_file(rom_directory_path / "beta.gb", create_game_rom("BETA"));
+    write_file(rom_directory_path / "nested" / "alpha.gbc", create_game_rom("ALPHA"));
+    write_file(rom_directory_path / "notes.txt", create_game_rom("NOTES"));
+
+    GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+    game_rom_library.add_directory(rom_directory_path);
+    scan_and_wait(game_rom_library);
+
+    EXPECT_EQ(get_entry_titles(game_rom_library), (std::vector<std::string>{"ALPHA", "BETA"}));
+    const GameBoyEmulator::GameRomLibraryEntry& entry = game_rom_library.get_entries()->front();
+    EXPECT_TRUE(entry.is_logo_valid);
+    EXPECT_TRUE(entry.is_loadable) << entry.load_error_message;
+    EXPECT_EQ(entry.file_size, 0x8000u);
+}
+
+TEST_F(GameRomLibraryTest, CacheRoundTripsEntriesAndDirectories)
+{
+    write_file(rom_directory_path / "alpha.gb", create_game_rom("ALPHA"));
+    std::vector<uint8_t> invalid_rom_bytes = create_game_rom("BROKEN");
+    invalid_rom_bytes[GameBoyEmulator::LOGO_START_POSITION] ^= 0xFF;
+    write_file(rom_directory_path / "broken.gb", invalid_rom_bytes);
+    {
+        GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+        game_rom_library.add_directory(rom_directory_path);
+        scan_and_wait(game_rom_library);
+    }
+
+    GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+    ASSERT_TRUE(game_rom_library.try_load_cache(error_message)) << error_message;
+    EXPECT_EQ(game_rom_library.get_directories(), (std::vector<std::filesystem::path>{rom_directory_path}));
+    ASSERT_EQ(get_entry_titles(game_rom_library), (std::vector<std::string>{"ALPHA", "BROKEN"}));
+
+    const GameBoyEmulator::GameRomLibraryEntry& alpha_entry = game_rom_library.get_entries()->at(0);
+    const GameBoyEmulator::GameRomLibraryEntry& broken_entry = game_rom_library.get_entries()->at(1);
+    EXPECT_EQ(alpha_entry.file_path, rom_directory_path / "alpha.gb");
+    EXPECT_EQ(alpha_entry.file_size, 0x8000u);
+    EXPECT_TRUE(alpha_entry.is_logo_valid);
+    EXPECT_TRUE(alpha_entry.is_loadable);
+    EXPECT_FALSE(broken_entry.is_logo_valid);
+    EXPECT_FALSE(broken_entry.is_loadable);
+    EXPECT_FALSE(broken_entry.load_error_message.empty());
+}
+
+TEST_F(GameRomLibraryTest, MissingCacheIsAnEmptyLibrary)
+{
+    GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+    EXPECT_TRUE(game_rom_library.try_load_cache(error_message));
+    EXPECT_TRUE(game_rom_library.get_entries()->empty());
+}
+
+TEST_F(GameRomLibraryTest, TruncatedCacheIsRejected)
+{
+    write_file(rom_directory_path / "alpha.gb", create_game_rom("ALPHA"));
+    write_file(rom_directory_path / "beta.gb", create_game_rom("BETA"));
+    {
+        GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+        game_rom_library.add_directory(rom_directory_path);
+        scan_and_wait(game_rom_library);
+    }
+    const uintmax_t cache_file_size = std::filesystem::file_size(cache_file_path);
+    std::filesystem::resize_file(cache_file_path, cache_file_size - 1);
+
+    GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+    EXPECT_FALSE(game_rom_library.try_load_cache(error_message));
+    EXPECT_FALSE(error_message.empty());
+    EXPECT_TRUE(game_rom_library.get_entries()->empty());
+    EXPECT_TRUE(game_rom_library.get_directories().empty());
+}
+
+TEST_F(GameRomLibraryTest, CacheWithTheWrongMagicIsRejected)
+{
+    write_file(cache_file_path, create_game_rom("NOT A CACHE"));
+    GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+    EXPECT_FALSE(game_rom_library.try_load_cache(error_message));
+    EXPECT_TRUE(game_rom_library.get_entries()->empty());
+}
+
+TEST_F(GameRomLibraryTest, RescanOnlyReadsChangedFiles)
+{
+    const std::filesystem::path unchanged_rom_path = rom_directory_path / "alpha.gb";
+    const std::filesystem::path changed_rom_path = rom_directory_path / "beta.gb";
+    const std::filesystem::path removed_rom_path = rom_directory_path / "gamma.gb";
+    write_file(unchanged_rom_path, create_game_rom("ALPHA"));
+    write_file(changed_rom_path, create_game_rom("BETA"));
+    write_file(removed_rom_path, create_game_rom("GAMMA"));
+
+    GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+    game_rom_library.add_directory(rom_directory_path);
+    scan_and_wait(game_rom_library);
+    EXPECT_EQ(game_rom_library.get_file_count_to_scan(), 3u);
+
+    // Rewritten with the same size and write time, which a rescan has no way to notice without reading the file
+    const std::filesystem::file_time_type unchanged_last_write_time = std::filesystem::last_write_time(unchanged_rom_path);
+    write_file(unchanged_rom_path, create_game_rom("ALPHA2"));
+    std::filesystem::last_write_time(unchanged_rom_path, unchanged_last_write_time);
+
+    write_file(changed_rom_path, create_game_rom("BETA2"));
+    std::filesystem::last_write_time(changed_rom_path, std::filesystem::last_write_time(changed_rom_path) + std::chrono::seconds(1));
+    std::filesystem::remove(removed_rom_path);
+    write_file(rom_directory_path / "nested" / "delta.gb", create_game_rom("DELTA"));
+
+    scan_and_wait(game_rom_library);
+    EXPECT_EQ(game_rom_library.get_file_count_to_scan(), 2u);
+    EXPECT_EQ(get_entry_titles(game_rom_library), (std::vector<std::string>{"ALPHA", "BETA2", "DELTA"}));
+}
+
+TEST_F(GameRomLibraryTest, RescanStartsFromTheLoadedCache)
+{
+    write_file(rom_directory_path / "alpha.gb", create_game_rom("ALPHA"));
+    {
+        GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+        game_rom_library.add_directory(rom_directory_path);
+        scan_and_wait(game_rom_library);
+    }
+
+    GameBoyEmulator::GameRomLibrary game_rom_library{cache_file_path};
+    ASSERT_TRUE(game_rom_library.try_load_cache(error_message)) << error_message;
+    scan_and_wait(game_rom_library);
+    EXPECT_EQ(game_rom_library.get_file_count_to_scan(), 0u);
+    EXPECT_EQ(get_entry_titles(game_rom_library), (std::vector<std::string>{"ALPHA"}));
+}
+
+TEST_F(GameRomLibraryTest, OversizedFileIsListedAsUnloadableWithoutBeingRead)
+{
+    const std::filesystem::path oversized_rom_path = rom_directory_path / "oversized.gb";
+    write_file(oversized_rom_path, create_game_rom("OVERSIZED"));
+    std::filesystem::resize_file(oversized_rom_path, 0x800000 + 1);
+
+    GameBoyEmulator::GameRomLibraryEntry entry{};
+    ASSERT_TRUE(GameBoyEmulator::GameRomLibrary::try_read_entry(oversized_rom_path, entry));
+    EXPECT_EQ(entry.file_size, 0x800000u + 1);
+    EXPECT_TRUE(entry.title.empty());
+    EXPECT_FALSE(entry.is_loadable);
+    EXPECT_FALSE(entry.load_error_message.empty());
+}
+
+TEST_F(GameRomLibraryTest, FileTooSmallForAHeaderIsSkipped)
+{
+    const std::filesystem::path small_file_path = rom_directory_path / "small.gb";
+    write_file(small_file_path, std::vector<uint8_t>(0x100));
+    GameBoyEmulator::GameRomLibraryEntry entry{};
+    EXPECT_FALSE(GameBoyEmulator::GameRomLibrary::try_read_entry(small_file_path, entry));
+}
@@ -199,12 +199,16 @@ TEST_P(GbmicroTest, TestRom)
     const std::filesystem::path test_rom_path = GetParam();
     SCOPED_TRACE("Test ROM: " + test_rom_path.string());
 
-    constexpr size_t MAX_INSTRUCTIONS_BEFORE_TIMEOUT = 1'000'000;
+    constexpr uint64_t MAX_MACHINE_CYCLES_BEFORE_TIMEOUT = 4'000'000;
     bool did_test_succeed = false;
 
-    for (size_t _ = 0; _ < MAX_INSTRUCTIONS_BEFORE_TIMEOUT; _++)
+    GameBoyEmulator::EmulationStopConditions stop_conditions{};
+    stop_conditions.watched_write_address = 0xFF82;
+
+    while (game_boy_emulator.get_elapsed_machine_cycles() < MAX_MACHINE_CYCLES_BEFORE_TIMEOUT)
     {
-        game_boy_emulator.step_central_processing_unit_single_instruction();
+        stop_conditions.machine_cycle_budget = MAX_MACHINE_CYCLES_BEFORE_TIMEOUT - game_boy_emulator.get_elapsed_machine_cycles();
+        game_boy_emulator.run_until_event(stop_conditions);
 
         const uint8_t test_result_byte = game_boy_emulator.read_byte_from_memory(0xFF80);
         const uint8_t test_expected_result_byte = game_boy_emulator.read_byte_from_memory(0xFF81);
@@ -220,7 +224,7 @@ TEST_P(GbmicroTest, TestRom)
             break;
         }
     }
-    ASSERT_TRUE(did_test_succeed) << "Test didn't reach a finished state within " << MAX_INSTRUCTIONS_BEFORE_TIMEOUT << " instructions";
+    ASSERT_TRUE(did_test_succeed) << "Test didn't reach a finished state within " << MAX_MACHINE_CYCLES_BEFORE_TIMEOUT << " machine cycles";
 }
 
 INSTANTIATE_TEST_SUITE_P
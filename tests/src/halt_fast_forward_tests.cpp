@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+#include "pixel_processing_unit.h"
+
+static std::vector<std::filesystem::path> get_test_rom_paths()
+{
+    const std::filesystem::path test_data_directory = std::filesystem::path(PROJECT_ROOT) / "tests" / "data";
+    const std::filesystem::path gbmicrotest_directory = test_data_directory / "gbmicrotest" / "bin";
+    const std::filesystem::path mooneye_test_suite_directory = test_data_directory / "mooneye-test-suite" / "mts-20240926-1737-443f6e1";
+
+    // These halt until a timer, LCD STAT or VBlank interrupt, with IME set and cleared, or start an OAM DMA while halted
+    std::vector<std::filesystem::path> test_rom_paths = {
+        test_data_directory / "blargg-tests" / "gb-test-roms" / "cpu_instrs" / "individual" / "02-interrupts.gb",
+        mooneye_test_suite_directory / "madness" / "mgb_oam_dma_halt_sprites.gb",
+        mooneye_test_suite_directory / "misc" / "ppu" / "vblank_stat_intr-C.gb"};
+    for (const char* test_rom_file_name : {
+        "001-vram_unlocked.gb", "007-lcd_on_stat.gb", "800-ppu-latch-scx.gb", "801-ppu-latch-scy.gb", "802-ppu-latch-tileselect.gb",
+        "803-ppu-latch-bgdisplay.gb", "int_hblank_halt_bug_a.gb", "int_timer_halt.gb", "int_timer_halt_div_a.gb", "int_timer_halt_div_b.gb",
+        "int_vblank2_halt.gb", "lcdon_halt_to_vblank_int_a.gb", "lcdon_halt_to_vblank_int_b.gb", "mode2_stat_int_to_oam_unlock.gb",
+        "vblank2_int_halt_a.gb", "vblank2_int_halt_b.gb", "vblank_int_halt_a.gb", "vblank_int_halt_b.gb"})
+    {
+        test_rom_paths.push_back(gbmicrotest_directory / test_rom_file_name);
+    }
+    for (const char* test_rom_file_name : {
+        "di_timing-GS.gb", "halt_ime0_ei.gb", "halt_ime0_nointr_timing.gb", "halt_ime1_timing.gb", "halt_ime1_timing2-GS.gb"})
+    {
+        test_rom_paths.push_back(mooneye_test_suite_directory / "acceptance" / test_rom_file_name);
+    }
+    for (const char* test_rom_file_name : {
+        "hblank_ly_scx_timing-GS.gb", "intr_1_2_timing-GS.gb", "intr_2_0_timing.gb", "intr_2_mode0_timing.gb",
+        "intr_2_mode0_timing_sprites.gb", "intr_2_mode3_timing.gb", "intr_2_oam_ok_timing.gb", "vblank_stat_intr-GS.gb"})
+    {
+        test_rom_paths.push_back(mooneye_test_suite_directory / "acceptance" / "ppu" / test_rom_file_name);
+    }
+    std::sort(test_rom_paths.begin(), test_rom_paths.end());
+    return test_rom_paths;
+}
+
+// Fast-forwarding a halt must end on the same machine cycle, with the same registers, interrupt flags and timer, as stepping each
+// halted machine cycle on its own
+class HaltFastForwardTest : public testing::TestWithParam<std::filesystem::path>
+{
+protected:
+    static constexpr uint32_t FRAME_COUNT = 120;
+    static constexpr uint64_t MACHINE_CYCLES_PER_FRAME =
+        (GameBoyEmulator::FINAL_SCANLINE_OF_FRAME + 1) * GameBoyEmulator::SCANLINE_DURATION_DOTS / GameBoyEmulator::DOTS_PER_MACHINE_CYCLE;
+
+    GameBoyEmulator::Emulator reference_emulator;
+    GameBoyEmulator::Emulator fast_forwarding_emulator;
+    std::string error_message{};
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(std::filesystem::exists(GetParam())) << "ROM file not found: " << GetParam();
+        for (GameBoyEmulator::Emulator* game_boy_emulator : {&reference_emulator, &fast_forwarding_emulator})
+        {
+            ASSERT_TRUE(game_boy_emulator->try_load_file_to_memory(GetParam(), GameBoyEmulator::FileType::GameROM, error_message)) << error_message;
+            game_boy_emulator->reset_state();
+        }
+        reference_emulator.set_halt_fast_forward_enabled(false);
+    }
+};
+
+// A fast-forwarded halt is a single step, so the reference steps until it reaches the same machine cycle before each comparison
+TEST_P(HaltFastForwardTest, MatchesSteppingEachHaltedMachineCycle)
+{
+    while (fast_forwarding_emulator.get_elapsed_machine_cycles() < FRAME_COUNT * MACHINE_CYCLES_PER_FRAME)
+    {
+        fast_forwarding_emulator.step_central_processing_unit_single_instruction();
+        const uint64_t machine_cycle = fast_forwarding_emulator.get_elapsed_machine_cycles();
+        while (reference_emulator.get_elapsed_machine_cycles() < machine_cycle)
+        {
+            reference_emulator.step_central_processing_unit_single_instruction();
+        }
+        ASSERT_EQ(reference_emulator.get_elapsed_machine_cycles(), machine_cycle);
+
+        const GameBoyEmulator::RegisterFile<std::endian::native> reference_register_file = reference_emulator.get_register_file();
+        const GameBoyEmulator::RegisterFile<std::endian::native> register_file = fast_forwarding_emulator.get_register_file();
+        ASSERT_EQ(register_file.AF, reference_register_file.AF) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.BC, reference_register_file.BC) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.DE, reference_register_file.DE) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.HL, reference_register_file.HL) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.stack_pointer, reference_register_file.stack_pointer) << "machine cycle " << machine_cycle;
+        ASSERT_EQ(register_file.program_counter, reference_register_file.program_counter) << "machine cycle " << machine_cycle;
+
+        // IF, DIV and TIMA
+        for (const uint16_t address : {0xFF0F, 0xFF04, 0xFF05})
+        {
+            ASSERT_EQ(fast_forwarding_emulator.read_byte_from_memory(address), reference_emulator.read_byte_from_memory(address))
+                << "address 0x" << std::hex << address << std::dec << " at machine cycle " << machine_cycle;
+        }
+    }
+    EXPECT_GT(fast_forwarding_emulator.get_emulation_statistics().fast_forwarded_halted_machine_cycles, 0u);
+    EXPECT_EQ(reference_emulator.get_emulation_statistics().fast_forwarded_halted_machine_cycles, 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P
+(
+    HaltFastForwardTests,
+    HaltFastForwardTest,
+    testing::ValuesIn(get_test_rom_paths()),
+    [](auto info)
+    {
+        std::string test_rom_file_name = info.param.stem().string();
+        std::replace(test_rom_file_name.begin(), test_rom_file_name.end(), '-', '_');
+        return test_rom_file_name;
+    }
+);
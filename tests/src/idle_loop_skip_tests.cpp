@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+#include "pixel_processing_unit.h"
+
+static std::filesystem::path get_mooneye_test_suite_directory()
+{
+    return std::filesystem::path(PROJECT_ROOT) / "tests" / "data" / "mooneye-test-suite" / "mts-20240926-1737-443f6e1";
+}
+
+static std::vector<std::filesystem::path> get_test_rom_paths()
+{
+    const std::filesystem::path test_data_directory = std::filesystem::path(PROJECT_ROOT) / "tests" / "data";
+    const std::filesystem::path gbmicrotest_directory = test_data_directory / "gbmicrotest" / "bin";
+    const std::filesystem::path mooneye_test_suite_directory = get_mooneye_test_suite_directory();
+
+    // These poll LY or STAT, and 04-sweep polls the sound control register, which is never skipped in bulk
+    std::vector<std::filesystem::path> test_rom_paths = {
+        test_data_directory / "blargg-tests" / "gb-test-roms" / "dmg_sound" / "rom_singles" / "04-sweep.gb",
+        test_data_directory / "blargg-tests" / "gb-test-roms" / "oam_bug" / "rom_singles" / "1-lcd_sync.gb",
+        test_data_directory / "blargg-tests" / "gb-test-roms" / "oam_bug" / "rom_singles" / "4-scanline_timing.gb",
+        mooneye_test_suite_directory / "manual-only" / "sprite_priority.gb"};
+    for (const char* test_rom_file_name : {
+        "001-vram_unlocked.gb", "400-dma.gb", "lcdon_write_timing.gb", "mode2_stat_int_to_oam_unlock.gb", "oam_write_l0_a.gb",
+        "vram_write_l1_a.gb"})
+    {
+        test_rom_paths.push_back(gbmicrotest_directory / test_rom_file_name);
+    }
+    for (const char* test_rom_file_name : {"call_timing.gb", "di_timing-GS.gb", "oam_dma_timing.gb"})
+    {
+        test_rom_paths.push_back(mooneye_test_suite_directory / "acceptance" / test_rom_file_name);
+    }
+    for (const char* test_rom_file_name : {
+        "hblank_ly_scx_timing-GS.gb", "intr_2_0_timing.gb", "intr_2_mode0_timing_sprites.gb", "stat_irq_blocking.gb",
+        "stat_lyc_onoff.gb", "vblank_stat_intr-GS.gb"})
+    {
+        test_rom_paths.push_back(mooneye_test_suite_directory / "acceptance" / "ppu" / test_rom_file_name);
+    }
+    std::sort(test_rom_paths.begin(), test_rom_paths.end());
+    return test_rom_paths;
+}
+
+// Polls DIV and TIMA with one and two ALU operations, while cycling through the four TIMA clocks and switching IME and the timer
+// interrupt on and off every four rounds. The header is taken from a mooneye test ROM so the cartridge checks pass
+static std::vector<uint8_t> create_timer_polling_game_rom()
+{
+    std::ifstream header_rom_file(get_mooneye_test_suite_directory() / "acceptance" / "ppu" / "stat_lyc_onoff.gb", std::ios::binary);
+    std::vector<uint8_t> rom_bytes{std::istreambuf_iterator<char>(header_rom_file), std::istreambuf_iterator<char>()};
+    rom_bytes.resize(0x8000);
+    std::fill(rom_bytes.begin(), rom_bytes.begin() + 0x100, 0x00);
+    std::fill(rom_bytes.begin() + 0x150, rom_bytes.end(), 0x00);
+
+    rom_bytes[0x50] = 0xD9; // Timer interrupt handler: reti
+
+    const uint8_t entry_point[] = {
+        0x00,              // nop
+        0xC3, 0x50, 0x01}; // jp 0x0150
+    std::copy(std::begin(entry_point), std::end(entry_point), rom_bytes.begin() + 0x100);
+
+    const uint8_t program[] = {
+        0xF3,       // 0x0150: di
+        0xAF,       //         xor a
+        0xE0, 0xFF, //         ldh (IE), a
+        0x3E, 0x05, //         ld a, 0x05
+        0xE0, 0x07, //         ldh (TAC), a
+        0x06, 0x00, //         ld b, 0
+        0xF0, 0x04, // 0x015A: ldh a, (DIV)
+        0xE6, 0x1F, //         and 0x1F
+        0x20, 0xFA, //         jr nz, 0x015A
+        0xF0, 0x05, // 0x0160: ldh a, (TIMA)
+        0xFE, 0xE0, //         cp 0xE0
+        0x38, 0xFA, //         jr c, 0x0160
+        0xF0, 0x04, // 0x0166: ldh a, (DIV)
+        0xEE, 0x55, //         xor 0x55
+        0xE6, 0x03, //         and 0x03
+        0x20, 0xF8, //         jr nz, 0x0166
+        0x04,       //         inc b
+        0x78,       //         ld a, b
+        0xE6, 0x03, //         and 0x03
+        0xF6, 0x04, //         or 0x04
+        0xE0, 0x07, //         ldh (TAC), a
+        0x78,       //         ld a, b
+        0xE6, 0x04, //         and 0x04
+        0xE0, 0xFF, //         ldh (IE), a
+        0x28, 0x03, //         jr z, 0x0180
+        0xFB,       //         ei
+        0x18, 0xDA, //         jr 0x015A
+        0xF3,       // 0x0180: di
+        0x18, 0xD7};//         jr 0x015A
+    std::copy(std::begin(program), std::end(program), rom_bytes.begin() + 0x150);
+    return rom_bytes;
+}
+
+// Skipping a polling loop must end on the same machine cycle, with the same registers, as running each of its instructions
+class IdleLoopSkipTest : public testing::Test
+{
+protected:
+    static constexpr uint32_t FRAME_COUNT = 60;
+    static constexpr uint64_t MACHINE_CYCLES_PER_FRAME =
+        (GameBoyEmulator::FINAL_SCANLINE_OF_FRAME + 1) * GameBoyEmulator::SCANLINE_DURATION_DOTS / GameBoyEmulator::DOTS_PER_MACHINE_CYCLE;
+
+    GameBoyEmulator::Emulator reference_emulator;
+    GameBoyEmulator::Emulator idle_loop_skipping_emulator;
+    std::string error_message{};
+
+    // A skipped loop is a single step, so the reference steps until it reaches the same machine cycle before each comparison
+    void expect_same_state_at_every_step(const std::filesystem::path& rom_path)
+    {
+        ASSERT_TRUE(std::filesystem::exists(rom_path)) << "ROM file not found: " << rom_path;
+        for (GameBoyEmulator::Emulator* game_boy_emulator : {&reference_emulator, &idle_loop_skipping_emulator})
+        {
+            ASSERT_TRUE(game_boy_emulator->try_load_file_to_memory(rom_path, GameBoyEmulator::FileType::GameROM, error_message)) << error_message;
+            game_boy_emulator->reset_state();
+            // A translated block is also a single step, and could run past the instruction boundary where a skip ends
+            game_boy_emulator->set_dynamic_recompilation_enabled(false);
+        }
+        reference_emulator.set_idle_loop_skip_enabled(false);
+
+        while (idle_loop_skipping_emulator.get_elapsed_machine_cycles() < FRAME_COUNT * MACHINE_CYCLES_PER_FRAME)
+        {
+            idle_loop_skipping_emulator.step_central_processing_unit_single_instruction();
+            const uint64_t machine_cycle = idle_loop_skipping_emulator.get_elapsed_machine_cycles();
+            while (reference_emulator.get_elapsed_machine_cycles() < machine_cycle)
+            {
+                reference_emulator.step_central_processing_unit_single_instruction();
+            }
+            ASSERT_EQ(reference_emulator.get_elapsed_machine_cycles(), machine_cycle);
+
+            const GameBoyEmulator::RegisterFile<std::endian::native> reference_register_file = reference_emulator.get_register_file();
+            const GameBoyEmulator::RegisterFile<std::endian::native> register_file = idle_loop_skipping_emulator.get_register_file();
+            ASSERT_EQ(register_file.AF, reference_register_file.AF) << "machine cycle " << machine_cycle;
+            ASSERT_EQ(register_file.BC, reference_register_file.BC) << "machine cycle " << machine_cycle;
+            ASSERT_EQ(register_file.DE, reference_register_file.DE) << "machine cycle " << machine_cycle;
+            ASSERT_EQ(register_file.HL, reference_register_file.HL) << "machine cycle " << machine_cycle;
+            ASSERT_EQ(register_file.stack_pointer, reference_register_file.stack_pointer) << "machine cycle " << machine_cycle;
+            ASSERT_EQ(register_file.program_counter, reference_register_file.program_counter) << "machine cycle " << machine_cycle;
+
+            // DIV, TIMA, IF, STAT and LY
+            for (const uint16_t address : {0xFF04, 0xFF05, 0xFF0F, 0xFF41, 0xFF44})
+            {
+                ASSERT_EQ(idle_loop_skipping_emulator.read_byte_from_memory(address), reference_emulator.read_byte_from_memory(address))
+                    << "address 0x" << std::hex << address << std::dec << " at machine cycle " << machine_cycle;
+            }
+        }
+        EXPECT_GT(idle_loop_skipping_emulator.get_emulation_statistics().skipped_idle_loop_machine_cycles, 0u);
+        EXPECT_EQ(reference_emulator.get_emulation_statistics().skipped_idle_loop_machine_cycles, 0u);
+    }
+};
+
+TEST_F(IdleLoopSkipTest, TimerPollingMatchesRunningEachInstruction)
+{
+    const std::filesystem::path rom_path = std::filesystem::path(testing::TempDir()) / "idle_loop_skip_timer_polling.gb";
+    const std::vector<uint8_t> rom_bytes = create_timer_polling_game_rom();
+    std::ofstream(rom_path, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char*>(rom_bytes.data()), rom_bytes.size());
+    expect_same_state_at_every_step(rom_path);
+    std::filesystem::remove(rom_path);
+}
+
+class IdleLoopSkipRomTest : public IdleLoopSkipTest, public testing::WithParamInterface<std::filesystem::path>
+{
+};
+
+TEST_P(IdleLoopSkipRomTest, MatchesRunningEachInstruction)
+{
+    expect_same_state_at_every_step(GetParam());
+}
+
+INSTANTIATE_TEST_SUITE_P
+(
+    IdleLoopSkipTests,
+    IdleLoopSkipRomTest,
+    testing::ValuesIn(get_test_rom_paths()),
+    [](auto info)
+    {
+        std::string test_rom_file_name = info.param.stem().string();
+        std::replace(test_rom_file_name.begin(), test_rom_file_name.end(), '-', '_');
+        return test_rom_file_name;
+    }
+);
@@ -0,0 +1,115 @@
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "pixel_kernels.h"
+
+static constexpr size_t SCANLINE_PIXEL_COUNT = 160;
+static constexpr size_t TESTED_PIXEL_COUNTS[] = {1, 7, 8, 15, 16, 31, 32, 33, 100, SCANLINE_PIXEL_COUNT};
+
+class PixelKernelsTest : public testing::TestWithParam<GameBoyEmulator::PixelKernelInstructionSet>
+{
+protected:
+    std::mt19937 random_number_generator{0x6B};
+    const GameBoyEmulator::PixelKernels& scalar_pixel_kernels = GameBoyEmulator::get_pixel_kernels(GameBoyEmulator::PixelKernelInstructionSet::Scalar);
+    const GameBoyEmulator::PixelKernels* tested_pixel_kernels{};
+
+    void SetUp() override
+    {
+        if (!GameBoyEmulator::is_pixel_kernel_instruction_set_supported(GetParam()))
+        {
+            GTEST_SKIP() << "Instruction set is not supported by this host";
+        }
+        tested_pixel_kernels = &GameBoyEmulator::get_pixel_kernels(GetParam());
+        ASSERT_EQ(tested_pixel_kernels->instruction_set, GetParam());
+    }
+
+    uint8_t get_random_byte()
+    {
+        return static_cast<uint8_t>(random_number_generator());
+    }
+
+    std::vector<uint8_t> get_random_bytes(size_t count, uint8_t mask)
+    {
+        std::vector<uint8_t> random_bytes(count);
+        for (uint8_t& random_byte : random_bytes)
+        {
+            random_byte = get_random_byte() & mask;
+        }
+        return random_bytes;
+    }
+};
+
+TEST_P(PixelKernelsTest, DecodeTileRowMatchesScalar)
+{
+    for (uint32_t tile_row = 0; tile_row <= 0xFFFF; tile_row++)
+    {
+        std::array<uint8_t, 16> expected_decoded_tile_row{};
+        std::array<uint8_t, 16> decoded_tile_row{};
+        scalar_pixel_kernels.decode_tile_row(static_cast<uint8_t>(tile_row), static_cast<uint8_t>(tile_row >> 8), expected_decoded_tile_row.data());
+        tested_pixel_kernels->decode_tile_row(static_cast<uint8_t>(tile_row), static_cast<uint8_t>(tile_row >> 8), decoded_tile_row.data());
+        ASSERT_EQ(decoded_tile_row, expected_decoded_tile_row) << "tile row 0x" << std::hex << tile_row;
+    }
+}
+
+TEST_P(PixelKernelsTest, ComposeScanlineMatchesScalar)
+{
+    for (uint8_t layer_enable_bits = 0; layer_enable_bits < 8; layer_enable_bits++)
+    {
+        for (const size_t pixel_count : TESTED_PIXEL_COUNTS)
+        {
+            for (uint8_t iteration = 0; iteration < 16; iteration++)
+            {
+                const std::vector<uint8_t> background_colour_indices = get_random_bytes(pixel_count, 0b11);
+                const std::vector<uint8_t> object_colour_indices = get_random_bytes(pixel_count, 0b11);
+                // Object flags only ever carry the palette and priority bits
+                const std::vector<uint8_t> object_flags = get_random_bytes(pixel_count, 0b10010000);
+
+                GameBoyEmulator::ScanlineLayers scanline_layers{};
+                scanline_layers.background_colour_indices = background_colour_indices.data();
+                scanline_layers.object_colour_indices = object_colour_indices.data();
+                scanline_layers.object_flags = object_flags.data();
+                scanline_layers.background_palette = get_random_byte();
+                scanline_layers.object_palette_0 = get_random_byte();
+                scanline_layers.object_palette_1 = get_random_byte();
+                scanline_layers.are_background_and_window_enabled = (layer_enable_bits & 0b001) != 0;
+                scanline_layers.is_object_display_enabled = (layer_enable_bits & 0b010) != 0;
+                scanline_layers.are_objects_selected = (layer_enable_bits & 0b100) != 0;
+
+                std::vector<uint8_t> expected_shades(pixel_count);
+                std::vector<uint8_t> shades(pixel_count);
+                scalar_pixel_kernels.compose_scanline(scanline_layers, expected_shades.data(), pixel_count);
+                tested_pixel_kernels->compose_scanline(scanline_layers, shades.data(), pixel_count);
+                ASSERT_EQ(shades, expected_shades) << "pixel count " << pixel_count << ", layer enable bits " << static_cast<int>(layer_enable_bits);
+            }
+        }
+    }
+}
+
+TEST_P(PixelKernelsTest, ConvertShadesToAbgrMatchesScalar)
+{
+    const uint32_t abgr_colour_palette[4] = {0xFFD0F8E0, 0xFF70C088, 0xFF566834, 0xFF201808};
+    for (const size_t pixel_count : TESTED_PIXEL_COUNTS)
+    {
+        const std::vector<uint8_t> shades = get_random_bytes(pixel_count, 0b11);
+        std::vector<uint32_t> expected_abgr_pixels(pixel_count);
+        std::vector<uint32_t> abgr_pixels(pixel_count);
+        scalar_pixel_kernels.convert_shades_to_abgr(shades.data(), abgr_colour_palette, expected_abgr_pixels.data(), pixel_count);
+        tested_pixel_kernels->convert_shades_to_abgr(shades.data(), abgr_colour_palette, abgr_pixels.data(), pixel_count);
+        ASSERT_EQ(abgr_pixels, expected_abgr_pixels) << "pixel count " << pixel_count;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P
+(
+    PixelKernelsTests,
+    PixelKernelsTest,
+    testing::Values(GameBoyEmulator::PixelKernelInstructionSet::SSE2, GameBoyEmulator::PixelKernelInstructionSet::AVX2),
+    [](auto info)
+    {
+        return (info.param == GameBoyEmulator::PixelKernelInstructionSet::SSE2) ? std::string("SSE2") : std::string("AVX2");
+    }
+);
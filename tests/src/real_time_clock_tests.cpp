@@ -0,0 +1,232 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "event_scheduler.h"
+#include "memory_bank_controllers.h"
+
+static constexpr uint64_t MACHINE_CYCLES_PER_SECOND = GameBoyEmulator::MBC3::MACHINE_CYCLES_PER_SECOND;
+static constexpr uint8_t DAY_HIGH_HALT_BIT_MASK = 0b01000000;
+static constexpr uint8_t DAY_HIGH_CARRY_BIT_MASK = 0b10000000;
+
+static int64_t get_unix_timestamp()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void write_little_endian_value(uint8_t* bytes, uint8_t byte_count, uint64_t value)
+{
+    for (uint8_t i = 0; i < byte_count; i++)
+    {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// Trailer with the given counters, saved the given number of seconds ago
+static std::array<uint8_t, GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_SIZE> create_real_time_clock_save_data(
+    const std::array<uint8_t, 5>& clock_register_values,
+    int64_t seconds_since_saved)
+{
+    std::array<uint8_t, GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_SIZE> save_data{};
+    for (uint8_t i = 0; i < clock_register_values.size(); i++)
+    {
+        write_little_endian_value(&save_data[4 * i], 4, clock_register_values[i]);
+        write_little_endian_value(&save_data[20 + 4 * i], 4, clock_register_values[i]);
+    }
+    write_little_endian_value(&save_data[40], 8, static_cast<uint64_t>(get_unix_timestamp() - seconds_since_saved));
+    return save_data;
+}
+
+class RealTimeClockTest : public testing::TestWithParam<GameBoyEmulator::RealTimeClockTimeSource>
+{
+protected:
+    const std::vector<uint8_t> rom = std::vector<uint8_t>(0x8000);
+    std::vector<uint8_t> ram = std::vector<uint8_t>(0x2000);
+    std::array<uint8_t, GameBoyEmulator::REAL_TIME_CLOCK_SAVE_DATA_SIZE> host_save_data{};
+    GameBoyEmulator::EventScheduler event_scheduler{};
+    std::unique_ptr<GameBoyEmulator::MBC3> mbc3{};
+
+    void SetUp() override
+    {
+        mbc3 = std::make_unique<GameBoyEmulator::MBC3>(rom, ram, event_scheduler, GetParam());
+        mbc3->write_byte(0x0000, 0x0A);
+    }
+
+    void write_clock_register(uint8_t clock_register_select, uint8_t value)
+    {
+        mbc3->write_byte(0x4000, clock_register_select);
+        mbc3->write_byte(0xA000, value);
+    }
+
+    void write_clock_registers(const std::array<uint8_t, 5>& clock_register_values)
+    {
+        // Halting first keeps a host clock from ticking between the writes
+        write_clock_register(0x0C, clock_register_values[4] | DAY_HIGH_HALT_BIT_MASK);
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            write_clock_register(0x08 + i, clock_register_values[i]);
+        }
+        write_clock_register(0x0C, clock_register_values[4]);
+    }
+
+    std::array<uint8_t, 5> latch_clock_registers()
+    {
+        mbc3->write_byte(0x6000, 0x00);
+        mbc3->write_byte(0x6000, 0x01);
+        std::array<uint8_t, 5> clock_register_values{};
+        for (uint8_t i = 0; i < clock_register_values.size(); i++)
+        {
+            mbc3->write_byte(0x4000, 0x08 + i);
+            clock_register_values[i] = mbc3->read_byte(0xA000);
+        }
+        return clock_register_values;
+    }
+
+    // Only the emulated time source can be moved forward by the test, host time is moved by loading a trailer saved in the past
+    void advance_seconds(uint32_t seconds, std::array<uint8_t, 5> clock_register_values)
+    {
+        if (GetParam() == GameBoyEmulator::RealTimeClockTimeSource::EmulatedMachineCycles)
+        {
+            write_clock_registers(clock_register_values);
+            event_scheduler.advance_machine_cycles(seconds * MACHINE_CYCLES_PER_SECOND);
+        }
+        else
+        {
+            // Loaded again if the host clock reached the next second in between, so exactly the requested seconds are caught up on
+            int64_t unix_timestamp{};
+            do
+            {
+                unix_timestamp = get_unix_timestamp();
+                host_save_data = create_real_time_clock_save_data(clock_register_values, seconds);
+                mbc3->map_real_time_clock_save_data(host_save_data);
+            } while (get_unix_timestamp() != unix_timestamp);
+        }
+    }
+};
+
+TEST_P(RealTimeClockTest, SecondsCarryIntoMinutesHoursAndDays)
+{
+    advance_seconds(1, {59, 59, 23, 0x00, 0x00});
+    EXPECT_EQ(latch_clock_registers(), (std::array<uint8_t, 5>{0, 0, 0, 0x01, 0x00}));
+}
+
+TEST_P(RealTimeClockTest, DayCounterCarriesIntoItsNinthBit)
+{
+    advance_seconds(1, {59, 59, 23, 0xFF, 0x00});
+    EXPECT_EQ(latch_clock_registers(), (std::array<uint8_t, 5>{0, 0, 0, 0x00, 0x01}));
+}
+
+TEST_P(RealTimeClockTest, DayCounterOverflowSetsTheCarryFlag)
+{
+    advance_seconds(1, {59, 59, 23, 0xFF, 0x01});
+    const std::array<uint8_t, 5> clock_register_values = latch_clock_registers();
+    EXPECT_EQ(clock_register_values[3], 0x00);
+    EXPECT_EQ(clock_register_values[4] & ~DAY_HIGH_HALT_BIT_MASK, DAY_HIGH_CARRY_BIT_MASK);
+}
+
+TEST_P(RealTimeClockTest, CarryFlagStaysSetUntilCleared)
+{
+    advance_seconds(1, {59, 59, 23, 0xFF, 0x01});
+    advance_seconds(1, {0, 0, 0, 0x00, DAY_HIGH_CARRY_BIT_MASK});
+    EXPECT_EQ(latch_clock_registers()[4] & DAY_HIGH_CARRY_BIT_MASK, DAY_HIGH_CARRY_BIT_MASK);
+
+    write_clock_register(0x0C, DAY_HIGH_HALT_BIT_MASK);
+    EXPECT_EQ(latch_clock_registers()[4] & DAY_HIGH_CARRY_BIT_MASK, 0);
+}
+
+TEST_P(RealTimeClockTest, ManyDaysAdvanceAtOnce)
+{
+    // 3 days, 2 hours, 1 minute and 30 seconds
+    advance_seconds(3 * 86400 + 2 * 3600 + 60 + 30, {40, 10, 5, 0xFE, 0x00});
+    EXPECT_EQ(latch_clock_registers(), (std::array<uint8_t, 5>{10, 12, 7, 0x01, 0x01}));
+}
+
+TEST_P(RealTimeClockTest, OutOfRangeCountersWrapAtTheirBitLimitWithoutCarrying)
+{
+    advance_seconds(4, {62, 61, 30, 0x00, 0x00});
+    EXPECT_EQ(latch_clock_registers(), (std::array<uint8_t, 5>{2, 61, 30, 0x00, 0x00}));
+}
+
+TEST_P(RealTimeClockTest, OutOfRangeHoursWrapWithoutIncrementingTheDay)
+{
+    advance_seconds(2 * 3600, {0, 0, 31, 0x00, 0x00});
+    EXPECT_EQ(latch_clock_registers(), (std::array<uint8_t, 5>{0, 0, 1, 0x00, 0x00}));
+}
+
+TEST_P(RealTimeClockTest, WritesKeepOnlyTheBitsEachCounterHolds)
+{
+    write_clock_registers({0xFF, 0xFF, 0xFF, 0xFF, 0x00});
+    write_clock_register(0x0C, DAY_HIGH_HALT_BIT_MASK);
+    EXPECT_EQ(latch_clock_registers(), (std::array<uint8_t, 5>{0x3F, 0x3F, 0x1F, 0xFF, DAY_HIGH_HALT_BIT_MASK}));
+}
+
+TEST_P(RealTimeClockTest, HaltedClockDoesNotAdvance)
+{
+    advance_seconds(3600, {10, 20, 3, 0x04, DAY_HIGH_HALT_BIT_MASK});
+    EXPECT_EQ(latch_clock_registers(), (std::array<uint8_t, 5>{10, 20, 3, 0x04, DAY_HIGH_HALT_BIT_MASK}));
+}
+
+INSTANTIATE_TEST_SUITE_P
+(
+    RealTimeClockTests,
+    RealTimeClockTest,
+    testing::Values(GameBoyEmulator::RealTimeClockTimeSource::EmulatedMachineCycles, GameBoyEmulator::RealTimeClockTimeSource::HostSystemClock),
+    [](auto info)
+    {
+        return (info.param == GameBoyEmulator::RealTimeClockTimeSource::EmulatedMachineCycles) ? std::string("EmulatedMachineCycles") : std::string("HostSystemClock");
+    }
+);
+
+class EmulatedRealTimeClockTest : public testing::Test
+{
+protected:
+    const std::vector<uint8_t> rom = std::vector<uint8_t>(0x8000);
+    std::vector<uint8_t> ram = std::vector<uint8_t>(0x2000);
+    GameBoyEmulator::EventScheduler event_scheduler{};
+    GameBoyEmulator::MBC3 mbc3{rom, ram, event_scheduler, GameBoyEmulator::RealTimeClockTimeSource::EmulatedMachineCycles};
+
+    uint8_t latch_seconds()
+    {
+        mbc3.write_byte(0x6000, 0x00);
+        mbc3.write_byte(0x6000, 0x01);
+        mbc3.write_byte(0x4000, 0x08);
+        return mbc3.read_byte(0xA000);
+    }
+};
+
+TEST_F(EmulatedRealTimeClockTest, SecondsTickEveryMachineCycleSecond)
+{
+    event_scheduler.advance_machine_cycles(MACHINE_CYCLES_PER_SECOND - 1);
+    EXPECT_EQ(latch_seconds(), 0);
+    event_scheduler.advance_machine_cycles(1);
+    EXPECT_EQ(latch_seconds(), 1);
+}
+
+TEST_F(EmulatedRealTimeClockTest, MachineCycleCounterResetKeepsTheFractionOfASecond)
+{
+    event_scheduler.advance_machine_cycles(MACHINE_CYCLES_PER_SECOND + MACHINE_CYCLES_PER_SECOND / 2);
+    EXPECT_EQ(latch_seconds(), 1);
+
+    mbc3.prepare_for_machine_cycle_counter_reset();
+    event_scheduler.reset_state();
+    event_scheduler.advance_machine_cycles(MACHINE_CYCLES_PER_SECOND / 2 - 1);
+    EXPECT_EQ(latch_seconds(), 1);
+    event_scheduler.advance_machine_cycles(1);
+    EXPECT_EQ(latch_seconds(), 2);
+}
+
+TEST_F(EmulatedRealTimeClockTest, WritingTheSecondsRestartsTheSubSecondDivider)
+{
+    event_scheduler.advance_machine_cycles(MACHINE_CYCLES_PER_SECOND / 2);
+    mbc3.write_byte(0x0000, 0x0A);
+    mbc3.write_byte(0x4000, 0x08);
+    mbc3.write_byte(0xA000, 5);
+
+    event_scheduler.advance_machine_cycles(MACHINE_CYCLES_PER_SECOND - 1);
+    EXPECT_EQ(latch_seconds(), 5);
+    event_scheduler.advance_machine_cycles(1);
+    EXPECT_EQ(latch_seconds(), 6);
+}
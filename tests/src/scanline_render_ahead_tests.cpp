@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+#include "game_rom_image.h"
+#include "pixel_processing_unit.h"
+#include "temporary_directory_test.h"
+
+static std::vector<std::filesystem::path> get_test_rom_paths()
+{
+    const std::filesystem::path mooneye_test_suite_directory =
+        std::filesystem::path(PROJECT_ROOT) / "tests" / "data" / "mooneye-test-suite" / "mts-20240926-1737-443f6e1";
+    const std::filesystem::path gbmicrotest_directory = std::filesystem::path(PROJECT_ROOT) / "tests" / "data" / "gbmicrotest" / "bin";
+    std::vector<std::filesystem::path> test_rom_paths = {mooneye_test_suite_directory / "manual-only" / "sprite_priority.gb"};
+
+    // These change scroll, palettes, the window, LCDC, VRAM or OAM while a scanline is being drawn, or start an OAM DMA
+    for (const char* test_rom_file_name : {
+        "400-dma.gb", "800-ppu-latch-scx.gb", "801-ppu-latch-scy.gb", "802-ppu-latch-tileselect.gb", "803-ppu-latch-bgdisplay.gb",
+        "dma_basic.gb", "oam_write_l1_a.gb", "oam_write_l1_b.gb", "oam_write_l1_c.gb", "oam_write_l1_d.gb", "oam_write_l1_e.gb",
+        "oam_write_l1_f.gb", "ppu_scx_vs_bgp.gb", "ppu_sprite_testbench.gb", "ppu_spritex_vs_scx.gb", "ppu_win_vs_wx.gb",
+        "ppu_wx_early.gb", "toggle_lcdc.gb", "vram_write_l1_a.gb", "vram_write_l1_b.gb", "vram_write_l1_c.gb", "vram_write_l1_d.gb"})
+    {
+        test_rom_paths.push_back(gbmicrotest_directory / test_rom_file_name);
+    }
+
+    const std::filesystem::path ppu_test_directory = mooneye_test_suite_directory / "acceptance" / "ppu";
+    if (std::filesystem::exists(ppu_test_directory))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(ppu_test_directory))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".gb")
+                test_rom_paths.push_back(entry.path());
+        }
+    }
+    std::sort(test_rom_paths.begin(), test_rom_paths.end());
+    return test_rom_paths;
+}
+
+// Draws the background, window and objects from patterned VRAM and OAM, then loops writing SCX, SCY, BGP, OBP0, WX, LCDC,
+// tile data, the tile map and OAM. The 49 machine cycle loop shares no factor with the 114 machine cycle scanline, so the
+// writes land on every dot of the line over the course of the run.
+static std::vector<uint8_t> create_mid_scanline_write_game_rom()
+{
+    std::vector<uint8_t> rom_bytes(0x8000);
+    std::copy(std::begin(GameBoyEmulator::EXPECTED_LOGO), std::end(GameBoyEmulator::EXPECTED_LOGO), rom_bytes.begin() + GameBoyEmulator::LOGO_START_POSITION);
+
+    const uint8_t entry_point[] = {
+        0x00,              // nop
+        0xC3, 0x50, 0x01}; // jp 0x0150
+    std::copy(std::begin(entry_point), std::end(entry_point), rom_bytes.begin() + 0x100);
+
+    const uint8_t program[] = {
+        0xF3,             // 0x0150: di
+        0xF0, 0x44,       // 0x0151: ldh a, (LY)
+        0xFE, 0x90,       //         cp 144
+        0x20, 0xFA,       //         jr nz, 0x0151
+        0xAF,             //         xor a
+        0xE0, 0x40,       //         ldh (LCDC), a
+        0x21, 0x00, 0x80, //         ld hl, 0x8000
+        0x7D,             // 0x015D: ld a, l
+        0x22,             //         ld (hl+), a
+        0x7C,             //         ld a, h
+        0xFE, 0xA0,       //         cp 0xA0
+        0x20, 0xF9,       //         jr nz, 0x015D
+        0x21, 0x00, 0xFE, //         ld hl, 0xFE00
+        0x7D,             // 0x0167: ld a, l
+        0x22,             //         ld (hl+), a
+        0x7D,             //         ld a, l
+        0xFE, 0xA0,       //         cp 0xA0
+        0x20, 0xF9,       //         jr nz, 0x0167
+        0x3E, 0x20,       //         ld a, 0x20
+        0xE0, 0x4A,       //         ldh (WY), a
+        0x3E, 0x30,       //         ld a, 0x30
+        0xE0, 0x4B,       //         ldh (WX), a
+        0x3E, 0x40,       //         ld a, 0x40
+        0xE0, 0x45,       //         ldh (LYC), a
+        0x3E, 0x78,       //         ld a, 0x78
+        0xE0, 0x41,       //         ldh (STAT), a
+        0x3E, 0xE4,       //         ld a, 0xE4
+        0xE0, 0x48,       //         ldh (OBP0), a
+        0x3E, 0x1B,       //         ld a, 0x1B
+        0xE0, 0x49,       //         ldh (OBP1), a
+        0xAF,             //         xor a
+        0xE0, 0xFF,       //         ldh (IE), a
+        0x3E, 0xF3,       //         ld a, 0xF3
+        0xE0, 0x40,       //         ldh (LCDC), a
+        0x06, 0x00,       //         ld b, 0
+        0xAF,             // 0x018F: xor a
+        0xE0, 0x0F,       //         ldh (IF), a
+        0x04,             //         inc b
+        0x78,             //         ld a, b
+        0xE0, 0x43,       //         ldh (SCX), a
+        0xE0, 0x47,       //         ldh (BGP), a
+        0xEA, 0x10, 0x80, //         ld (0x8010), a
+        0xEA, 0x21, 0x98, //         ld (0x9821), a
+        0xEA, 0x15, 0xFE, //         ld (0xFE15), a
+        0xEA, 0x22, 0xFE, //         ld (0xFE22), a
+        0xE0, 0x4B,       //         ldh (WX), a
+        0x2F,             //         cpl
+        0xE0, 0x48,       //         ldh (OBP0), a
+        0xE0, 0x42,       //         ldh (SCY), a
+        0x78,             //         ld a, b
+        0xE6, 0x1E,       //         and 0x1E
+        0xF6, 0xE1,       //         or 0xE1
+        0xE0, 0x40,       //         ldh (LCDC), a
+        0x18, 0xDB};      //         jr 0x018F
+    std::copy(std::begin(program), std::end(program), rom_bytes.begin() + 0x150);
+    return rom_bytes;
+}
+
+// Rendering a scanline ahead must be indistinguishable from drawing it through the pixel FIFO, whatever changes mid-line
+class ScanlineRenderAheadTest : public TemporaryDirectoryTest
+{
+protected:
+    static constexpr uint32_t FRAME_COUNT = 60;
+    static constexpr uint64_t MACHINE_CYCLES_PER_FRAME =
+        (GameBoyEmulator::FINAL_SCANLINE_OF_FRAME + 1) * GameBoyEmulator::SCANLINE_DURATION_DOTS / GameBoyEmulator::DOTS_PER_MACHINE_CYCLE;
+    // One machine cycle short of a scanline, so successive samples walk through every dot of the line
+    static constexpr uint64_t SAMPLE_INTERVAL_MACHINE_CYCLES =
+        GameBoyEmulator::SCANLINE_DURATION_DOTS / GameBoyEmulator::DOTS_PER_MACHINE_CYCLE - 1;
+    static constexpr size_t FRAME_BUFFER_SIZE = GameBoyEmulator::DISPLAY_WIDTH_PIXELS * GameBoyEmulator::DISPLAY_HEIGHT_PIXELS;
+
+    GameBoyEmulator::Emulator render_ahead_emulator;
+    GameBoyEmulator::Emulator pixel_fifo_emulator;
+    std::string error_message{};
+
+    void expect_same_timing_and_frames(const std::filesystem::path& rom_path)
+    {
+        ASSERT_TRUE(std::filesystem::exists(rom_path)) << "ROM file not found: " << rom_path;
+        for (GameBoyEmulator::Emulator* game_boy_emulator : {&render_ahead_emulator, &pixel_fifo_emulator})
+        {
+            ASSERT_TRUE(game_boy_emulator->try_load_file_to_memory(rom_path, GameBoyEmulator::FileType::GameROM, error_message)) << error_message;
+            game_boy_emulator->reset_state();
+        }
+        pixel_fifo_emulator.set_scanline_render_ahead_enabled(false);
+        uint8_t last_published_frame_buffer_index = pixel_fifo_emulator.get_published_frame_buffer_index_thread_safe();
+
+        while (pixel_fifo_emulator.get_elapsed_machine_cycles() < FRAME_COUNT * MACHINE_CYCLES_PER_FRAME)
+        {
+            render_ahead_emulator.run_for_cycles(SAMPLE_INTERVAL_MACHINE_CYCLES);
+            pixel_fifo_emulator.run_for_cycles(SAMPLE_INTERVAL_MACHINE_CYCLES);
+            const uint64_t machine_cycle = pixel_fifo_emulator.get_elapsed_machine_cycles();
+            ASSERT_EQ(render_ahead_emulator.get_elapsed_machine_cycles(), machine_cycle);
+            ASSERT_EQ(render_ahead_emulator.get_register_file().program_counter, pixel_fifo_emulator.get_register_file().program_counter)
+                << "machine cycle " << machine_cycle;
+
+            // STAT, LY and IF
+            for (const uint16_t address : {0xFF41, 0xFF44, 0xFF0F})
+            {
+                ASSERT_EQ(render_ahead_emulator.read_byte_from_memory(address), pixel_fifo_emulator.read_byte_from_memory(address))
+                    << "address 0x" << std::hex << address << std::dec << " at machine cycle " << machine_cycle;
+            }
+
+            const uint8_t published_frame_buffer_index = pixel_fifo_emulator.get_published_frame_buffer_index_thread_safe();
+            if (published_frame_buffer_index != last_published_frame_buffer_index)
+            {
+                ASSERT_EQ(render_ahead_emulator.get_published_frame_buffer_index_thread_safe(), published_frame_buffer_index)
+                    << "machine cycle " << machine_cycle;
+                ASSERT_EQ(std::memcmp(
+                    render_ahead_emulator.get_pixel_frame_buffer(published_frame_buffer_index).get(),
+                    pixel_fifo_emulator.get_pixel_frame_buffer(published_frame_buffer_index).get(),
+                    FRAME_BUFFER_SIZE), 0) << "frame published at machine cycle " << machine_cycle;
+                last_published_frame_buffer_index = published_frame_buffer_index;
+            }
+        }
+    }
+};
+
+TEST_F(ScanlineRenderAheadTest, MidScanlineRegisterVideoRamAndObjectAttributeMemoryWritesMatchThePixelFifo)
+{
+    const std::filesystem::path rom_path = test_directory_path / "mid_scanline_writes.gb";
+    write_file(rom_path, create_mid_scanline_write_game_rom());
+    expect_same_timing_and_frames(rom_path);
+}
+
+class ScanlineRenderAheadRomTest : public ScanlineRenderAheadTest, public testing::WithParamInterface<std::filesystem::path>
+{
+};
+
+TEST_P(ScanlineRenderAheadRomTest, MatchesThePixelFifo)
+{
+    expect_same_timing_and_frames(GetParam());
+}
+
+INSTANTIATE_TEST_SUITE_P
+(
+    ScanlineRenderAheadTests,
+    ScanlineRenderAheadRomTest,
+    testing::ValuesIn(get_test_rom_paths()),
+    [](auto info)
+    {
+        std::string test_rom_file_name = info.param.stem().string();
+        std::replace(test_rom_file_name.begin(), test_rom_file_name.end(), '-', '_');
+        return test_rom_file_name;
+    }
+);
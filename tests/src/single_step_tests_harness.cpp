@@ -9,9 +9,10 @@
 #include <vector>
 
 #include "central_processing_unit.h"
+#include "interrupt_registers.h"
 #include "memory_management_unit.h"
-#include "pixel_processing_unit.h"
 #include "register_file.h"
+#include "system_bus.h"
 
 enum class MemoryInteraction
 {
@@ -213,107 +214,78 @@ static std::vector<SingleStepTestCase> load_test_cases_from_json_file(const std:
 }
 
 // The single step tests expect the memory to be a 64KB flat array with no internal read/write restrictions
-class SingleStepTestMemory : public GameBoyEmulator::MemoryManagementUnit
+class SingleStepTestMemory
 {
 public:
     SingleStepTestMemory()
-        : MemoryManagementUnit{get_game_cartridge_slot(), get_timer(), get_pixel_processing_unit()}
     {
         flat_memory = std::make_unique<uint8_t[]>(GameBoyEmulator::MEMORY_SIZE);
         std::fill_n(flat_memory.get(), GameBoyEmulator::MEMORY_SIZE, 0);
     }
 
-    void reset_state() override
+    void reset_state()
     {
         std::fill_n(flat_memory.get(), GameBoyEmulator::MEMORY_SIZE, 0);
     }
 
-    uint8_t read_byte(uint16_t address, bool _ = false) const override
+    uint8_t read_byte(uint16_t address) const
     {
         return flat_memory[address];
     }
 
-    void write_byte(uint16_t address, uint8_t value, bool _ = false) override
+    void write_byte(uint16_t address, uint8_t value)
     {
         flat_memory[address] = value;
     }
 
 private:
     std::unique_ptr<uint8_t[]> flat_memory;
-
-    static GameBoyEmulator::GameCartridgeSlot& get_game_cartridge_slot()
-    {
-        static GameBoyEmulator::GameCartridgeSlot game_cartridge_slot{};
-        return game_cartridge_slot;
-    }
-
-    static GameBoyEmulator::InternalTimer& get_timer()
-    {
-        static GameBoyEmulator::InternalTimer test_internal_timer{[](uint8_t) {}};
-        return test_internal_timer;
-    }
-
-    static GameBoyEmulator::PixelProcessingUnit& get_pixel_processing_unit()
-    {
-        static GameBoyEmulator::PixelProcessingUnit test_pixel_processing_unit{[](uint8_t) {}};
-        return test_pixel_processing_unit;
-    }
-};
-
-class SingleStepTestCentralProcessingUnit : public GameBoyEmulator::CentralProcessingUnit
-{
-public:
-    std::unique_ptr<SingleStepTestMemory> memory_management_unit;
-    std::function<void(MachineCycleOperation)> machine_cycle_memory_operation_callback;
-
-    SingleStepTestCentralProcessingUnit(
-        std::unique_ptr<SingleStepTestMemory> memory,
-        std::function<void()> no_memory_operation_callback,
-        std::function<void(MachineCycleOperation)> memory_operation_callback)
-        : CentralProcessingUnit{no_memory_operation_callback, *memory},
-          memory_management_unit{std::move(memory)},
-          machine_cycle_memory_operation_callback{memory_operation_callback}
-    {
-    }
-
-    uint8_t read_byte_and_step_emulator_components(uint16_t address) override
-    {
-        machine_cycle_memory_operation_callback(MachineCycleOperation{MemoryInteraction::Read, address});
-        return memory_management_unit->read_byte(address);
-    }
-
-    void write_byte_and_step_emulator_components(uint16_t address, uint8_t value) override
-    {
-        machine_cycle_memory_operation_callback(MachineCycleOperation{MemoryInteraction::Write, address, value});
-        memory_management_unit->write_byte(address, value);
-    }
 };
 
 class SingleStepTest : public testing::TestWithParam<std::filesystem::path>
 {
 protected:
     std::vector<MachineCycleOperation> machine_cycle_operations;
-    std::unique_ptr<SingleStepTestCentralProcessingUnit> game_boy_central_processing_unit;
+    SingleStepTestMemory memory{};
+    GameBoyEmulator::InterruptRegisters interrupt_registers{};
+    std::unique_ptr<GameBoyEmulator::CentralProcessingUnit<GameBoyEmulator::CallbackSystemBus>> game_boy_central_processing_unit;
 
     SingleStepTest()
     {
-        std::unique_ptr<SingleStepTestMemory> memory_management_unit = std::make_unique<SingleStepTestMemory>();
-
-        game_boy_central_processing_unit = std::make_unique<SingleStepTestCentralProcessingUnit>(
-            std::move(memory_management_unit),
-            [this]() { this->machine_cycle_operations.emplace_back(MemoryInteraction::None); },
-            [this](MachineCycleOperation memory_operation) { this->machine_cycle_operations.push_back(memory_operation); });
+        game_boy_central_processing_unit = std::make_unique<GameBoyEmulator::CentralProcessingUnit<GameBoyEmulator::CallbackSystemBus>>(
+            GameBoyEmulator::CallbackSystemBus
+            {
+                [this]()
+                {
+                    this->machine_cycle_operations.emplace_back(MemoryInteraction::None);
+                },
+                [this](uint16_t address)
+                {
+                    this->machine_cycle_operations.emplace_back(MemoryInteraction::Read, address);
+                    return this->memory.read_byte(address);
+                },
+                [this](uint16_t address, uint8_t value)
+                {
+                    this->machine_cycle_operations.emplace_back(MemoryInteraction::Write, address, value);
+                    this->memory.write_byte(address, value);
+                },
+                [this](uint16_t address)
+                {
+                    return this->memory.read_byte(address);
+                },
+                interrupt_registers
+            });
     }
 
     void set_initial_values(const SingleStepTestCase& test_case)
     {
         machine_cycle_operations.clear();
-        game_boy_central_processing_unit->memory_management_unit->reset_state();
+        memory.reset_state();
         game_boy_central_processing_unit->reset_state(false);
 
         for (const std::pair<uint16_t, uint8_t>& pair : test_case.initial_ram_address_value_pairs)
         {
-            game_boy_central_processing_unit->memory_management_unit->write_byte(pair.first, pair.second);
+            memory.write_byte(pair.first, pair.second);
         }
         game_boy_central_processing_unit->set_register_file_state(test_case.initial_register_values);
     }
@@ -350,7 +322,7 @@ TEST_P(SingleStepTest, JsonTestCasesFile)
 
         for (const std::pair<uint16_t, uint8_t>& expected_pair : test_case.expected_ram_address_value_pairs)
         {
-            EXPECT_EQ(game_boy_central_processing_unit->memory_management_unit->read_byte(expected_pair.first), expected_pair.second);
+            EXPECT_EQ(memory.read_byte(expected_pair.first), expected_pair.second);
         }
 
         // Compare expected_memory_interactions size against machine_cycle_operations.size()-1 since 
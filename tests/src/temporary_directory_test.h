@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Gives each test an empty directory under the system temporary directory, named after its suite and test so that
+// suites with matching test names never share one, and removes it once the test finishes.
+class TemporaryDirectoryTest : public testing::Test
+{
+protected:
+    std::filesystem::path test_directory_path{};
+
+    void SetUp() override
+    {
+        const testing::TestInfo* test_info = testing::UnitTest::GetInstance()->current_test_info();
+        test_directory_path = std::filesystem::temp_directory_path() /
+            ("game-boy-tests-" + std::string(test_info->test_suite_name()) + "-" + std::string(test_info->name()));
+        std::filesystem::remove_all(test_directory_path);
+        std::filesystem::create_directories(test_directory_path);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(test_directory_path);
+    }
+
+    static void write_file(const std::filesystem::path& file_path, const std::vector<uint8_t>& file_bytes)
+    {
+        std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(file_bytes.data()), static_cast<std::streamsize>(file_bytes.size()));
+    }
+
+    static std::vector<uint8_t> read_file(const std::filesystem::path& file_path)
+    {
+        std::ifstream file(file_path, std::ios::binary);
+        return std::vector<uint8_t>{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+};